@@ -8,31 +8,43 @@
 
 #include <algorithm>
 #include <array>
-#include <asio.hpp>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
-#include <d3d12.h>
-#include <dxgi1_4.h>
-#include <DirectXMath.h>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <future>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <random>
-#include "shader.fxh"
+#include <sstream>
 #include <string>
 #include <thread>
 #include <utility>
 #include <vector>
+
+// Window, GPU and networking headers. Headless builds (ENGINE_HEADLESS, set by
+// the CMake build of the CPU renderer and CLI) compile without them.
+#if !defined(ENGINE_HEADLESS)
+#include <asio.hpp>
+#include <d3d12.h>
+#include <dxgi1_4.h>
+#include <DirectXMath.h>
+#include "shader.fxh"
 #include <Windows.h>
 
 #pragma comment(lib, "d3d12")
 #pragma comment(lib, "dxgi")
+#endif
 
 const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 533;
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Vector3.h"
+#include "Ray.h"
+#include "Interval.h"
+
+namespace Engine
+{
+	/**
+	 * @class AABB
+	 * @brief Axis-aligned bounding box stored as one interval per axis.
+	 *
+	 * Used by every Hittable to report its extent so it can be inserted into
+	 * an acceleration structure such as the BVH.
+	 */
+	class AABB
+	{
+	public:
+
+		Interval x, y, z;
+
+		/** @brief Default constructor. Creates an empty box. */
+		AABB() {}
+
+		AABB(const Interval& x, const Interval& y, const Interval& z) : x(x), y(y), z(z) {}
+
+		/**
+		 * @brief Creates the box spanned by two corner points (in any order).
+		 * @param a First corner.
+		 * @param b Opposite corner.
+		 */
+		AABB(const Vector3& a, const Vector3& b)
+		{
+			x = (a.x <= b.x) ? Interval(a.x, b.x) : Interval(b.x, a.x);
+			y = (a.y <= b.y) ? Interval(a.y, b.y) : Interval(b.y, a.y);
+			z = (a.z <= b.z) ? Interval(a.z, b.z) : Interval(b.z, a.z);
+		}
+
+		/** @brief Creates the tightest box enclosing both input boxes. */
+		AABB(const AABB& a, const AABB& b) : x(a.x, b.x), y(a.y, b.y), z(a.z, b.z) {}
+
+		static AABB Empty() { return AABB(); }
+
+		const Interval& Axis(int n) const
+		{
+			if (n == 1) return y;
+			if (n == 2) return z;
+			return x;
+		}
+
+		bool IsEmpty() const
+		{
+			return x.min > x.max || y.min > y.max || z.min > z.max;
+		}
+
+		Vector3 Min() const { return Vector3(x.min, y.min, z.min); }
+		Vector3 Max() const { return Vector3(x.max, y.max, z.max); }
+
+		Vector3 Centroid() const
+		{
+			return Vector3(Real(0.5) * (x.min + x.max), Real(0.5) * (y.min + y.max), Real(0.5) * (z.min + z.max));
+		}
+
+		/** @brief Grows the box so that it also encloses point 'p'. */
+		void Grow(const Vector3& p)
+		{
+			x = Interval(std::fmin(x.min, p.x), std::fmax(x.max, p.x));
+			y = Interval(std::fmin(y.min, p.y), std::fmax(y.max, p.y));
+			z = Interval(std::fmin(z.min, p.z), std::fmax(z.max, p.z));
+		}
+
+		/** @brief Grows the box so that it also encloses 'box'. */
+		void Grow(const AABB& box)
+		{
+			x = Interval(x, box.x);
+			y = Interval(y, box.y);
+			z = Interval(z, box.z);
+		}
+
+		/** @brief Returns the index of the longest axis (0 = x, 1 = y, 2 = z). */
+		int LongestAxis() const
+		{
+			if (x.Size() > y.Size())
+			{
+				return x.Size() > z.Size() ? 0 : 2;
+			}
+
+			return y.Size() > z.Size() ? 1 : 2;
+		}
+
+		/** @brief Returns the surface area of the box, or zero for an empty box. */
+		Real SurfaceArea() const
+		{
+			if (IsEmpty())
+			{
+				return 0.0;
+			}
+
+			const Real dx = x.Size();
+			const Real dy = y.Size();
+			const Real dz = z.Size();
+
+			return 2 * (dx * dy + dy * dz + dz * dx);
+		}
+
+		/**
+		 * @brief Slab test of a ray against the box.
+		 * @param ray The ray to test.
+		 * @param ray_t The parametric range of the ray; narrowed to the overlap on success.
+		 * @return True if the ray overlaps the box within 'ray_t'.
+		 */
+		bool Hit(const Ray& ray, Interval ray_t) const
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const Interval& ax = Axis(axis);
+				const Real adinv = 1 / ray.direction[axis];
+
+				Real t0 = (ax.min - ray.origin[axis]) * adinv;
+				Real t1 = (ax.max - ray.origin[axis]) * adinv;
+
+				if (t0 > t1)
+				{
+					std::swap(t0, t1);
+				}
+
+				if (t0 > ray_t.min) ray_t.min = t0;
+				if (t1 < ray_t.max) ray_t.max = t1;
+
+				if (ray_t.max <= ray_t.min)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * @brief Slab test using a precomputed reciprocal direction.
+		 *
+		 * This is the form used in the inner loop of BVH traversal, where the
+		 * reciprocal is computed once per ray rather than once per box.
+		 *
+		 * @param origin Ray origin.
+		 * @param invDirection Component-wise reciprocal of the ray direction.
+		 * @param tMin Start of the parametric range.
+		 * @param tMax End of the parametric range.
+		 * @param tEntry Receives the entry distance on success.
+		 * @return True if the ray overlaps the box within [tMin, tMax].
+		 */
+		bool Hit(const Vector3& origin, const Vector3& invDirection, Real tMin, Real tMax, Real& tEntry) const
+		{
+			const Real tx0 = (x.min - origin.x) * invDirection.x;
+			const Real tx1 = (x.max - origin.x) * invDirection.x;
+			const Real ty0 = (y.min - origin.y) * invDirection.y;
+			const Real ty1 = (y.max - origin.y) * invDirection.y;
+			const Real tz0 = (z.min - origin.z) * invDirection.z;
+			const Real tz1 = (z.max - origin.z) * invDirection.z;
+
+			const Real tNear = std::max({ std::min(tx0, tx1), std::min(ty0, ty1), std::min(tz0, tz1), tMin });
+			// Widen the exit distance by the rounding error of the slab products so
+			// rays through the boundary of a flat box (e.g. one around an
+			// axis-aligned triangle) are never rejected; see Pharr et al., PBRT 6.8.
+			constexpr Real gamma3 = 3 * (std::numeric_limits<Real>::epsilon() / 2) / (1 - 3 * (std::numeric_limits<Real>::epsilon() / 2));
+			const Real slabFar = std::min({ std::max(tx0, tx1), std::max(ty0, ty1), std::max(tz0, tz1) }) * (1 + 2 * gamma3);
+			const Real tFar = std::min(slabFar, tMax);
+
+			tEntry = tNear;
+
+			return tNear <= tFar;
+		}
+	};
+}
\ No newline at end of file
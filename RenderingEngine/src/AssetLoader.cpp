@@ -9,9 +9,126 @@ std::unique_ptr<Engine::Scene> Engine::AssetLoader::LoadGLTF(const std::string&
 
 	std::unique_ptr<Engine::Scene> scene = std::make_unique<Engine::Scene>("Root");
 
-	// Save the system file path.
-	std::filesystem::path path = filePath;
+	fastgltf::Asset gltf;
+	ParseGLTF(filePath, gltf);
+
+	LoadExtensions(gltf);
+	LoadScenes(gltf, scene);
+	LoadNodes(gltf);
+
+	return scene;
+}
+
+Engine::HittableList Engine::AssetLoader::LoadTriangleMeshes(const std::string& filePath)
+{
+	fastgltf::Asset gltf;
+	if (!ParseGLTF(filePath, gltf) || gltf.scenes.empty())
+	{
+		throw std::runtime_error("Failed to parse glTF file!");
+	}
+
+	HittableList meshes;
+
+	const size_t sceneIndex = gltf.defaultScene.has_value() ? gltf.defaultScene.value() : 0;
+
+	fastgltf::iterateSceneNodes(gltf, sceneIndex, fastgltf::math::fmat4x4(),
+		[&](fastgltf::Node& node, fastgltf::math::fmat4x4 matrix)
+		{
+			if (!node.meshIndex.has_value())
+			{
+				return;
+			}
+
+			for (const fastgltf::Primitive& primitive : gltf.meshes[node.meshIndex.value()].primitives)
+			{
+				if (std::shared_ptr<TriangleMesh> mesh = LoadTriangleMesh(gltf, primitive, matrix))
+				{
+					meshes.Add(mesh);
+				}
+			}
+		});
+
+	return meshes;
+}
+
+Engine::HittableList Engine::AssetLoader::LoadInstances(const std::string& filePath)
+{
+	fastgltf::Asset gltf;
+	if (!ParseGLTF(filePath, gltf) || gltf.scenes.empty())
+	{
+		throw std::runtime_error("Failed to parse glTF file!");
+	}
+
+	// Bottom-level geometry per glTF mesh, built on first use.
+	std::vector<std::shared_ptr<const Hittable>> blases(gltf.meshes.size());
 
+	HittableList instances;
+
+	const size_t sceneIndex = gltf.defaultScene.has_value() ? gltf.defaultScene.value() : 0;
+
+	fastgltf::iterateSceneNodes(gltf, sceneIndex, fastgltf::math::fmat4x4(),
+		[&](fastgltf::Node& node, fastgltf::math::fmat4x4 matrix)
+		{
+			if (!node.meshIndex.has_value())
+			{
+				return;
+			}
+
+			std::shared_ptr<const Hittable>& blas = blases[node.meshIndex.value()];
+			if (!blas)
+			{
+				HittableList primitives;
+				for (const fastgltf::Primitive& primitive : gltf.meshes[node.meshIndex.value()].primitives)
+				{
+					if (std::shared_ptr<TriangleMesh> mesh = LoadTriangleMesh(gltf, primitive, fastgltf::math::fmat4x4()))
+					{
+						primitives.Add(mesh);
+					}
+				}
+
+				if (primitives.objects.empty())
+				{
+					return;
+				}
+
+				blas = (primitives.objects.size() == 1) ? primitives.objects[0] : std::make_shared<BVH>(primitives);
+			}
+
+			glm::dmat4 objectToWorld;
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					objectToWorld[column][row] = matrix[column][row];
+				}
+			}
+
+			instances.Add(std::make_shared<Instance>(blas, objectToWorld));
+		});
+
+	return instances;
+}
+
+Engine::MaterialTable Engine::AssetLoader::LoadMaterials(const std::string& filePath)
+{
+	fastgltf::Asset gltf;
+	if (!ParseGLTF(filePath, gltf))
+	{
+		throw std::runtime_error("Failed to parse glTF file!");
+	}
+
+	MaterialTable materials;
+	for (const fastgltf::Material& material : gltf.materials)
+	{
+		const fastgltf::math::nvec4& color = material.pbrData.baseColorFactor;
+		materials.Add(std::make_shared<Lambertian>(Vector3(Real(color.x()), Real(color.y()), Real(color.z()))));
+	}
+
+	return materials;
+}
+
+bool Engine::AssetLoader::ParseGLTF(const std::filesystem::path& path, fastgltf::Asset& gltf)
+{
 	// Read file from disk.
 	auto gltfFile = fastgltf::GltfDataBuffer::FromPath(path);
 	if (!gltfFile)
@@ -19,8 +136,6 @@ std::unique_ptr<Engine::Scene> Engine::AssetLoader::LoadGLTF(const std::string&
 		throw std::runtime_error("Failed to load glTF file!");
 	}
 
-	fastgltf::Asset gltf;
-
 	constexpr auto gltfOptions = fastgltf::Options::DontRequireValidAssetMember |
 		fastgltf::Options::AllowDouble |
 		fastgltf::Options::LoadExternalBuffers;
@@ -36,19 +151,65 @@ std::unique_ptr<Engine::Scene> Engine::AssetLoader::LoadGLTF(const std::string&
 		if (load)
 		{
 			gltf = std::move(load.get());
+			return true;
 		}
 	}
 
-	LoadExtensions(gltf);
-	LoadScenes(gltf, scene);
-	LoadNodes(gltf);
-
-	return scene;
+	return false;
 }
 
-bool Engine::AssetLoader::ParseGLTF()
+std::shared_ptr<Engine::TriangleMesh> Engine::AssetLoader::LoadTriangleMesh(const fastgltf::Asset& gltf, const fastgltf::Primitive& primitive, const fastgltf::math::fmat4x4& matrix)
 {
-	return true;
+	if (primitive.type != fastgltf::PrimitiveType::Triangles)
+	{
+		return nullptr;
+	}
+
+	auto positionAttribute = primitive.findAttribute("POSITION");
+	if (positionAttribute == primitive.attributes.cend())
+	{
+		return nullptr;
+	}
+
+	// Read positions straight from the accessor, transformed to world space.
+	const fastgltf::Accessor& positionAccessor = gltf.accessors[positionAttribute->accessorIndex];
+
+	std::vector<Vector3> positions;
+	positions.reserve(positionAccessor.count);
+
+	fastgltf::iterateAccessor<fastgltf::math::fvec3>(gltf, positionAccessor,
+		[&](fastgltf::math::fvec3 position)
+		{
+			const fastgltf::math::fvec4 world = matrix * fastgltf::math::fvec4(position.x(), position.y(), position.z(), 1.0f);
+			positions.emplace_back(world.x(), world.y(), world.z());
+		});
+
+	// Non-indexed primitives list their vertices in triangle order.
+	std::vector<uint32_t> indices;
+	if (primitive.indicesAccessor.has_value())
+	{
+		const fastgltf::Accessor& indexAccessor = gltf.accessors[primitive.indicesAccessor.value()];
+
+		indices.resize(indexAccessor.count);
+		fastgltf::copyFromAccessor<uint32_t>(gltf, indexAccessor, indices.data());
+	}
+	else
+	{
+		indices.resize(positions.size());
+		for (uint32_t i = 0; i < indices.size(); i++)
+		{
+			indices[i] = i;
+		}
+	}
+
+	if (indices.size() < 3)
+	{
+		return nullptr;
+	}
+
+	const uint32_t materialId = primitive.materialIndex.has_value() ? uint32_t(primitive.materialIndex.value()) : 0;
+
+	return std::make_shared<TriangleMesh>(positions, indices, materialId);
 }
 
 bool Engine::AssetLoader::LoadExtensions(fastgltf::Asset& gltf)
@@ -4,6 +4,12 @@
 #include <fastgltf/tools.hpp>
 
 #include "Scene.h"
+#include "HittableList.h"
+#include "TriangleMesh.h"
+#include "Instance.h"
+#include "BVH.h"
+#include "Lambertian.h"
+#include "MaterialTable.h"
 
 namespace Engine
 {
@@ -13,9 +19,46 @@ namespace Engine
 
 		static std::unique_ptr<Engine::Scene> LoadGLTF(const std::string& filePath);
 
+		/**
+		 * @brief Loads every triangle primitive of a glTF file's default scene for the CPU tracer.
+		 *
+		 * Each mesh primitive becomes one TriangleMesh with its positions
+		 * transformed to world space by the node hierarchy; the glTF material
+		 * index is used as the material ID.
+		 *
+		 * @param filePath Path to a .glb file.
+		 * @return One TriangleMesh per triangle primitive.
+		 */
+		static HittableList LoadTriangleMeshes(const std::string& filePath);
+
+		/**
+		 * @brief Loads a glTF file's default scene as instances of shared meshes.
+		 *
+		 * Every glTF mesh is built once in object space (a TriangleMesh, or a
+		 * BVH over its primitives when it has several) and each node that
+		 * references it becomes an Instance carrying the node's world matrix,
+		 * so repeated assets share their geometry.
+		 *
+		 * @param filePath Path to a .glb file.
+		 * @return One Instance per mesh node; a BVH over the list is the top-level structure.
+		 */
+		static HittableList LoadInstances(const std::string& filePath);
+
+		/**
+		 * @brief Loads a glTF file's materials for the CPU tracer.
+		 *
+		 * Each glTF material becomes a Lambertian with its base colour factor,
+		 * at the same index the loaded meshes use as material ID. Textures are
+		 * not sampled.
+		 *
+		 * @param filePath Path to a .glb file.
+		 */
+		static MaterialTable LoadMaterials(const std::string& filePath);
+
 	private:
 
-		static bool ParseGLTF();
+		static bool ParseGLTF(const std::filesystem::path& path, fastgltf::Asset& gltf);
+		static std::shared_ptr<TriangleMesh> LoadTriangleMesh(const fastgltf::Asset& gltf, const fastgltf::Primitive& primitive, const fastgltf::math::fmat4x4& matrix);
 		static bool LoadExtensions(fastgltf::Asset& gltf);
 		static bool LoadScenes(fastgltf::Asset& gltf, std::unique_ptr<Engine::Scene>& scene);
 		static bool LoadNodes(fastgltf::Asset& gltf);
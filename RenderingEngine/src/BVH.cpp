@@ -0,0 +1,382 @@
+#include "pch.h"
+
+#include "BVH.h"
+
+namespace Engine
+{
+	BVH::BVH(const HittableList& list, const BVHBuildOptions& options)
+	{
+		Build(list.objects, options);
+	}
+
+	BVH::BVH(const std::vector<std::shared_ptr<Hittable>>& objects, const BVHBuildOptions& options)
+	{
+		Build(objects, options);
+	}
+
+	void BVH::Build(const std::vector<std::shared_ptr<Hittable>>& objects, const BVHBuildOptions& options)
+	{
+		std::vector<AABB> bounds;
+		bounds.reserve(objects.size());
+
+		for (const auto& object : objects)
+		{
+			bounds.push_back(object->BoundingBox());
+		}
+
+		// Leaves of the wide layout must fit its node format.
+		BVHBuildOptions treeOptions = options;
+		if (options.layout == BVHLayout::Wide8)
+		{
+			treeOptions.maxLeafSize = std::min(options.maxLeafSize, int(WideBVHTree::MaxLeafSize));
+		}
+
+		tree.Build(bounds, treeOptions);
+
+		// Copy the objects in leaf order, so each leaf is a contiguous range of
+		// handles and each per-type array is laid out in traversal order.
+		primitives.Clear();
+		handles.resize(objects.size());
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			handles[i] = primitives.Add(objects[tree.primitiveIndices[i]]);
+		}
+
+		BuildWide();
+	}
+
+	void BVH::BuildWide()
+	{
+		if (tree.BuildOptions().layout != BVHLayout::Wide8)
+		{
+			wideTree = WideBVHTree();
+			wideHandles.clear();
+			return;
+		}
+
+		wideTree.Build(tree);
+
+		// Map each primitive through its position in the binary leaf order to its handle.
+		std::vector<uint32_t> position(handles.size());
+		for (size_t i = 0; i < handles.size(); i++)
+		{
+			position[tree.primitiveIndices[i]] = uint32_t(i);
+		}
+
+		wideHandles.resize(handles.size());
+		for (size_t i = 0; i < handles.size(); i++)
+		{
+			wideHandles[i] = handles[position[wideTree.primitiveIndices[i]]];
+		}
+	}
+
+	bool BVH::Update(const HittableList& list)
+	{
+		return Update(list.objects);
+	}
+
+	bool BVH::Update(const std::vector<std::shared_ptr<Hittable>>& objects)
+	{
+		if (objects.size() != handles.size())
+		{
+			throw std::invalid_argument("BVH::Update requires the objects the BVH was built from!");
+		}
+
+		std::vector<AABB> bounds;
+		bounds.reserve(objects.size());
+
+		for (const auto& object : objects)
+		{
+			bounds.push_back(object->BoundingBox());
+		}
+
+		if (tree.Empty())
+		{
+			return false;
+		}
+
+		if (tree.Refit(bounds) > tree.BuildOptions().maxRefitCostGrowth)
+		{
+			Build(objects, tree.BuildOptions());
+			return true;
+		}
+
+		// Same objects in the same leaf order, so every handle stays valid.
+		primitives.Clear();
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			handles[i] = primitives.Add(objects[tree.primitiveIndices[i]]);
+		}
+
+		BuildWide();
+
+		return false;
+	}
+
+	bool BVH::Hit(const Ray& ray, Interval ray_t, HitRecord& record) const
+	{
+		if (tree.Empty())
+		{
+			return false;
+		}
+
+		TraversalCounters counters;
+		Real closestSoFar = ray_t.max;
+
+		const bool hitAnything = wideTree.Empty() ?
+			Traverse(0, ray, ray_t.min, closestSoFar, record, counters) : TraverseWide(ray, ray_t.min, closestSoFar, record, counters);
+		RecordStats(1, counters);
+
+		return hitAnything;
+	}
+
+	bool BVH::Occluded(const Ray& ray, Interval ray_t) const
+	{
+		if (tree.Empty())
+		{
+			return false;
+		}
+
+		TraversalCounters counters;
+
+		const auto intersectLeaf = [&](const std::vector<uint32_t>& leafHandles, uint32_t first, uint32_t count)
+			{
+				for (uint32_t i = first; i < first + count; i++)
+				{
+					counters.primitiveTests++;
+
+					if (primitives.Occluded(leafHandles[i], ray, ray_t))
+					{
+						return true;
+					}
+				}
+
+				return false;
+			};
+
+		const bool occluded = wideTree.Empty() ?
+			tree.TraverseAny(0, ray, ray_t.min, ray_t.max, counters.nodesVisited, [&](uint32_t first, uint32_t count) { return intersectLeaf(handles, first, count); }) :
+			wideTree.TraverseAny(ray, ray_t.min, ray_t.max, counters.nodesVisited, [&](uint32_t first, uint32_t count) { return intersectLeaf(wideHandles, first, count); });
+
+		RecordStats(1, counters);
+
+		return occluded;
+	}
+
+	void BVH::HitPacket(const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const
+	{
+		if (tree.Empty() || count == 0)
+		{
+			return;
+		}
+
+		TraversalCounters counters;
+
+		// Rays heading into different octants diverge immediately; trace them one by one.
+		if (count == 1 || !packet.SharesOctant())
+		{
+			TraverseSingle(0, packet, tMin, indices, count, result, counters);
+			RecordStats(count, counters);
+			return;
+		}
+
+		struct PacketStackEntry
+		{
+			uint32_t node;
+			int count;
+			uint8_t indices[RayPacket::MaxSize];
+		};
+
+		alignas(32) Real invX[RayPacket::MaxSize];
+		alignas(32) Real invY[RayPacket::MaxSize];
+		alignas(32) Real invZ[RayPacket::MaxSize];
+
+		for (int k = 0; k < count; k++)
+		{
+			const int i = indices[k];
+			invX[i] = 1 / packet.directionX[i];
+			invY[i] = 1 / packet.directionY[i];
+			invZ[i] = 1 / packet.directionZ[i];
+		}
+
+		const int fallbackCount = std::max(1, int(packetFallbackRatio * count));
+		const BVHNode* nodes = tree.nodes.data();
+
+		PacketStackEntry stack[BVHTree::MaxDepth];
+		int stackSize = 0;
+
+		stack[stackSize].node = 0;
+		stack[stackSize].count = count;
+		std::copy_n(indices, count, stack[stackSize].indices);
+		stackSize++;
+
+		uint8_t active[RayPacket::MaxSize];
+
+		while (stackSize > 0)
+		{
+			const PacketStackEntry& entry = stack[--stackSize];
+			const uint32_t nodeIndex = entry.node;
+			const BVHNode& node = nodes[nodeIndex];
+			counters.nodesVisited++;
+
+			// Keep only the rays that overlap this node within their current closest hit.
+			int activeCount = 0;
+			for (int k = 0; k < entry.count; k++)
+			{
+				const int i = entry.indices[k];
+
+				const Real tx0 = (node.bounds.x.min - packet.originX[i]) * invX[i];
+				const Real tx1 = (node.bounds.x.max - packet.originX[i]) * invX[i];
+				const Real ty0 = (node.bounds.y.min - packet.originY[i]) * invY[i];
+				const Real ty1 = (node.bounds.y.max - packet.originY[i]) * invY[i];
+				const Real tz0 = (node.bounds.z.min - packet.originZ[i]) * invZ[i];
+				const Real tz1 = (node.bounds.z.max - packet.originZ[i]) * invZ[i];
+
+				const Real tNear = std::max({ std::min(tx0, tx1), std::min(ty0, ty1), std::min(tz0, tz1), tMin });
+				const Real tFar = std::min({ std::max(tx0, tx1), std::max(ty0, ty1), std::max(tz0, tz1), result.tMax[i] });
+
+				active[activeCount] = uint8_t(i);
+				activeCount += (tNear <= tFar);
+			}
+
+			if (activeCount == 0)
+			{
+				continue;
+			}
+
+			// The packet has lost coherence; finish this subtree with single rays.
+			if (activeCount < fallbackCount)
+			{
+				TraverseSingle(nodeIndex, packet, tMin, active, activeCount, result, counters);
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				for (uint32_t p = node.leftFirst; p < node.leftFirst + node.count; p++)
+				{
+					counters.primitiveTests += activeCount;
+					primitives.HitPacket(handles[p], packet, tMin, active, activeCount, result);
+				}
+
+				continue;
+			}
+
+			// Order the children front to back along the first active ray.
+			const int first = active[0];
+			const Vector3 origin(packet.originX[first], packet.originY[first], packet.originZ[first]);
+			const Vector3 direction(packet.directionX[first], packet.directionY[first], packet.directionZ[first]);
+
+			const Real leftDistance = Vector3::Dot(nodes[node.leftFirst].bounds.Centroid() - origin, direction);
+			const Real rightDistance = Vector3::Dot(nodes[node.leftFirst + 1].bounds.Centroid() - origin, direction);
+
+			const uint32_t nearChild = (leftDistance <= rightDistance) ? node.leftFirst : node.leftFirst + 1;
+			const uint32_t farChild = (leftDistance <= rightDistance) ? node.leftFirst + 1 : node.leftFirst;
+
+			for (uint32_t child : { farChild, nearChild })
+			{
+				PacketStackEntry& push = stack[stackSize++];
+				push.node = child;
+				push.count = activeCount;
+				std::copy_n(active, activeCount, push.indices);
+			}
+		}
+
+		RecordStats(count, counters);
+	}
+
+	bool BVH::Traverse(uint32_t root, const Ray& ray, Real tMin, Real& closestSoFar, HitRecord& record, TraversalCounters& counters) const
+	{
+		HitRecord tempRecord;
+
+		return tree.Traverse(root, ray, tMin, closestSoFar, counters.nodesVisited, [&](uint32_t first, uint32_t count)
+			{
+				bool hitAnything = false;
+
+				for (uint32_t i = first; i < first + count; i++)
+				{
+					counters.primitiveTests++;
+
+					if (primitives.Hit(handles[i], ray, Interval(tMin, closestSoFar), tempRecord))
+					{
+						hitAnything = true;
+						closestSoFar = tempRecord.t;
+						record = tempRecord;
+					}
+				}
+
+				return hitAnything;
+			});
+	}
+
+	bool BVH::TraverseWide(const Ray& ray, Real tMin, Real& closestSoFar, HitRecord& record, TraversalCounters& counters) const
+	{
+		HitRecord tempRecord;
+
+		return wideTree.Traverse(ray, tMin, closestSoFar, counters.nodesVisited, [&](uint32_t first, uint32_t count)
+			{
+				bool hitAnything = false;
+
+				for (uint32_t i = first; i < first + count; i++)
+				{
+					counters.primitiveTests++;
+
+					if (primitives.Hit(wideHandles[i], ray, Interval(tMin, closestSoFar), tempRecord))
+					{
+						hitAnything = true;
+						closestSoFar = tempRecord.t;
+						record = tempRecord;
+					}
+				}
+
+				return hitAnything;
+			});
+	}
+
+	void BVH::TraverseSingle(uint32_t root, const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result, TraversalCounters& counters) const
+	{
+		for (int k = 0; k < count; k++)
+		{
+			const int i = indices[k];
+
+			Real closestSoFar = result.tMax[i];
+			if (Traverse(root, packet.Get(i), tMin, closestSoFar, result.records[i], counters))
+			{
+				result.hit[i] = true;
+				result.tMax[i] = closestSoFar;
+			}
+		}
+	}
+
+	void BVH::RecordStats(uint64_t rays, const TraversalCounters& counters) const
+	{
+		if (collectStats)
+		{
+			statRays.fetch_add(rays, std::memory_order_relaxed);
+			statNodesVisited.fetch_add(counters.nodesVisited, std::memory_order_relaxed);
+			statPrimitiveTests.fetch_add(counters.primitiveTests, std::memory_order_relaxed);
+		}
+	}
+
+	AABB BVH::BoundingBox() const
+	{
+		return tree.Empty() ? AABB() : tree.Bounds();
+	}
+
+	BVHTraversalStats BVH::TraversalStats() const
+	{
+		BVHTraversalStats result;
+		result.rays = statRays.load(std::memory_order_relaxed);
+		result.nodesVisited = statNodesVisited.load(std::memory_order_relaxed);
+		result.primitiveTests = statPrimitiveTests.load(std::memory_order_relaxed);
+
+		return result;
+	}
+
+	void BVH::ResetTraversalStats()
+	{
+		statRays = 0;
+		statNodesVisited = 0;
+		statPrimitiveTests = 0;
+	}
+}
\ No newline at end of file
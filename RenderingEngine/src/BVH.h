@@ -0,0 +1,133 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Hittable.h"
+#include "HittableList.h"
+#include "BVHTree.h"
+#include "WideBVHTree.h"
+#include "PrimitiveStore.h"
+
+namespace Engine
+{
+	/** @brief Counters accumulated by BVH::Hit while statistics collection is enabled. */
+	struct BVHTraversalStats
+	{
+		uint64_t rays = 0;
+		uint64_t nodesVisited = 0;
+		uint64_t primitiveTests = 0;
+
+		double NodesPerRay() const { return rays ? double(nodesVisited) / rays : 0.0; }
+		double PrimitiveTestsPerRay() const { return rays ? double(primitiveTests) / rays : 0.0; }
+	};
+
+	/**
+	 * @class BVH
+	 * @brief Bounding volume hierarchy over a list of Hittable objects.
+	 *
+	 * Drop-in replacement for HittableList::Hit: the closest hit within 'ray_t'
+	 * is returned through the same Interval/HitRecord contract, but only objects
+	 * whose boxes are pierced by the ray are tested.
+	 *
+	 * The objects are copied into a PrimitiveStore, so traversal neither
+	 * dispatches virtually on known primitive types nor touches a shared_ptr.
+	 *
+	 * With BVHLayout::Wide8 single rays traverse a compressed 8-wide copy of
+	 * the tree instead, which is rebuilt from the binary tree on every Update().
+	 */
+	class BVH : public Hittable
+	{
+	public:
+
+		BVH(const HittableList& list, const BVHBuildOptions& options = BVHBuildOptions());
+		BVH(const std::vector<std::shared_ptr<Hittable>>& objects, const BVHBuildOptions& options = BVHBuildOptions());
+
+		/**
+		 * @brief Updates the hierarchy after its objects moved, like a PERFORM_UPDATE acceleration structure build.
+		 *
+		 * 'objects' must be the list the BVH was built from, in the same order,
+		 * with only transforms or positions changed. The objects are copied
+		 * again and the tree boxes are refitted in O(n); if the refitted SAH
+		 * cost exceeds BVHBuildOptions::maxRefitCostGrowth times the cost of
+		 * the last build, the tree is rebuilt from scratch instead.
+		 *
+		 * @return True if the tree was rebuilt.
+		 */
+		bool Update(const HittableList& list);
+		bool Update(const std::vector<std::shared_ptr<Hittable>>& objects);
+
+		bool Hit(const Ray& ray, Interval ray_t, HitRecord& record) const override;
+
+		/**
+		 * @brief Packet traversal: one box test per node for all active rays.
+		 *
+		 * Rays that miss a node's box are dropped from the packet for that
+		 * subtree. Packets whose directions span several octants, or that shrink
+		 * below the fallback ratio at some node, continue as single rays.
+		 */
+		void HitPacket(const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const override;
+
+		bool Occluded(const Ray& ray, Interval ray_t) const override;
+
+		AABB BoundingBox() const override;
+
+		const BVHTree& Tree() const { return tree; }
+		const WideBVHTree& WideTree() const { return wideTree; }
+		const BVHBuildStats& BuildStats() const { return tree.BuildStats(); }
+
+		/**
+		 * @brief Enables or disables traversal statistics.
+		 *
+		 * Collection is off by default since every Hit() then performs atomic
+		 * updates on shared counters.
+		 */
+		void SetCollectStats(bool enabled) { collectStats = enabled; }
+
+		/**
+		 * @brief Sets the fraction of a packet that must still be active for packet traversal to continue.
+		 * @param ratio Value in [0, 1]; below it the remaining rays are traced individually.
+		 */
+		void SetPacketFallbackRatio(double ratio) { packetFallbackRatio = std::clamp(ratio, 0.0, 1.0); }
+
+		BVHTraversalStats TraversalStats() const;
+		void ResetTraversalStats();
+
+	private:
+
+		BVHTree tree;
+		PrimitiveStore primitives;
+		std::vector<uint32_t> handles; ///< Primitive handles in the leaf order of 'tree'.
+
+		WideBVHTree wideTree;			   ///< Empty unless the layout is BVHLayout::Wide8.
+		std::vector<uint32_t> wideHandles; ///< Primitive handles in the leaf order of 'wideTree'.
+
+		struct TraversalCounters
+		{
+			uint64_t nodesVisited = 0;
+			uint64_t primitiveTests = 0;
+		};
+
+		double packetFallbackRatio = 0.25;
+
+		bool collectStats = false;
+		mutable std::atomic<uint64_t> statRays = 0;
+		mutable std::atomic<uint64_t> statNodesVisited = 0;
+		mutable std::atomic<uint64_t> statPrimitiveTests = 0;
+
+		void Build(const std::vector<std::shared_ptr<Hittable>>& objects, const BVHBuildOptions& options);
+
+		/** @brief Collapses 'tree' into 'wideTree' and orders 'wideHandles' to match, or clears both for the binary layout. */
+		void BuildWide();
+
+		/** @brief Single-ray closest-hit traversal of the subtree rooted at 'root'. */
+		bool Traverse(uint32_t root, const Ray& ray, Real tMin, Real& closestSoFar, HitRecord& record, TraversalCounters& counters) const;
+
+		/** @brief Single-ray closest-hit traversal of 'wideTree'. */
+		bool TraverseWide(const Ray& ray, Real tMin, Real& closestSoFar, HitRecord& record, TraversalCounters& counters) const;
+
+		/** @brief Traces the listed packet rays one at a time through the subtree rooted at 'root'. */
+		void TraverseSingle(uint32_t root, const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result, TraversalCounters& counters) const;
+
+		void RecordStats(uint64_t rays, const TraversalCounters& counters) const;
+	};
+}
\ No newline at end of file
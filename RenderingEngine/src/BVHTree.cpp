@@ -0,0 +1,740 @@
+#include "pch.h"
+
+#include "BVHTree.h"
+#include "ThreadPool.h"
+
+#include <bit>
+
+namespace Engine
+{
+	namespace
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		struct Bin
+		{
+			AABB bounds;
+			uint32_t count = 0;
+		};
+
+		struct Split
+		{
+			int axis = -1;
+			int bin = 0;
+			double cost = std::numeric_limits<double>::infinity();
+		};
+
+		/** @brief A range of primitives below the top levels whose subtree is built as one task, rooted at 'node'. */
+		struct Subtree
+		{
+			uint32_t node;
+			uint32_t first;
+			uint32_t count;
+			int depth;
+		};
+
+		/** @brief Nodes of one subtree, rooted at index 0; interior child indices are local to 'nodes'. */
+		struct SubtreeResult
+		{
+			std::vector<BVHNode> nodes;
+			size_t leafCount = 0;
+			int maxDepth = 0;
+		};
+
+		/** @brief Primitives and parameters a split works on; subtrees use compact copies of their range. */
+		struct BuildContext
+		{
+			const std::vector<AABB>& primitiveBounds;
+			const std::vector<Vector3>& centroids;
+			std::vector<uint32_t>& indices;
+			const BVHBuildOptions& options;
+			int binCount;
+		};
+
+		/// Primitive loops are split into parallel chunks of this many items.
+		constexpr size_t ParallelGrain = size_t(1) << 14;
+
+		/// Ranges up to this size (or 1/64 of all primitives, if larger) are built as one subtree task.
+		constexpr uint32_t MinSubtreeSize = 4096;
+
+		/// Bits per axis of a Morton code, so a code fits 30 bits.
+		constexpr int MortonBits = 10;
+
+		/** @brief Returns the milliseconds since 'phase' and restarts it. */
+		double LapMs(Clock::time_point& phase)
+		{
+			const Clock::time_point now = Clock::now();
+			const double ms = std::chrono::duration<double, std::milli>(now - phase).count();
+			phase = now;
+			return ms;
+		}
+
+		/**
+		 * @brief Runs function(begin, end) over [0, count) in chunks of 'grain', on 'pool' if there is one.
+		 *
+		 * Chunks start at multiples of 'grain' either way, so 'begin / grain'
+		 * indexes per-chunk results identically with and without a pool.
+		 */
+		void ForEachChunk(ThreadPool* pool, size_t count, size_t grain, const std::function<void(size_t, size_t)>& function)
+		{
+			if (pool && count > grain)
+			{
+				pool->ParallelFor(count, grain, function);
+				return;
+			}
+
+			for (size_t begin = 0; begin < count; begin += grain)
+			{
+				function(begin, std::min(begin + grain, count));
+			}
+		}
+
+		int BinIndex(double centroid, double axisMin, double scale, int binCount)
+		{
+			const int bin = int((centroid - axisMin) * scale);
+			return std::clamp(bin, 0, binCount - 1);
+		}
+
+		double BinScale(const AABB& centroidBounds, int axis, int binCount)
+		{
+			const double size = centroidBounds.Axis(axis).Size();
+			return size > 0.0 ? binCount / size : 0.0;
+		}
+
+		/** @brief Spreads the low 10 bits of 'v' so that two zero bits follow each. */
+		uint32_t ExpandBits(uint32_t v)
+		{
+			v = (v * 0x00010001u) & 0xff0000ffu;
+			v = (v * 0x00000101u) & 0x0f00f00fu;
+			v = (v * 0x00000011u) & 0xc30c30c3u;
+			v = (v * 0x00000005u) & 0x49249249u;
+			return v;
+		}
+
+		/** @brief Grows 'bounds' and 'centroidBounds' by the primitives of index range [first, first + count). */
+		void GrowBounds(const BuildContext& context, uint32_t first, uint32_t count, AABB& bounds, AABB& centroidBounds)
+		{
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				bounds.Grow(context.primitiveBounds[context.indices[i]]);
+				centroidBounds.Grow(context.centroids[context.indices[i]]);
+			}
+		}
+
+		/** @brief Adds the primitives of [first, first + count) to 'bins', 'binCount' per axis, in one pass. */
+		void BinRange(const BuildContext& context, uint32_t first, uint32_t count, const AABB& centroidBounds, Bin* bins)
+		{
+			const int binCount = context.binCount;
+			const double scale[3] = { BinScale(centroidBounds, 0, binCount), BinScale(centroidBounds, 1, binCount), BinScale(centroidBounds, 2, binCount) };
+
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				const uint32_t primitive = context.indices[i];
+				const Vector3& centroid = context.centroids[primitive];
+
+				for (int axis = 0; axis < 3; axis++)
+				{
+					Bin& bin = bins[axis * binCount + BinIndex(centroid.data[axis], centroidBounds.Axis(axis).min, scale[axis], binCount)];
+					bin.bounds.Grow(context.primitiveBounds[primitive]);
+					bin.count++;
+				}
+			}
+		}
+
+		/** @brief Evaluates the SAH at every bin boundary along each axis and returns the cheapest split. */
+		Split FindSplit(const BuildContext& context, const Bin* bins, const AABB& centroidBounds, double nodeArea,
+			std::vector<double>& rightAreas, std::vector<uint32_t>& rightCounts)
+		{
+			const BVHBuildOptions& options = context.options;
+			const int binCount = context.binCount;
+
+			Split best;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (centroidBounds.Axis(axis).Size() <= 0.0)
+				{
+					continue;
+				}
+
+				const Bin* axisBins = bins + axis * binCount;
+
+				// Sweep from the right to accumulate the cost of the right-hand side of each plane.
+				AABB rightBounds;
+				uint32_t rightCount = 0;
+				for (int i = binCount - 1; i > 0; i--)
+				{
+					rightBounds.Grow(axisBins[i].bounds);
+					rightCount += axisBins[i].count;
+					rightAreas[i] = rightBounds.SurfaceArea();
+					rightCounts[i] = rightCount;
+				}
+
+				// Sweep from the left and combine with the right-hand side.
+				AABB leftBounds;
+				uint32_t leftCount = 0;
+				for (int i = 0; i < binCount - 1; i++)
+				{
+					leftBounds.Grow(axisBins[i].bounds);
+					leftCount += axisBins[i].count;
+
+					if (leftCount == 0 || rightCounts[i + 1] == 0)
+					{
+						continue;
+					}
+
+					const double cost = options.traversalCost + options.intersectionCost *
+						(leftBounds.SurfaceArea() * leftCount + rightAreas[i + 1] * rightCounts[i + 1]) / nodeArea;
+
+					if (cost < best.cost)
+					{
+						best.axis = axis;
+						best.bin = i;
+						best.cost = cost;
+					}
+				}
+			}
+
+			return best;
+		}
+
+		/** @brief Returns a predicate that is true for primitives left of the bin boundary chosen by 'split'. */
+		auto LeftOfSplit(const BuildContext& context, const Split& split, const AABB& centroidBounds)
+		{
+			const double axisMin = centroidBounds.Axis(split.axis).min;
+			const double scale = BinScale(centroidBounds, split.axis, context.binCount);
+
+			return [&context, split, axisMin, scale](uint32_t primitive)
+				{
+					return BinIndex(context.centroids[primitive].data[split.axis], axisMin, scale, context.binCount) <= split.bin;
+				};
+		}
+
+		/**
+		 * @brief Stable partition of 'indices' range [first, first + count) in parallel chunks.
+		 * @return Index of the first element for which 'isLeft' is false.
+		 */
+		template<typename Predicate>
+		uint32_t StablePartition(ThreadPool* pool, std::vector<uint32_t>& indices, std::vector<uint32_t>& scratch, uint32_t first, uint32_t count, Predicate isLeft)
+		{
+			const size_t chunks = (count + ParallelGrain - 1) / ParallelGrain;
+			std::vector<uint32_t> leftOffsets(chunks + 1, 0);
+
+			ForEachChunk(pool, count, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					leftOffsets[begin / ParallelGrain + 1] = uint32_t(std::count_if(indices.begin() + first + begin, indices.begin() + first + end, isLeft));
+				});
+
+			for (size_t chunk = 0; chunk < chunks; chunk++)
+			{
+				leftOffsets[chunk + 1] += leftOffsets[chunk];
+			}
+
+			const uint32_t leftCount = leftOffsets[chunks];
+			scratch.resize(std::max(scratch.size(), size_t(count)));
+
+			ForEachChunk(pool, count, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					// Right-hand elements before this chunk are those that are not left-hand ones.
+					uint32_t left = leftOffsets[begin / ParallelGrain];
+					uint32_t right = leftCount + uint32_t(begin) - left;
+
+					for (size_t i = begin; i < end; i++)
+					{
+						const uint32_t primitive = indices[first + i];
+						scratch[isLeft(primitive) ? left++ : right++] = primitive;
+					}
+				});
+
+			ForEachChunk(pool, count, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					std::copy(scratch.begin() + begin, scratch.begin() + end, indices.begin() + first + begin);
+				});
+
+			return first + leftCount;
+		}
+
+		/**
+		 * @brief Stable LSD radix sort of 'values' by 'keys', 8 bits per pass.
+		 *
+		 * Every pass counts digits per chunk in parallel, turns the counts into
+		 * per-chunk offsets in digit-major order and scatters the chunks in
+		 * parallel, so the result does not depend on the number of threads.
+		 */
+		void RadixSort(ThreadPool* pool, std::vector<uint32_t>& keys, std::vector<uint32_t>& values, int keyBits)
+		{
+			const size_t n = keys.size();
+			const size_t chunks = (n + ParallelGrain - 1) / ParallelGrain;
+
+			std::vector<uint32_t> keysOut(n), valuesOut(n);
+			std::vector<std::array<uint32_t, 256>> offsets(chunks);
+
+			for (int shift = 0; shift < keyBits; shift += 8)
+			{
+				ForEachChunk(pool, n, ParallelGrain, [&](size_t begin, size_t end)
+					{
+						std::array<uint32_t, 256>& histogram = offsets[begin / ParallelGrain];
+						histogram.fill(0);
+
+						for (size_t i = begin; i < end; i++)
+						{
+							histogram[(keys[i] >> shift) & 0xff]++;
+						}
+					});
+
+				uint32_t sum = 0;
+				for (int digit = 0; digit < 256; digit++)
+				{
+					for (std::array<uint32_t, 256>& histogram : offsets)
+					{
+						const uint32_t digitCount = histogram[digit];
+						histogram[digit] = sum;
+						sum += digitCount;
+					}
+				}
+
+				ForEachChunk(pool, n, ParallelGrain, [&](size_t begin, size_t end)
+					{
+						std::array<uint32_t, 256>& offset = offsets[begin / ParallelGrain];
+
+						for (size_t i = begin; i < end; i++)
+						{
+							const uint32_t target = offset[(keys[i] >> shift) & 0xff]++;
+							keysOut[target] = keys[i];
+							valuesOut[target] = values[i];
+						}
+					});
+
+				keys.swap(keysOut);
+				values.swap(valuesOut);
+			}
+		}
+
+		/** @brief Splits a Morton-sorted range where its codes first differ in the highest bit, or in the middle if they are all equal. */
+		uint32_t SplitMorton(const std::vector<uint32_t>& codes, const Subtree& range)
+		{
+			const uint32_t firstCode = codes[range.first];
+			const uint32_t lastCode = codes[range.first + range.count - 1];
+
+			if (firstCode == lastCode)
+			{
+				return range.first + range.count / 2;
+			}
+
+			// Codes share every bit above 'bit', so those with it clear come first.
+			const int bit = std::bit_width(firstCode ^ lastCode) - 1;
+			const auto begin = codes.begin() + range.first;
+			const auto split = std::partition_point(begin, begin + range.count, [bit](uint32_t code) { return ((code >> bit) & 1) == 0; });
+
+			return range.first + uint32_t(split - begin);
+		}
+
+		/** @brief Splits a top-level range by binned SAH, with the binning and partitioning in parallel. */
+		uint32_t SplitBinned(const BuildContext& context, const Subtree& range, std::vector<uint32_t>& scratch)
+		{
+			ThreadPool* pool = context.options.pool;
+			const int binCount = context.binCount;
+			const size_t chunks = (range.count + ParallelGrain - 1) / ParallelGrain;
+
+			std::vector<AABB> chunkBounds(chunks), chunkCentroidBounds(chunks);
+			ForEachChunk(pool, range.count, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					const size_t chunk = begin / ParallelGrain;
+					GrowBounds(context, range.first + uint32_t(begin), uint32_t(end - begin), chunkBounds[chunk], chunkCentroidBounds[chunk]);
+				});
+
+			AABB bounds, centroidBounds;
+			for (size_t chunk = 0; chunk < chunks; chunk++)
+			{
+				bounds.Grow(chunkBounds[chunk]);
+				centroidBounds.Grow(chunkCentroidBounds[chunk]);
+			}
+
+			// Bin every chunk separately, then merge into the bins of the first.
+			const size_t binsPerChunk = size_t(3) * binCount;
+			std::vector<Bin> bins(chunks * binsPerChunk);
+			ForEachChunk(pool, range.count, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					BinRange(context, range.first + uint32_t(begin), uint32_t(end - begin), centroidBounds, &bins[begin / ParallelGrain * binsPerChunk]);
+				});
+
+			for (size_t chunk = 1; chunk < chunks; chunk++)
+			{
+				for (size_t i = 0; i < binsPerChunk; i++)
+				{
+					bins[i].bounds.Grow(bins[chunk * binsPerChunk + i].bounds);
+					bins[i].count += bins[chunk * binsPerChunk + i].count;
+				}
+			}
+
+			std::vector<double> rightAreas(binCount);
+			std::vector<uint32_t> rightCounts(binCount);
+			const Split best = FindSplit(context, bins.data(), centroidBounds, bounds.SurfaceArea(), rightAreas, rightCounts);
+
+			uint32_t middle = range.first + range.count / 2;
+
+			if (best.axis >= 0)
+			{
+				middle = StablePartition(pool, context.indices, scratch, range.first, range.count, LeftOfSplit(context, best, centroidBounds));
+			}
+
+			// Degenerate partitions (e.g. all centroids coincide) fall back to an even split.
+			if (middle == range.first || middle == range.first + range.count)
+			{
+				middle = range.first + range.count / 2;
+			}
+
+			return middle;
+		}
+
+		/**
+		 * @brief Builds the subtree over one range top-down by binned SAH on the calling thread.
+		 *
+		 * The range's boxes and centroids are first gathered into compact local
+		 * arrays: its primitives are scattered over the whole input, and every
+		 * level of the subtree passes over all of them again.
+		 */
+		void BuildSubtree(const BuildContext& shared, const Subtree& subtree, SubtreeResult& result)
+		{
+			struct BuildTask
+			{
+				uint32_t node;
+				int depth;
+			};
+
+			std::vector<AABB> primitiveBounds(subtree.count);
+			std::vector<Vector3> centroids(subtree.count);
+			std::vector<uint32_t> indices(subtree.count);
+			std::vector<uint32_t> original(shared.indices.begin() + subtree.first, shared.indices.begin() + subtree.first + subtree.count);
+
+			for (uint32_t i = 0; i < subtree.count; i++)
+			{
+				primitiveBounds[i] = shared.primitiveBounds[original[i]];
+				centroids[i] = shared.centroids[original[i]];
+				indices[i] = i;
+			}
+
+			const BuildContext context{ primitiveBounds, centroids, indices, shared.options, shared.binCount };
+			const BVHBuildOptions& options = context.options;
+			const int binCount = context.binCount;
+
+			std::vector<Bin> bins(size_t(3) * binCount);
+			std::vector<double> rightAreas(binCount);
+			std::vector<uint32_t> rightCounts(binCount);
+
+			// A binary tree with n leaves at most has 2n - 1 nodes.
+			std::vector<BVHNode>& nodes = result.nodes;
+			nodes.reserve(size_t(2) * subtree.count - 1);
+			nodes.push_back({ AABB(), 0, subtree.count });
+
+			std::vector<BuildTask> tasks;
+			tasks.push_back({ 0, subtree.depth });
+
+			while (!tasks.empty())
+			{
+				const BuildTask task = tasks.back();
+				tasks.pop_back();
+
+				const uint32_t first = nodes[task.node].leftFirst;
+				const uint32_t count = nodes[task.node].count;
+
+				// Compute the node bounds and the bounds of the primitive centroids.
+				AABB bounds;
+				AABB centroidBounds;
+				GrowBounds(context, first, count, bounds, centroidBounds);
+
+				nodes[task.node].bounds = bounds;
+				result.maxDepth = std::max(result.maxDepth, task.depth);
+
+				if (count == 1 || task.depth >= BVHTree::MaxDepth - 1)
+				{
+					result.leafCount++;
+					continue;
+				}
+
+				std::fill(bins.begin(), bins.end(), Bin());
+				BinRange(context, first, count, centroidBounds, bins.data());
+
+				const Split best = FindSplit(context, bins.data(), centroidBounds, bounds.SurfaceArea(), rightAreas, rightCounts);
+				const double leafCost = options.intersectionCost * count;
+
+				if (count <= uint32_t(options.maxLeafSize) && (best.axis < 0 || best.cost >= leafCost))
+				{
+					result.leafCount++;
+					continue;
+				}
+
+				uint32_t middle = first + count / 2;
+
+				if (best.axis >= 0)
+				{
+					// Partition the primitive range around the chosen bin boundary.
+					auto begin = context.indices.begin() + first;
+					auto split = std::partition(begin, begin + count, LeftOfSplit(context, best, centroidBounds));
+
+					middle = first + uint32_t(split - begin);
+				}
+
+				// Degenerate partitions (e.g. all centroids coincide) fall back to an even split.
+				if (middle == first || middle == first + count)
+				{
+					middle = first + count / 2;
+				}
+
+				const uint32_t leftChild = uint32_t(nodes.size());
+				nodes.push_back({ AABB(), first, middle - first });
+				nodes.push_back({ AABB(), middle, first + count - middle });
+
+				nodes[task.node].leftFirst = leftChild;
+				nodes[task.node].count = 0;
+
+				tasks.push_back({ leftChild + 1, task.depth + 1 });
+				tasks.push_back({ leftChild, task.depth + 1 });
+			}
+
+			// Map the local order back to primitive indices and the leaves to the full range.
+			for (uint32_t i = 0; i < subtree.count; i++)
+			{
+				shared.indices[subtree.first + i] = original[indices[i]];
+			}
+
+			for (BVHNode& node : nodes)
+			{
+				if (node.IsLeaf())
+				{
+					node.leftFirst += subtree.first;
+				}
+			}
+		}
+	}
+
+	void BVHTree::Build(const std::vector<AABB>& primitiveBounds, const BVHBuildOptions& options)
+	{
+		const Clock::time_point start = Clock::now();
+		Clock::time_point phase = start;
+
+		const uint32_t n = uint32_t(primitiveBounds.size());
+
+		nodes.clear();
+		primitiveIndices.resize(n);
+		this->options = options;
+		stats = BVHBuildStats();
+		stats.primitiveCount = n;
+
+		if (n == 0)
+		{
+			return;
+		}
+
+		ThreadPool* pool = options.pool;
+		std::vector<Vector3> centroids(n);
+		const BuildContext context{ primitiveBounds, centroids, primitiveIndices, this->options, std::max(options.binCount, 2) };
+
+		ForEachChunk(pool, n, ParallelGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					primitiveIndices[i] = uint32_t(i);
+					centroids[i] = primitiveBounds[i].Centroid();
+				}
+			});
+
+		stats.phases.centroidsMs = LapMs(phase);
+
+		// Fast mode orders the primitives along a Morton curve over the centroid bounds.
+		std::vector<uint32_t> codes;
+		if (options.mode == BVHBuildMode::Fast)
+		{
+			const size_t chunks = (n + ParallelGrain - 1) / ParallelGrain;
+			std::vector<AABB> chunkBounds(chunks);
+			ForEachChunk(pool, n, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						chunkBounds[begin / ParallelGrain].Grow(centroids[i]);
+					}
+				});
+
+			AABB centroidBounds;
+			for (const AABB& bounds : chunkBounds)
+			{
+				centroidBounds.Grow(bounds);
+			}
+
+			constexpr double cells = double(1 << MortonBits);
+			const double scale[3] = { BinScale(centroidBounds, 0, 1) * cells, BinScale(centroidBounds, 1, 1) * cells, BinScale(centroidBounds, 2, 1) * cells };
+
+			codes.resize(n);
+			ForEachChunk(pool, n, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						uint32_t code = 0;
+						for (int axis = 0; axis < 3; axis++)
+						{
+							const int cell = BinIndex(centroids[i].data[axis], centroidBounds.Axis(axis).min, scale[axis], 1 << MortonBits);
+							code |= ExpandBits(uint32_t(cell)) << (2 - axis);
+						}
+
+						codes[i] = code;
+					}
+				});
+
+			stats.phases.mortonMs = LapMs(phase);
+
+			RadixSort(pool, codes, primitiveIndices, 3 * MortonBits);
+			stats.phases.sortMs = LapMs(phase);
+		}
+
+		// Split the top levels until every range is small enough to be one task.
+		const uint32_t subtreeSize = std::max({ MinSubtreeSize, n / 64, uint32_t(std::max(options.maxLeafSize, 1)) });
+
+		nodes.reserve(size_t(2) * n - 1);
+		nodes.push_back({ AABB(), 0, n });
+
+		std::vector<Subtree> subtrees;
+		std::vector<Subtree> pending;
+		std::vector<uint32_t> scratch;
+		pending.push_back({ 0, 0, n, 0 });
+
+		while (!pending.empty())
+		{
+			const Subtree range = pending.back();
+			pending.pop_back();
+
+			if (range.count <= subtreeSize || range.depth >= MaxDepth - 1)
+			{
+				subtrees.push_back(range);
+				continue;
+			}
+
+			const uint32_t middle = (options.mode == BVHBuildMode::Fast) ? SplitMorton(codes, range) : SplitBinned(context, range, scratch);
+
+			const uint32_t leftChild = uint32_t(nodes.size());
+			nodes.push_back({ AABB(), range.first, middle - range.first });
+			nodes.push_back({ AABB(), middle, range.first + range.count - middle });
+
+			nodes[range.node].leftFirst = leftChild;
+			nodes[range.node].count = 0;
+
+			pending.push_back({ leftChild + 1, middle, range.first + range.count - middle, range.depth + 1 });
+			pending.push_back({ leftChild, range.first, middle - range.first, range.depth + 1 });
+		}
+
+		stats.phases.topLevelMs = LapMs(phase);
+
+		std::vector<SubtreeResult> results(subtrees.size());
+		ForEachChunk(pool, subtrees.size(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					BuildSubtree(context, subtrees[i], results[i]);
+				}
+			});
+
+		stats.phases.subtreesMs = LapMs(phase);
+
+		// Each subtree root replaces its top-level node; the rest follow the top levels in subtree order.
+		const size_t topCount = nodes.size();
+		std::vector<size_t> offsets(subtrees.size());
+
+		size_t nodeCount = topCount;
+		for (size_t i = 0; i < subtrees.size(); i++)
+		{
+			offsets[i] = nodeCount;
+			nodeCount += results[i].nodes.size() - 1;
+
+			stats.leafCount += results[i].leafCount;
+			stats.maxDepth = std::max(stats.maxDepth, results[i].maxDepth);
+		}
+
+		nodes.resize(nodeCount);
+		ForEachChunk(pool, subtrees.size(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const std::vector<BVHNode>& local = results[i].nodes;
+
+					for (size_t k = 0; k < local.size(); k++)
+					{
+						BVHNode node = local[k];
+						if (!node.IsLeaf())
+						{
+							node.leftFirst = uint32_t(offsets[i] + node.leftFirst - 1);
+						}
+
+						nodes[k == 0 ? subtrees[i].node : offsets[i] + k - 1] = node;
+					}
+				}
+			});
+
+		// Top-level children are stored after their parent, so a reverse sweep fits them bottom-up.
+		for (size_t i = topCount; i-- > 0;)
+		{
+			if (!nodes[i].IsLeaf())
+			{
+				nodes[i].bounds = AABB(nodes[nodes[i].leftFirst].bounds, nodes[nodes[i].leftFirst + 1].bounds);
+			}
+		}
+
+		stats.phases.flattenMs = LapMs(phase);
+
+		stats.subtreeCount = subtrees.size();
+		stats.nodeCount = nodes.size();
+		stats.sahCost = SAHCost(options.traversalCost, options.intersectionCost);
+
+		stats.buildTimeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	double BVHTree::SAHCost(double traversalCost, double intersectionCost) const
+	{
+		if (nodes.empty())
+		{
+			return 0.0;
+		}
+
+		const double rootArea = nodes.front().bounds.SurfaceArea();
+		if (rootArea <= 0.0)
+		{
+			return intersectionCost * primitiveIndices.size();
+		}
+
+		double cost = 0.0;
+		for (const BVHNode& node : nodes)
+		{
+			const double area = node.bounds.SurfaceArea();
+			cost += node.IsLeaf() ? intersectionCost * node.count * area : traversalCost * area;
+		}
+
+		return cost / rootArea;
+	}
+
+	double BVHTree::Refit(const std::vector<AABB>& primitiveBounds)
+	{
+		if (primitiveBounds.size() != primitiveIndices.size())
+		{
+			throw std::invalid_argument("BVHTree::Refit requires the bounds of every primitive the tree was built over!");
+		}
+
+		for (size_t i = nodes.size(); i-- > 0;)
+		{
+			BVHNode& node = nodes[i];
+
+			if (node.IsLeaf())
+			{
+				node.bounds = AABB();
+				for (uint32_t k = node.leftFirst; k < node.leftFirst + node.count; k++)
+				{
+					node.bounds.Grow(primitiveBounds[primitiveIndices[k]]);
+				}
+			}
+			else
+			{
+				node.bounds = AABB(nodes[node.leftFirst].bounds, nodes[node.leftFirst + 1].bounds);
+			}
+		}
+
+		const double cost = SAHCost(options.traversalCost, options.intersectionCost);
+
+		return stats.sahCost > 0.0 ? cost / stats.sahCost : 1.0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,303 @@
+#pragma once
+
+#include "pch.h"
+
+#include "AABB.h"
+
+namespace Engine
+{
+	class ThreadPool;
+
+	/**
+	 * @brief A single node of a flattened binary BVH.
+	 *
+	 * Children of an interior node are stored next to each other, so only the
+	 * index of the left child is kept; the right child is at 'leftFirst + 1'.
+	 */
+	struct BVHNode
+	{
+		AABB bounds;
+		uint32_t leftFirst = 0; ///< Left child index (interior) or first primitive index (leaf).
+		uint32_t count = 0;		///< Number of primitives in a leaf, zero for interior nodes.
+
+		bool IsLeaf() const { return count > 0; }
+	};
+
+	/** @brief How the top levels of a BVHTree are split. */
+	enum class BVHBuildMode
+	{
+		/// Binned SAH at every level; the same tree as a single-threaded build, for final frames.
+		Quality,
+		/// Morton-code (LBVH) splits at the top levels and binned SAH below, for interactive edits.
+		Fast
+	};
+
+	/** @brief Node layout a BVH traces single rays through. */
+	enum class BVHLayout
+	{
+		/// The binary BVHTree with full-precision boxes.
+		Binary,
+		/// A WideBVHTree collapsed from it: eight children per node, bounds quantized to 8 bits.
+		Wide8
+	};
+
+	/** @brief Parameters of the binned surface area heuristic used to build a BVHTree. */
+	struct BVHBuildOptions
+	{
+		int binCount = 16;			   ///< Number of centroid bins evaluated per axis.
+		int maxLeafSize = 4;		   ///< Nodes with more primitives than this are always split.
+		double traversalCost = 1.0;	   ///< Relative cost of visiting an interior node.
+		double intersectionCost = 1.0; ///< Relative cost of one primitive intersection test.
+
+		/// Refitted trees whose SAH cost has grown past this factor of the built cost are rebuilt by BVH::Update().
+		double maxRefitCostGrowth = 1.5;
+
+		BVHBuildMode mode = BVHBuildMode::Quality;
+
+		/// Layout used by BVH::Hit() and BVH::Occluded(); packets always traverse the binary tree.
+		BVHLayout layout = BVHLayout::Binary;
+
+		/// Pool that runs the build, or null to build on the calling thread. Must outlive every Build() and BVH::Update() using these options.
+		ThreadPool* pool = nullptr;
+	};
+
+	/** @brief Wall-clock time of each BVHTree build phase; phases a mode skips stay zero. */
+	struct BVHBuildPhaseTimes
+	{
+		double centroidsMs = 0.0; ///< Primitive centroids and their bounds.
+		double mortonMs = 0.0;	  ///< Morton codes of the centroids (Fast mode).
+		double sortMs = 0.0;	  ///< Radix sort of the primitives by Morton code (Fast mode).
+		double topLevelMs = 0.0;  ///< Splitting the top levels into independent subtrees.
+		double subtreesMs = 0.0;  ///< Building the subtrees as parallel tasks.
+		double flattenMs = 0.0;	  ///< Copying the subtrees into 'nodes' and fitting the top-level boxes.
+	};
+
+	/** @brief Statistics gathered while building a BVHTree. */
+	struct BVHBuildStats
+	{
+		double buildTimeMs = 0.0;
+		size_t primitiveCount = 0;
+		size_t nodeCount = 0;
+		size_t leafCount = 0;
+		int maxDepth = 0;
+		double sahCost = 0.0;
+		size_t subtreeCount = 0; ///< Subtrees built independently below the top levels.
+		BVHBuildPhaseTimes phases;
+	};
+
+	/**
+	 * @class BVHTree
+	 * @brief Topology of a bounding volume hierarchy over a set of primitive bounds.
+	 *
+	 * The tree knows nothing about the primitives themselves, only their boxes.
+	 * Leaves reference a contiguous range of 'primitiveIndices', which maps back
+	 * to the order in which bounds were passed to Build(). Owners of a tree
+	 * (BVH, meshes, ...) typically reorder their primitive storage to match so
+	 * that traversal does not need the extra indirection.
+	 */
+	class BVHTree
+	{
+	public:
+
+		/// Upper bound on the depth of a built tree, so traversal can use a fixed-size stack.
+		static constexpr int MaxDepth = 64;
+
+		std::vector<BVHNode> nodes;
+		std::vector<uint32_t> primitiveIndices;
+
+		/**
+		 * @brief Builds the tree top-down using a binned surface area heuristic.
+		 *
+		 * The top levels are split until every remaining range is small
+		 * enough to be built independently; those subtrees then run as tasks
+		 * on 'options.pool' and are copied into 'nodes' behind the top levels.
+		 * In Quality mode the top levels are binned SAH splits whose binning
+		 * and partitioning run in parallel, so the tree does not depend on the
+		 * pool. Fast mode instead radix-sorts the primitives by the Morton
+		 * code of their centroids and splits the top levels at the highest
+		 * differing code bit, which costs no binning at all.
+		 *
+		 * @param primitiveBounds Bounding box of every primitive.
+		 * @param options SAH parameters, build mode and thread pool.
+		 */
+		void Build(const std::vector<AABB>& primitiveBounds, const BVHBuildOptions& options = BVHBuildOptions());
+
+		/**
+		 * @brief Computes the SAH cost of the tree, normalized by the surface area of the root.
+		 * @param traversalCost Relative cost of visiting an interior node.
+		 * @param intersectionCost Relative cost of one primitive intersection test.
+		 */
+		double SAHCost(double traversalCost = 1.0, double intersectionCost = 1.0) const;
+
+		/**
+		 * @brief Refits every node's box to new primitive bounds, keeping the topology.
+		 *
+		 * Runs in O(n): children are always stored after their parent, so a
+		 * single reverse sweep over 'nodes' updates both children before the
+		 * parent. Quality degrades as primitives drift from where the tree
+		 * was built, which the returned cost growth measures.
+		 *
+		 * @param primitiveBounds New box of every primitive, in the order passed to Build().
+		 * @return SAH cost of the refitted tree divided by its cost after the last Build().
+		 */
+		double Refit(const std::vector<AABB>& primitiveBounds);
+
+		/**
+		 * @brief Ordered closest-hit traversal of the subtree rooted at 'root'.
+		 *
+		 * Children are visited near-first and nodes lying behind the closest hit
+		 * found so far are skipped. 'intersectLeaf(first, count)' must test the
+		 * primitives of leaf range [first, first + count), shrink 'closestSoFar'
+		 * on a closer hit and return true if it found one.
+		 *
+		 * @param nodesVisited Incremented once per visited node.
+		 * @return True if any leaf reported a hit.
+		 */
+		template<typename LeafFunction>
+		bool Traverse(uint32_t root, const Ray& ray, Real tMin, Real& closestSoFar, uint64_t& nodesVisited, LeafFunction&& intersectLeaf) const
+		{
+			return Traverse(nodes.data(), root, ray, tMin, closestSoFar, nodesVisited, std::forward<LeafFunction>(intersectLeaf));
+		}
+
+		/** @brief Traverse() over nodes stored outside a BVHTree, such as a mapped SceneCache file. */
+		template<typename LeafFunction>
+		static bool Traverse(const BVHNode* nodes, uint32_t root, const Ray& ray, Real tMin, Real& closestSoFar, uint64_t& nodesVisited, LeafFunction&& intersectLeaf)
+		{
+			struct StackEntry
+			{
+				uint32_t node;
+				Real tEntry;
+			};
+
+			const Vector3 invDirection(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+
+			StackEntry stack[MaxDepth];
+			int stackSize = 0;
+			bool hitAnything = false;
+
+			Real tEntry;
+			if (nodes[root].bounds.Hit(ray.origin, invDirection, tMin, closestSoFar, tEntry))
+			{
+				stack[stackSize++] = { root, tEntry };
+			}
+
+			while (stackSize > 0)
+			{
+				const StackEntry entry = stack[--stackSize];
+
+				// Skip nodes that lie entirely behind a hit found since they were pushed.
+				if (entry.tEntry > closestSoFar)
+				{
+					continue;
+				}
+
+				const BVHNode& node = nodes[entry.node];
+				nodesVisited++;
+
+				if (node.IsLeaf())
+				{
+					hitAnything |= intersectLeaf(node.leftFirst, node.count);
+					continue;
+				}
+
+				// Push the far child first so the near child is visited next.
+				Real tLeft, tRight;
+				const bool hitLeft = nodes[node.leftFirst].bounds.Hit(ray.origin, invDirection, tMin, closestSoFar, tLeft);
+				const bool hitRight = nodes[node.leftFirst + 1].bounds.Hit(ray.origin, invDirection, tMin, closestSoFar, tRight);
+
+				if (hitLeft && hitRight)
+				{
+					if (tLeft <= tRight)
+					{
+						stack[stackSize++] = { node.leftFirst + 1, tRight };
+						stack[stackSize++] = { node.leftFirst, tLeft };
+					}
+					else
+					{
+						stack[stackSize++] = { node.leftFirst, tLeft };
+						stack[stackSize++] = { node.leftFirst + 1, tRight };
+					}
+				}
+				else if (hitLeft)
+				{
+					stack[stackSize++] = { node.leftFirst, tLeft };
+				}
+				else if (hitRight)
+				{
+					stack[stackSize++] = { node.leftFirst + 1, tRight };
+				}
+			}
+
+			return hitAnything;
+		}
+
+		/**
+		 * @brief Any-hit traversal of the subtree rooted at 'root' over [tMin, tMax].
+		 *
+		 * Stops as soon as 'intersectLeaf(first, count)' returns true for a
+		 * leaf. Since any hit ends the search, children are not ordered.
+		 *
+		 * @param nodesVisited Incremented once per visited node.
+		 * @return True if some leaf reported a hit.
+		 */
+		template<typename LeafFunction>
+		bool TraverseAny(uint32_t root, const Ray& ray, Real tMin, Real tMax, uint64_t& nodesVisited, LeafFunction&& intersectLeaf) const
+		{
+			return TraverseAny(nodes.data(), root, ray, tMin, tMax, nodesVisited, std::forward<LeafFunction>(intersectLeaf));
+		}
+
+		/** @brief TraverseAny() over nodes stored outside a BVHTree. */
+		template<typename LeafFunction>
+		static bool TraverseAny(const BVHNode* nodes, uint32_t root, const Ray& ray, Real tMin, Real tMax, uint64_t& nodesVisited, LeafFunction&& intersectLeaf)
+		{
+			const Vector3 invDirection(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+
+			uint32_t stack[MaxDepth];
+			int stackSize = 0;
+
+			Real tEntry;
+			if (nodes[root].bounds.Hit(ray.origin, invDirection, tMin, tMax, tEntry))
+			{
+				stack[stackSize++] = root;
+			}
+
+			while (stackSize > 0)
+			{
+				const BVHNode& node = nodes[stack[--stackSize]];
+				nodesVisited++;
+
+				if (node.IsLeaf())
+				{
+					if (intersectLeaf(node.leftFirst, node.count))
+					{
+						return true;
+					}
+
+					continue;
+				}
+
+				for (const uint32_t child : { node.leftFirst, node.leftFirst + 1 })
+				{
+					if (nodes[child].bounds.Hit(ray.origin, invDirection, tMin, tMax, tEntry))
+					{
+						stack[stackSize++] = child;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		bool Empty() const { return nodes.empty(); }
+
+		const AABB& Bounds() const { return nodes.front().bounds; }
+
+		const BVHBuildStats& BuildStats() const { return stats; }
+		const BVHBuildOptions& BuildOptions() const { return options; }
+
+	private:
+
+		BVHBuildStats stats;
+		BVHBuildOptions options;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "pch.h"
+
+#include "BulkRandom.h"
+#include "Random.h"
+#include "Sampling.h"
+
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		uint64_t Rotl(uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+		/** @brief Top 52 bits as the mantissa of a double in [1, 2), shifted to [0, 1). */
+		double ToDouble(uint64_t x)
+		{
+			return std::bit_cast<double>((x >> 12) | 0x3ff0000000000000ull) - 1.0;
+		}
+
+		/** @brief Top 23 bits as the mantissa of a float in [1, 2), shifted to [0, 1). */
+		float ToFloat(uint32_t x)
+		{
+			return std::bit_cast<float>((x >> 9) | 0x3f800000u) - 1.0f;
+		}
+
+#if defined(__AVX2__)
+		__m256i Rotl(__m256i x, int k)
+		{
+			return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+		}
+
+		/** @brief One xoshiro256+ step of all four lanes. */
+		__m256i Step(__m256i& s0, __m256i& s1, __m256i& s2, __m256i& s3)
+		{
+			const __m256i result = _mm256_add_epi64(s0, s3);
+			const __m256i t = _mm256_slli_epi64(s1, 17);
+
+			s2 = _mm256_xor_si256(s2, s0);
+			s3 = _mm256_xor_si256(s3, s1);
+			s1 = _mm256_xor_si256(s1, s2);
+			s0 = _mm256_xor_si256(s0, s3);
+			s2 = _mm256_xor_si256(s2, t);
+			s3 = Rotl(s3, 45);
+
+			return result;
+		}
+#endif
+	}
+
+	BulkRandom::BulkRandom(uint64_t seed, uint64_t stream)
+	{
+		// SplitMix64 never yields four zero words in a row, the one state xoshiro must avoid.
+		uint64_t x = Random::Hash(seed) ^ Random::Hash(stream + 0x632be59bd9b4e019ull);
+		for (int k = 0; k < 4; k++)
+		{
+			for (int i = 0; i < Lanes; i++)
+			{
+				x += 0x9e3779b97f4a7c15ull;
+				state[k][i] = Random::Hash(x);
+			}
+		}
+	}
+
+	void BulkRandom::Next(uint64_t* out)
+	{
+		for (int i = 0; i < Lanes; i++)
+		{
+			uint64_t& s0 = state[0][i];
+			uint64_t& s1 = state[1][i];
+			uint64_t& s2 = state[2][i];
+			uint64_t& s3 = state[3][i];
+
+			out[i] = s0 + s3;
+			const uint64_t t = s1 << 17;
+
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = Rotl(s3, 45);
+		}
+	}
+
+	void BulkRandom::Fill(double* out, size_t count)
+	{
+		size_t i = 0;
+
+#if defined(__AVX2__)
+		__m256i s0 = _mm256_load_si256((const __m256i*)state[0]);
+		__m256i s1 = _mm256_load_si256((const __m256i*)state[1]);
+		__m256i s2 = _mm256_load_si256((const __m256i*)state[2]);
+		__m256i s3 = _mm256_load_si256((const __m256i*)state[3]);
+
+		const __m256i exponent = _mm256_set1_epi64x(0x3ff0000000000000ll);
+		const __m256d one = _mm256_set1_pd(1.0);
+
+		for (; i + Lanes <= count; i += Lanes)
+		{
+			const __m256i bits = _mm256_or_si256(_mm256_srli_epi64(Step(s0, s1, s2, s3), 12), exponent);
+			_mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_castsi256_pd(bits), one));
+		}
+
+		_mm256_store_si256((__m256i*)state[0], s0);
+		_mm256_store_si256((__m256i*)state[1], s1);
+		_mm256_store_si256((__m256i*)state[2], s2);
+		_mm256_store_si256((__m256i*)state[3], s3);
+#endif
+
+		uint64_t block[Lanes];
+		for (; i < count; i += Lanes)
+		{
+			Next(block);
+			for (size_t lane = 0; lane < Lanes && i + lane < count; lane++)
+			{
+				out[i + lane] = ToDouble(block[lane]);
+			}
+		}
+	}
+
+	void BulkRandom::Fill(float* out, size_t count)
+	{
+		// Each 64-bit output holds two floats: its low half, then its high half.
+		constexpr size_t blockSize = 2 * Lanes;
+		size_t i = 0;
+
+#if defined(__AVX2__)
+		__m256i s0 = _mm256_load_si256((const __m256i*)state[0]);
+		__m256i s1 = _mm256_load_si256((const __m256i*)state[1]);
+		__m256i s2 = _mm256_load_si256((const __m256i*)state[2]);
+		__m256i s3 = _mm256_load_si256((const __m256i*)state[3]);
+
+		const __m256i exponent = _mm256_set1_epi32(0x3f800000);
+		const __m256 one = _mm256_set1_ps(1.0f);
+
+		for (; i + blockSize <= count; i += blockSize)
+		{
+			const __m256i bits = _mm256_or_si256(_mm256_srli_epi32(Step(s0, s1, s2, s3), 9), exponent);
+			_mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_castsi256_ps(bits), one));
+		}
+
+		_mm256_store_si256((__m256i*)state[0], s0);
+		_mm256_store_si256((__m256i*)state[1], s1);
+		_mm256_store_si256((__m256i*)state[2], s2);
+		_mm256_store_si256((__m256i*)state[3], s3);
+#endif
+
+		uint64_t block[Lanes];
+		for (; i < count; i += blockSize)
+		{
+			Next(block);
+			for (size_t j = 0; j < blockSize && i + j < count; j++)
+			{
+				const uint64_t word = block[j / 2];
+				out[i + j] = ToFloat(uint32_t((j & 1) ? word >> 32 : word));
+			}
+		}
+	}
+
+	void BulkRandom::FillVector3(Real* x, Real* y, Real* z, size_t count, Real min, Real max)
+	{
+		Fill(x, count);
+		Fill(y, count);
+		Fill(z, count);
+
+		const Real scale = max - min;
+		for (size_t i = 0; i < count; i++)
+		{
+			x[i] = min + scale * x[i];
+			y[i] = min + scale * y[i];
+			z[i] = min + scale * z[i];
+		}
+	}
+
+	void BulkRandom::FillUnitVector3(Real* x, Real* y, Real* z, size_t count)
+	{
+		// The two uniform inputs are generated in place of the outputs.
+		Fill(x, count);
+		Fill(y, count);
+		SampleUniformSphere(x, y, x, y, z, count);
+	}
+}
\ No newline at end of file
@@ -4,52 +4,74 @@
 
 namespace Engine
 {
-	Camera::Camera(int imageWidth, double aspectRatio) : imageWidth(imageWidth), aspectRatio(aspectRatio) 
+	template<typename T>
+	CameraT<T>::CameraT(int imageWidth, double aspectRatio) : imageWidth(imageWidth), aspectRatio(aspectRatio) 
 	{
 		Initialize();
 	}
 
-	Ray Camera::GetRay(int x, int y)
+	template<typename T>
+	RayT<T> CameraT<T>::GetRay(int x, int y) const
 	{
-		Vector3 pixelCenter = pixel00Location + (x * pixelDelta_u) + (y * pixelDelta_v);
-		Vector3 rayDirection = (pixelCenter - center);
+		Vector3T<T> pixelCenter = pixel00Location + (x * pixelDelta_u) + (y * pixelDelta_v);
+		Vector3T<T> rayDirection = (pixelCenter - center);
 		
-		return Ray(center, rayDirection);
+		return RayT<T>(center, rayDirection);
 	}
 
-	Ray Camera::GetJitteredRay(int x, int y)
+	template<typename T>
+	RayT<T> CameraT<T>::GetRay(int x, int y, double u, double v) const
 	{
-		Vector3 offset = Vector3(Random::Get()->RandomDouble() - 0.5, Random::Get()->RandomDouble() - 0.5, 0.0);
+		Vector3T<T> target = pixel00Location + 
+			(T(x) + T(u - 0.5)) * pixelDelta_u + 
+			(T(y) + T(v - 0.5)) * pixelDelta_v;
 
-		Vector3 target = pixel00Location + 
-			(double(x) + offset.x) * pixelDelta_u + 
-			(double(y) + offset.y) * pixelDelta_v;
+		return RayT<T>(center, Vector3T<T>::Normalize(target - center));
+	}
+
+	template<typename T>
+	RayT<T> CameraT<T>::GetJitteredRay(int x, int y, Random& random) const
+	{
+		const double u = random.RandomDouble();
+		const double v = random.RandomDouble();
+
+		return GetRay(x, y, u, v);
+	}
+
+	template<typename T>
+	RayT<T> CameraT<T>::GetJitteredRay(int x, int y, Sampler& sampler) const
+	{
+		const Vector2 jitter = sampler.Get2D();
 
-		return Ray(center, Vector3::Normalize(target - center));
+		return GetRay(x, y, jitter.x, jitter.y);
 	}
 
-	void Camera::Initialize()
+	template<typename T>
+	void CameraT<T>::Initialize()
 	{
 		imageHeight = int(imageWidth / aspectRatio);
 		imageHeight = (imageHeight < 1) ? 1 : imageHeight;
 
-		center = Vector3(0.0, 0.0, 0.0);
+		center = Vector3T<T>(0.0, 0.0, 0.0);
 
 		// Determine viewport dimensions.
-		const double focalLength = 1.0;
-		const double viewportHeight = 2.0;
-		const double viewportWidth = viewportHeight * (double(imageWidth) / imageHeight);
+		const T focalLength = 1;
+		const T viewportHeight = 2;
+		const T viewportWidth = viewportHeight * (T(imageWidth) / T(imageHeight));
 
 		// Calculate the vectors across the horizontal and down the vertical viewport edges.
-		const Vector3 viewport_u(viewportWidth, 0.0, 0.0);
-		const Vector3 viewport_v(0.0, -viewportHeight, 0.0);
+		const Vector3T<T> viewport_u(viewportWidth, 0.0, 0.0);
+		const Vector3T<T> viewport_v(0.0, -viewportHeight, 0.0);
 
 		// Calculate the horizontal and vertical delta vectors from pixel to pixel.
 		pixelDelta_u = viewport_u / imageWidth;
 		pixelDelta_v = viewport_v / imageHeight;
 
 		// Calculate the location of the upper left pixel.
-		const Vector3 viewportUpperLeft = center - Vector3(0.0, 0.0, focalLength) - (viewport_u / 2) - (viewport_v / 2);
+		const Vector3T<T> viewportUpperLeft = center - Vector3T<T>(0.0, 0.0, focalLength) - (viewport_u / 2) - (viewport_v / 2);
 		pixel00Location = viewportUpperLeft + 0.5 * (pixelDelta_u + pixelDelta_v);
 	}
+
+	template class CameraT<float>;
+	template class CameraT<double>;
 }
\ No newline at end of file
@@ -4,28 +4,55 @@
 #include "Ray.h"
 #include "Hittable.h"
 #include "Random.h"
+#include "Sampler.h"
 
 namespace Engine
 {
-	class Camera
+	/**
+	 * @class CameraT
+	 * @brief Pinhole camera generating primary rays in the scalar type 'T'.
+	 *
+	 * Instantiated for float and double (see Camera.cpp); the renderer uses
+	 * the 'Camera' alias of type Real.
+	 */
+	template<typename T>
+	class CameraT
 	{
 	public:
 
-		Camera() = delete;
-		Camera(int imageWidth, double aspectRatio);
+		CameraT() = delete;
+		CameraT(int imageWidth, double aspectRatio);
 
-		Ray GetRay(int x, int y);
-		Ray GetJitteredRay(int x, int y);
+		RayT<T> GetRay(int x, int y) const;
+
+		/** @brief Returns a ray through position (u, v) in [0, 1)^2 of pixel (x, y); (0.5, 0.5) is its centre. */
+		RayT<T> GetRay(int x, int y, double u, double v) const;
+
+		/**
+		 * @brief Returns a ray through a uniformly jittered position within pixel (x, y).
+		 * @param random Generator owned by the calling thread.
+		 */
+		RayT<T> GetJitteredRay(int x, int y, Random& random) const;
+
+		/** @brief Returns a ray through pixel (x, y) jittered by the sampler's current 2D dimension. */
+		RayT<T> GetJitteredRay(int x, int y, Sampler& sampler) const;
+
+		int ImageWidth() const { return imageWidth; }
+		int ImageHeight() const { return imageHeight; }
 
 	private:
 
 		double aspectRatio;
 		int imageWidth, imageHeight;
-		Vector3 center;
-		Vector3 pixel00Location;
-		Vector3 pixelDelta_u;
-		Vector3 pixelDelta_v;
+		Vector3T<T> center;
+		Vector3T<T> pixel00Location;
+		Vector3T<T> pixelDelta_u;
+		Vector3T<T> pixelDelta_v;
 
 		void Initialize();
 	};
+
+	using Cameraf = CameraT<float>;
+	using Camerad = CameraT<double>;
+	using Camera = CameraT<Real>;
 }
\ No newline at end of file
@@ -0,0 +1,472 @@
+#include "pch.h"
+
+#include "GridAccelerator.h"
+#include "ThreadPool.h"
+
+namespace Engine
+{
+	namespace
+	{
+		/// Primitives or cells per parallel task.
+		constexpr size_t ParallelGrain = size_t(1) << 14;
+
+		/// Boxes are widened by this fraction of a cell before binning, so rounding in the DDA never misses a cell a primitive touches.
+		constexpr Real CellPadding = Real(1e-3);
+
+		/// Number of recently tested primitives a ray remembers, so one overlapping several cells is tested once.
+		constexpr int MailboxSize = 8;
+
+		/** @brief Runs 'function' over [0, count) in chunks aligned to 'grain', on 'pool' if there is one. */
+		void ForEachChunk(ThreadPool* pool, size_t count, size_t grain, const std::function<void(size_t, size_t)>& function)
+		{
+			if (pool && count > grain)
+			{
+				pool->ParallelFor(count, grain, function);
+				return;
+			}
+
+			for (size_t begin = 0; begin < count; begin += grain)
+			{
+				function(begin, std::min(begin + grain, count));
+			}
+		}
+
+		/**
+		 * @brief Turns counts stored one slot ahead ('values[c + 1]' for item c, 'values[0]' zero) into start offsets.
+		 *
+		 * Each chunk is summed in place, then offset by the sums of the chunks before it.
+		 */
+		void PrefixSum(ThreadPool* pool, std::vector<uint32_t>& values)
+		{
+			const size_t count = values.size() - 1;
+			const size_t chunks = (count + ParallelGrain - 1) / ParallelGrain;
+			std::vector<uint32_t> chunkOffsets(chunks + 1, 0);
+
+			ForEachChunk(pool, count, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					uint32_t sum = 0;
+					for (size_t i = begin; i < end; i++)
+					{
+						sum += values[i + 1];
+						values[i + 1] = sum;
+					}
+
+					chunkOffsets[begin / ParallelGrain + 1] = sum;
+				});
+
+			for (size_t chunk = 0; chunk < chunks; chunk++)
+			{
+				chunkOffsets[chunk + 1] += chunkOffsets[chunk];
+			}
+
+			ForEachChunk(pool, count, ParallelGrain, [&](size_t begin, size_t end)
+				{
+					const uint32_t offset = chunkOffsets[begin / ParallelGrain];
+					for (size_t i = begin; i < end; i++)
+					{
+						values[i + 1] += offset;
+					}
+				});
+		}
+
+		/** @brief Primitives a ray has already tested, in a small ring. */
+		struct Mailbox
+		{
+			uint32_t handles[MailboxSize];
+			int next = 0;
+
+			Mailbox()
+			{
+				std::fill(std::begin(handles), std::end(handles), std::numeric_limits<uint32_t>::max());
+			}
+
+			/** @brief Returns true if 'handle' was tested already, and remembers it otherwise. */
+			bool Contains(uint32_t handle)
+			{
+				for (const uint32_t tested : handles)
+				{
+					if (tested == handle)
+					{
+						return true;
+					}
+				}
+
+				handles[next] = handle;
+				next = (next + 1) % MailboxSize;
+
+				return false;
+			}
+		};
+	}
+
+	GridAccelerator::GridAccelerator(const HittableList& list, const GridBuildOptions& options) :
+		options(options)
+	{
+		Build(list.objects);
+	}
+
+	GridAccelerator::GridAccelerator(const std::vector<std::shared_ptr<Hittable>>& objects, const GridBuildOptions& options) :
+		options(options)
+	{
+		Build(objects);
+	}
+
+	void GridAccelerator::Update(const HittableList& list)
+	{
+		Update(list.objects);
+	}
+
+	void GridAccelerator::Update(const std::vector<std::shared_ptr<Hittable>>& objects)
+	{
+		if (objects.size() != handles.size())
+		{
+			throw std::invalid_argument("GridAccelerator::Update requires the objects the grid was built from!");
+		}
+
+		Build(objects);
+	}
+
+	void GridAccelerator::Build(const std::vector<std::shared_ptr<Hittable>>& objects)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		const size_t count = objects.size();
+
+		primitives.Clear();
+		handles.resize(count);
+		primitiveBounds.resize(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			handles[i] = primitives.Add(objects[i]);
+			primitiveBounds[i] = objects[i]->BoundingBox();
+		}
+
+		stats = GridBuildStats();
+		stats.primitiveCount = count;
+
+		if (count == 0)
+		{
+			bounds = AABB();
+			std::fill(std::begin(resolution), std::end(resolution), 0);
+			cellStart.clear();
+			references.clear();
+			return;
+		}
+
+		// Bounds of the scene and summed extents of the primitives, reduced per chunk.
+		const size_t chunks = (count + ParallelGrain - 1) / ParallelGrain;
+		std::vector<AABB> chunkBounds(chunks);
+		std::vector<Vector3> chunkExtents(chunks);
+
+		ForEachChunk(options.pool, count, ParallelGrain, [&](size_t begin, size_t end)
+			{
+				AABB box;
+				Vector3 extents;
+				for (size_t i = begin; i < end; i++)
+				{
+					box.Grow(primitiveBounds[i]);
+					extents += primitiveBounds[i].Max() - primitiveBounds[i].Min();
+				}
+
+				chunkBounds[begin / ParallelGrain] = box;
+				chunkExtents[begin / ParallelGrain] = extents;
+			});
+
+		bounds = AABB();
+		Vector3 meanExtent;
+		for (size_t chunk = 0; chunk < chunks; chunk++)
+		{
+			bounds.Grow(chunkBounds[chunk]);
+			meanExtent += chunkExtents[chunk];
+		}
+
+		ChooseResolution(count, meanExtent / Real(count));
+
+		const size_t cellCount = size_t(resolution[0]) * resolution[1] * resolution[2];
+
+		// First a counting sort of the primitives by the cell of their lowest
+		// corner. The passes below then read them in order and fill
+		// neighbouring cells in turn, instead of touching the whole grid for
+		// every primitive.
+		firstCells.resize(count);
+		cellStart.assign(cellCount + 1, 0);
+
+		ForEachChunk(options.pool, count, ParallelGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const CellRange range = Cells(primitiveBounds[i]);
+					firstCells[i] = CellIndex(range.min[0], range.min[1], range.min[2]);
+					std::atomic_ref<uint32_t>(cellStart[firstCells[i] + 1]).fetch_add(1, std::memory_order_relaxed);
+				}
+			});
+
+		PrefixSum(options.pool, cellStart);
+		cursor.assign(cellStart.begin(), cellStart.end() - 1);
+		sortedBounds.resize(count);
+		sortedHandles.resize(count);
+
+		ForEachChunk(options.pool, count, ParallelGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const uint32_t slot = std::atomic_ref<uint32_t>(cursor[firstCells[i]]).fetch_add(1, std::memory_order_relaxed);
+					sortedBounds[slot] = primitiveBounds[i];
+					sortedHandles[slot] = handles[i];
+				}
+			});
+
+		// Then the counting sort of the references: count the entries of every cell, turn the counts into offsets, scatter.
+		cellStart.assign(cellCount + 1, 0);
+
+		ForEachChunk(options.pool, count, ParallelGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					ForEachCell(Cells(sortedBounds[i]), [&](uint32_t cell)
+						{
+							std::atomic_ref<uint32_t>(cellStart[cell + 1]).fetch_add(1, std::memory_order_relaxed);
+						});
+				}
+			});
+
+		PrefixSum(options.pool, cellStart);
+		cursor.assign(cellStart.begin(), cellStart.end() - 1);
+		references.resize(cellStart[cellCount]);
+
+		ForEachChunk(options.pool, count, ParallelGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					ForEachCell(Cells(sortedBounds[i]), [&](uint32_t cell)
+						{
+							references[std::atomic_ref<uint32_t>(cursor[cell]).fetch_add(1, std::memory_order_relaxed)] = sortedHandles[i];
+						});
+				}
+			});
+
+		// Threads scatter into a cell in any order; sorting each cell makes the grid, and so every hit, independent of the pool.
+		ForEachChunk(options.pool, cellCount, ParallelGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t c = begin; c < end; c++)
+				{
+					std::sort(references.begin() + cellStart[c], references.begin() + cellStart[c + 1]);
+				}
+			});
+
+		stats.cellCount = cellCount;
+		stats.referenceCount = references.size();
+		std::copy(std::begin(resolution), std::end(resolution), stats.resolution);
+		stats.buildTimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void GridAccelerator::ChooseResolution(size_t primitiveCount, const Vector3& meanExtent)
+	{
+		// Pad the bounds so no axis is empty and primitives on the boundary stay inside.
+		const Vector3 extent = bounds.Max() - bounds.Min();
+		const Real maxExtent = std::max({ extent.x, extent.y, extent.z });
+		const Real padding = std::max(maxExtent, Real(1)) * Real(1e-5);
+
+		bounds = AABB(bounds.Min() - Vector3(padding, padding, padding), bounds.Max() + Vector3(padding, padding, padding));
+
+		// Cells per unit length so that the axes the scene spans hold 'density' cells per
+		// primitive; a flat scene is gridded in two dimensions only (Cleary and Wyvill 1988).
+		double spanned = 1.0;
+		int dimensions = 0;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const double size = bounds.Axis(axis).Size();
+			if (size > 1e-3 * maxExtent)
+			{
+				spanned *= size;
+				dimensions++;
+			}
+		}
+
+		const double cellsPerLength = std::pow(options.density * double(primitiveCount) / spanned, 1.0 / std::max(dimensions, 1));
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const double size = bounds.Axis(axis).Size();
+
+			// Much narrower cells than primitives only copy each primitive into more cells;
+			// overlapping particles would otherwise be referenced a hundred times each.
+			double cells = size * cellsPerLength;
+			if (meanExtent.data[axis] > 0)
+			{
+				cells = std::min(cells, size / (options.minCellExtent * meanExtent.data[axis]));
+			}
+
+			resolution[axis] = int(std::clamp(std::round(cells), 1.0, double(std::max(options.maxResolution, 1))));
+			cellSize[axis] = Real(size / resolution[axis]);
+			inverseCellSize[axis] = Real(resolution[axis] / size);
+		}
+	}
+
+	GridAccelerator::CellRange GridAccelerator::Cells(const AABB& box) const
+	{
+		CellRange range;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const Interval& grid = bounds.Axis(axis);
+			const Interval& extent = box.Axis(axis);
+
+			const Real lower = (extent.min - grid.min) * inverseCellSize[axis] - CellPadding;
+			const Real upper = (extent.max - grid.min) * inverseCellSize[axis] + CellPadding;
+
+			range.min[axis] = std::clamp(int(std::floor(lower)), 0, resolution[axis] - 1);
+			range.max[axis] = std::clamp(int(std::floor(upper)), 0, resolution[axis] - 1);
+		}
+
+		return range;
+	}
+
+	template<typename CellFunction>
+	void GridAccelerator::Walk(const Ray& ray, Real tMin, const Real& tMax, CellFunction&& visitCell) const
+	{
+		const Vector3 invDirection(1 / ray.direction.x, 1 / ray.direction.y, 1 / ray.direction.z);
+
+		Real tEntry;
+		if (references.empty() || !bounds.Hit(ray.origin, invDirection, tMin, tMax, tEntry))
+		{
+			return;
+		}
+
+		int cell[3], step[3], limit[3];
+		Real next[3], delta[3];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const Real origin = ray.origin.data[axis];
+			const Real direction = ray.direction.data[axis];
+			const Real gridMin = bounds.Axis(axis).min;
+
+			cell[axis] = std::clamp(int(std::floor((origin + tEntry * direction - gridMin) * inverseCellSize[axis])), 0, resolution[axis] - 1);
+
+			if (direction > 0)
+			{
+				step[axis] = 1;
+				limit[axis] = resolution[axis];
+				next[axis] = (gridMin + (cell[axis] + 1) * cellSize[axis] - origin) * invDirection.data[axis];
+				delta[axis] = cellSize[axis] * invDirection.data[axis];
+			}
+			else if (direction < 0)
+			{
+				step[axis] = -1;
+				limit[axis] = -1;
+				next[axis] = (gridMin + cell[axis] * cellSize[axis] - origin) * invDirection.data[axis];
+				delta[axis] = -cellSize[axis] * invDirection.data[axis];
+			}
+			else
+			{
+				step[axis] = 0;
+				limit[axis] = -1;
+				next[axis] = std::numeric_limits<Real>::infinity();
+				delta[axis] = 0;
+			}
+		}
+
+		for (;;)
+		{
+			const int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+			const uint32_t index = CellIndex(cell[0], cell[1], cell[2]);
+
+			if (visitCell(cellStart[index], cellStart[index + 1], next[axis]) || next[axis] > tMax)
+			{
+				return;
+			}
+
+			cell[axis] += step[axis];
+			if (cell[axis] == limit[axis])
+			{
+				return;
+			}
+
+			next[axis] += delta[axis];
+		}
+	}
+
+	bool GridAccelerator::Hit(const Ray& ray, Interval ray_t, HitRecord& record) const
+	{
+		Mailbox mailbox;
+		Real closestSoFar = ray_t.max;
+		bool hitAnything = false;
+
+		Walk(ray, ray_t.min, closestSoFar, [&](uint32_t first, uint32_t last, Real cellExit)
+			{
+				for (uint32_t i = first; i < last; i++)
+				{
+					const uint32_t handle = references[i];
+
+					// An earlier test over a longer interval already found this primitive's closest hit.
+					if (!mailbox.Contains(handle) && primitives.Hit(handle, ray, Interval(ray_t.min, closestSoFar), record))
+					{
+						hitAnything = true;
+						closestSoFar = record.t;
+					}
+				}
+
+				// Cells further along cannot hold a hit closer than one inside this cell.
+				return hitAnything && closestSoFar <= cellExit;
+			});
+
+		return hitAnything;
+	}
+
+	bool GridAccelerator::Occluded(const Ray& ray, Interval ray_t) const
+	{
+		Mailbox mailbox;
+		bool occluded = false;
+
+		Walk(ray, ray_t.min, ray_t.max, [&](uint32_t first, uint32_t last, Real)
+			{
+				for (uint32_t i = first; i < last && !occluded; i++)
+				{
+					const uint32_t handle = references[i];
+					occluded = !mailbox.Contains(handle) && primitives.Occluded(handle, ray, ray_t);
+				}
+
+				return occluded;
+			});
+
+		return occluded;
+	}
+
+	bool GridAccelerator::SuitedTo(const std::vector<AABB>& primitiveBounds, double maxSizeVariation)
+	{
+		if (primitiveBounds.empty())
+		{
+			return false;
+		}
+
+		double sum = 0.0;
+		double sumSquares = 0.0;
+
+		for (const AABB& box : primitiveBounds)
+		{
+			const double size = (box.Max() - box.Min()).Length();
+			sum += size;
+			sumSquares += size * size;
+		}
+
+		const double mean = sum / primitiveBounds.size();
+		const double variance = std::max(sumSquares / primitiveBounds.size() - mean * mean, 0.0);
+
+		return mean > 0.0 && std::sqrt(variance) <= maxSizeVariation * mean;
+	}
+
+	bool GridAccelerator::SuitedTo(const HittableList& list, double maxSizeVariation)
+	{
+		std::vector<AABB> primitiveBounds;
+		primitiveBounds.reserve(list.objects.size());
+
+		for (const auto& object : list.objects)
+		{
+			primitiveBounds.push_back(object->BoundingBox());
+		}
+
+		return SuitedTo(primitiveBounds, maxSizeVariation);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Hittable.h"
+#include "HittableList.h"
+#include "PrimitiveStore.h"
+
+namespace Engine
+{
+	class ThreadPool;
+
+	/** @brief Parameters of a GridAccelerator build. */
+	struct GridBuildOptions
+	{
+		double density = 1.0;		  ///< Target number of cells per primitive.
+		int maxResolution = 1024;	  ///< Upper bound on the cells along each axis.
+
+		/// Lower bound on a cell's edge, in mean primitive extents along that axis. At one half a
+		/// primitive overlaps about three cells per axis, however large the primitives grow.
+		double minCellExtent = 0.5;
+
+		/// Pool that runs the build, or null to build on the calling thread. Must outlive every build using these options.
+		ThreadPool* pool = nullptr;
+	};
+
+	/** @brief Statistics gathered while building a GridAccelerator. */
+	struct GridBuildStats
+	{
+		double buildTimeMs = 0.0;
+		size_t primitiveCount = 0;
+		size_t cellCount = 0;
+		size_t referenceCount = 0; ///< Cell entries; a primitive has one per cell its box overlaps.
+		int resolution[3] = { 0, 0, 0 };
+
+		double ReferencesPerPrimitive() const { return primitiveCount ? double(referenceCount) / primitiveCount : 0.0; }
+	};
+
+	/**
+	 * @class GridAccelerator
+	 * @brief Uniform grid over a list of Hittable objects, an alternative to BVH for evenly spread primitives of similar size.
+	 *
+	 * Every cell lists the primitives whose boxes overlap it. A build is a
+	 * counting sort of (cell, primitive) pairs: count the entries of every
+	 * cell, prefix-sum the counts into offsets, then scatter. Each pass is
+	 * parallel over primitives or cells and the whole build is O(n), so a
+	 * grid can be rebuilt every frame for animated particles.
+	 *
+	 * Rays walk the cells they pierce in order with the 3D-DDA of Amanatides
+	 * and Woo, "A Fast Voxel Traversal Algorithm for Ray Tracing" (1987),
+	 * and stop at the first cell that holds a hit. Large or unevenly sized
+	 * primitives overlap many cells or leave most cells empty; SuitedTo()
+	 * tells those scenes apart so they keep a BVH.
+	 */
+	class GridAccelerator : public Hittable
+	{
+	public:
+
+		/// Coefficient of variation of primitive sizes up to which SuitedTo() prefers a grid.
+		static constexpr double DefaultMaxSizeVariation = 0.25;
+
+		GridAccelerator(const HittableList& list, const GridBuildOptions& options = GridBuildOptions());
+		GridAccelerator(const std::vector<std::shared_ptr<Hittable>>& objects, const GridBuildOptions& options = GridBuildOptions());
+
+		/**
+		 * @brief Rebuilds the grid after its objects moved, reusing its memory.
+		 *
+		 * 'objects' must be the list the grid was built from, in the same
+		 * order; only their positions may have changed.
+		 */
+		void Update(const HittableList& list);
+		void Update(const std::vector<std::shared_ptr<Hittable>>& objects);
+
+		bool Hit(const Ray& ray, Interval ray_t, HitRecord& record) const override;
+		bool Occluded(const Ray& ray, Interval ray_t) const override;
+
+		AABB BoundingBox() const override { return bounds; }
+
+		const GridBuildStats& BuildStats() const { return stats; }
+
+		/**
+		 * @brief Returns true if a grid should trace primitives with these boxes better than a BVH.
+		 *
+		 * A grid pays off when primitives are about the same size, so cells can
+		 * be sized to them. The size of a primitive is the diagonal of its box;
+		 * a grid is preferred if the standard deviation of the sizes is at most
+		 * 'maxSizeVariation' times their mean.
+		 */
+		static bool SuitedTo(const std::vector<AABB>& primitiveBounds, double maxSizeVariation = DefaultMaxSizeVariation);
+		static bool SuitedTo(const HittableList& list, double maxSizeVariation = DefaultMaxSizeVariation);
+
+	private:
+
+		/** @brief Inclusive range of cells overlapped by a box. */
+		struct CellRange
+		{
+			int min[3];
+			int max[3];
+		};
+
+		GridBuildOptions options;
+		GridBuildStats stats;
+
+		PrimitiveStore primitives;
+		std::vector<uint32_t> handles; ///< Primitive handles in the order of the objects.
+		std::vector<AABB> primitiveBounds;
+
+		AABB bounds;
+		int resolution[3] = { 0, 0, 0 };
+		Real cellSize[3] = { 0, 0, 0 };
+		Real inverseCellSize[3] = { 0, 0, 0 };
+
+		std::vector<uint32_t> cellStart;  ///< References of cell c are [cellStart[c], cellStart[c + 1]).
+		std::vector<uint32_t> references; ///< Primitive handles, grouped by cell.
+
+		// Scratch arrays of Build(), kept so that rebuilding every frame does not reallocate.
+		std::vector<uint32_t> firstCells;
+		std::vector<AABB> sortedBounds;
+		std::vector<uint32_t> sortedHandles;
+		std::vector<uint32_t> cursor;
+
+		void Build(const std::vector<std::shared_ptr<Hittable>>& objects);
+
+		/** @brief Chooses the resolution from the bounds, the primitive count and the mean extent of a primitive's box. */
+		void ChooseResolution(size_t primitiveCount, const Vector3& meanExtent);
+
+		CellRange Cells(const AABB& box) const;
+
+		uint32_t CellIndex(int x, int y, int z) const { return uint32_t((size_t(z) * resolution[1] + y) * resolution[0] + x); }
+
+		template<typename Function>
+		void ForEachCell(const CellRange& range, Function&& function) const
+		{
+			for (int z = range.min[2]; z <= range.max[2]; z++)
+			{
+				for (int y = range.min[1]; y <= range.max[1]; y++)
+				{
+					for (int x = range.min[0]; x <= range.max[0]; x++)
+					{
+						function(CellIndex(x, y, z));
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Walks the cells pierced by 'ray' in order.
+		 *
+		 * 'visitCell(first, last, cellExit)' receives the reference range of a
+		 * cell and the distance at which the ray leaves it, and returns true to
+		 * stop. The walk also stops once 'tMax', which the visitor may shrink,
+		 * lies inside the current cell.
+		 */
+		template<typename CellFunction>
+		void Walk(const Ray& ray, Real tMin, const Real& tMax, CellFunction&& visitCell) const;
+	};
+}
\ No newline at end of file
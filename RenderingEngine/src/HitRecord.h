@@ -5,16 +5,14 @@
 
 namespace Engine
 {
-	class Material;
-
 	class HitRecord
 	{
 	public:
 
 		Vector3 p;
 		Vector3 N;
-		std::shared_ptr<Material> mat;
-		double t;
+		Real t;
+		uint32_t materialId = 0; ///< Index into the scene's MaterialTable.
 		bool frontFace;
 
 		void SetFaceNormal(const Ray& ray, const Vector3& outwardNormal)
@@ -4,6 +4,8 @@
 #include "Ray.h"
 #include "HitRecord.h"
 #include "Interval.h"
+#include "AABB.h"
+#include "RayPacket.h"
 
 namespace Engine
 {
@@ -13,5 +15,66 @@ namespace Engine
 
 		virtual ~Hittable() = default;
 		virtual bool Hit(const Ray& ray, Interval ray_t, HitRecord& record) const = 0;
+		virtual AABB BoundingBox() const = 0;
+
+		/**
+		 * @brief Any-hit query: returns true if anything blocks the ray within 'ray_t'.
+		 *
+		 * Shadow rays only need a yes or no, so implementations stop at the
+		 * first intersection they find and never fill a HitRecord. The
+		 * default falls back to a closest-hit query.
+		 */
+		virtual bool Occluded(const Ray& ray, Interval ray_t) const
+		{
+			HitRecord record;
+			return Hit(ray, ray_t, record);
+		}
+
+		/**
+		 * @brief Closest-hit query for a subset of the rays in a packet.
+		 *
+		 * Each listed ray is tested over [tMin, result.tMax[i]] and its entry in
+		 * 'result' is updated when a closer hit is found. The default
+		 * implementation traces the rays one at a time; primitives and
+		 * accelerators override it to share work across the packet.
+		 *
+		 * @param packet The rays.
+		 * @param tMin Start of the parametric range shared by all rays.
+		 * @param indices Indices of the rays to test.
+		 * @param count Number of entries in 'indices'.
+		 * @param result Per-ray closest hits found so far.
+		 */
+		virtual void HitPacket(const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const
+		{
+			HitRecord record;
+			for (int k = 0; k < count; k++)
+			{
+				const int i = indices[k];
+				if (Hit(packet.Get(i), Interval(tMin, result.tMax[i]), record))
+				{
+					result.hit[i] = true;
+					result.tMax[i] = record.t;
+					result.records[i] = record;
+				}
+			}
+		}
+
+		/**
+		 * @brief Closest-hit query for every ray in a packet.
+		 * @param packet The rays.
+		 * @param ray_t Parametric range shared by all rays.
+		 * @param result Receives one closest hit per ray.
+		 */
+		void TracePacket(const RayPacket& packet, Interval ray_t, PacketHit& result) const
+		{
+			uint8_t indices[RayPacket::MaxSize];
+			for (int i = 0; i < packet.size; i++)
+			{
+				indices[i] = uint8_t(i);
+			}
+
+			result.Reset(packet.size, ray_t);
+			HitPacket(packet, ray_t.min, indices, packet.size, result);
+		}
 	};
 }
\ No newline at end of file
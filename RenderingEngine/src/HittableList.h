@@ -16,10 +16,15 @@ namespace Engine
 		HittableList() {}
 		HittableList(std::shared_ptr<Hittable> object) { Add(object); }
 
-		void Clear() { objects.clear(); }
+		void Clear()
+		{
+			objects.clear();
+			bbox = AABB();
+		}
 
 		void Add(std::shared_ptr<Hittable> object)
 		{
+			bbox = AABB(bbox, object->BoundingBox());
 			objects.push_back(object);
 		}
 
@@ -42,5 +47,32 @@ namespace Engine
 
 			return hitAnything;
 		}
+
+		void HitPacket(const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const override
+		{
+			for (const auto& object : objects)
+			{
+				object->HitPacket(packet, tMin, indices, count, result);
+			}
+		}
+
+		bool Occluded(const Ray& ray, Interval ray_t) const override
+		{
+			for (const auto& object : objects)
+			{
+				if (object->Occluded(ray, ray_t))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		AABB BoundingBox() const override { return bbox; }
+
+	private:
+
+		AABB bbox;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "pch.h"
+
+#include "Instance.h"
+
+namespace Engine
+{
+	namespace
+	{
+		template<typename Matrix>
+		Vector3 TransformPoint(const Matrix& m, const Vector3& p)
+		{
+			return Vector3(
+				Real(m[0][0] * p.x + m[1][0] * p.y + m[2][0] * p.z + m[3][0]),
+				Real(m[0][1] * p.x + m[1][1] * p.y + m[2][1] * p.z + m[3][1]),
+				Real(m[0][2] * p.x + m[1][2] * p.y + m[2][2] * p.z + m[3][2]));
+		}
+
+		template<typename Matrix>
+		Vector3 TransformVector(const Matrix& m, const Vector3& v)
+		{
+			return Vector3(
+				Real(m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z),
+				Real(m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z),
+				Real(m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z));
+		}
+	}
+
+	Instance::Instance(std::shared_ptr<const Hittable> blas, const glm::dmat4& objectToWorld) :
+		blas(std::move(blas))
+	{
+		if (!this->blas)
+		{
+			throw std::invalid_argument("Instance requires bottom-level geometry!");
+		}
+
+		SetTransform(objectToWorld);
+	}
+
+	void Instance::SetTransform(const glm::dmat4& objectToWorld)
+	{
+		this->objectToWorld = objectToWorld;
+
+		const glm::dmat4 inverse = glm::inverse(objectToWorld);
+
+		worldToObject = Matrix4(inverse);
+		normalToWorld = Matrix3(glm::transpose(glm::dmat3(inverse)));
+
+		// Bound the transformed corners of the object-space box.
+		const AABB objectBox = blas->BoundingBox();
+
+		bbox = AABB();
+		for (int corner = 0; corner < 8; corner++)
+		{
+			const Vector3 p((corner & 1) ? objectBox.x.max : objectBox.x.min,
+				(corner & 2) ? objectBox.y.max : objectBox.y.min,
+				(corner & 4) ? objectBox.z.max : objectBox.z.min);
+
+			bbox.Grow(TransformPoint(objectToWorld, p));
+		}
+	}
+
+	bool Instance::Hit(const Ray& ray, Interval ray_t, HitRecord& record) const
+	{
+		const Ray objectRay = ToObject(ray);
+
+		if (!blas->Hit(objectRay, ray_t, record))
+		{
+			return false;
+		}
+
+		// The normal already faces against the object-space ray, and the
+		// inverse transpose preserves that, so 'frontFace' stays valid.
+		record.p = ray.At(record.t);
+		record.N = Vector3::Normalize(TransformVector(normalToWorld, record.N));
+
+		return true;
+	}
+
+	bool Instance::Occluded(const Ray& ray, Interval ray_t) const
+	{
+		return blas->Occluded(ToObject(ray), ray_t);
+	}
+
+	Ray Instance::ToObject(const Ray& ray) const
+	{
+		return Ray(TransformPoint(worldToObject, ray.origin), TransformVector(worldToObject, ray.direction));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "pch.h"
+
+#include "glm/glm.hpp"
+
+#include "Hittable.h"
+
+namespace Engine
+{
+	/**
+	 * @class Instance
+	 * @brief A transformed reference to shared bottom-level geometry.
+	 *
+	 * The CPU counterpart of a D3D12_RAYTRACING_INSTANCE_DESC: the geometry
+	 * (usually a TriangleMesh or BVH, the BLAS) is built once in object space
+	 * and shared by any number of instances, each adding only a transform.
+	 * A BVH over instances is then the top-level structure (TLAS).
+	 *
+	 * Rays are moved into object space on entry. The direction is not
+	 * renormalized, so hit distances are the same in both spaces and the
+	 * query interval passes through unchanged.
+	 */
+	class Instance final : public Hittable
+	{
+	public:
+
+		using Matrix4 = glm::mat<4, 4, Real>;
+		using Matrix3 = glm::mat<3, 3, Real>;
+
+		/**
+		 * @param blas Object-space geometry, shared between instances.
+		 * @param objectToWorld Affine transform placing the geometry in the world; must be invertible.
+		 */
+		Instance(std::shared_ptr<const Hittable> blas, const glm::dmat4& objectToWorld);
+
+		bool Hit(const Ray& ray, Interval ray_t, HitRecord& record) const override;
+		bool Occluded(const Ray& ray, Interval ray_t) const override;
+		AABB BoundingBox() const override { return bbox; }
+
+		const Hittable& Blas() const { return *blas; }
+		const glm::dmat4& ObjectToWorld() const { return objectToWorld; }
+
+		/**
+		 * @brief Moves the instance. A BVH holding it must be updated afterwards (see BVH::Update).
+		 * @param objectToWorld New affine transform; must be invertible.
+		 */
+		void SetTransform(const glm::dmat4& objectToWorld);
+
+	private:
+
+		std::shared_ptr<const Hittable> blas;
+		glm::dmat4 objectToWorld;
+
+		Matrix4 worldToObject;
+		Matrix3 normalToWorld; ///< Inverse transpose of the linear part of 'objectToWorld'.
+		AABB bbox;
+
+		/** @brief Moves a world-space ray into object space, keeping its parametrization. */
+		Ray ToObject(const Ray& ray) const;
+	};
+}
\ No newline at end of file
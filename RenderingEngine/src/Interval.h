@@ -1,33 +1,43 @@
 #pragma once
 
 #include "pch.h"
+#include "Precision.h"
 
 namespace Engine
 {
-	class Interval
+	template<typename T>
+	class IntervalT
 	{
 	public:
-		double min, max;
+		T min, max;
 
-		//Interval() : min(1000), max(-1000) {}
-		//Interval(double min, double max) : min(min), max(max) {}
+		/** @brief Default constructor. Creates an empty interval. */
+		constexpr IntervalT() : min(+std::numeric_limits<T>::infinity()), max(-std::numeric_limits<T>::infinity()) {}
 
-		double Size() const
+		constexpr IntervalT(T min, T max) : min(min), max(max) {}
+
+		/** @brief Creates the tightest interval enclosing both input intervals. */
+		constexpr IntervalT(const IntervalT& a, const IntervalT& b) : min(a.min <= b.min ? a.min : b.min), max(a.max >= b.max ? a.max : b.max) {}
+
+		static constexpr IntervalT Empty() { return IntervalT(); }
+		static constexpr IntervalT Universe() { return IntervalT(-std::numeric_limits<T>::infinity(), +std::numeric_limits<T>::infinity()); }
+
+		T Size() const
 		{
 			return max - min;
 		}
 
-		bool Contains(double x) const
+		bool Contains(T x) const
 		{
 			return min <= x && x <= max;
 		}
 
-		bool Surrounds(double x) const
+		bool Surrounds(T x) const
 		{
 			return min < x && x < max;
 		}
 
-		double Clamp(double x) const
+		T Clamp(T x) const
 		{
 			if (x < min) return min;
 			if (x > max) return max;
@@ -35,6 +45,15 @@ namespace Engine
 			return x;
 		}
 
-		//static const Interval empty, universe;
+		/** @brief Returns a copy of this interval padded by 'delta' in total. */
+		IntervalT Expand(T delta) const
+		{
+			const T padding = delta / 2;
+			return IntervalT(min - padding, max + padding);
+		}
 	};
+
+	using Intervalf = IntervalT<float>;
+	using Intervald = IntervalT<double>;
+	using Interval = IntervalT<Real>;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Ray.h"
 #include "HitRecord.h"
 #include "Vector3.h"
+#include "Sampling.h"
 
 namespace Engine
 {
@@ -13,11 +14,28 @@ namespace Engine
 
 		Lambertian(const Vector3& albedo) : albedo(albedo) {}
 
-		bool Scatter(const Ray& in, const HitRecord& record, Vector3& attenuation, Ray& scattered) const override
+		bool Scatter(const Ray& in, const HitRecord& record, Sampler& sampler, Vector3& attenuation, Ray& scattered) const override
 		{
+			// Closed-form cosine-weighted bounce, so one 2D sample always yields one direction.
+			const Vector3 direction = ToWorld(SampleCosineHemisphere(sampler.Get2D()), record.N);
+
+			scattered = Ray(record.p, direction);
+			attenuation = albedo;
+
 			return true;
 		}
 
+		Vector3 Evaluate(const Ray& in, const HitRecord& record, const Vector3& direction) const override
+		{
+			const Real cosine = Vector3::Dot(record.N, direction);
+
+			return cosine > 0 ? albedo * (cosine / Real(PI)) : Vector3();
+		}
+
+		Vector3 Albedo(const HitRecord& record) const override { return albedo; }
+
+		const Vector3& Albedo() const { return albedo; }
+
 	private:
 
 		Vector3 albedo;
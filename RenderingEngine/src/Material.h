@@ -2,6 +2,7 @@
 
 #include "Ray.h"
 #include "HitRecord.h"
+#include "Sampler.h"
 
 namespace Engine
 {
@@ -11,9 +12,37 @@ namespace Engine
 
 		virtual ~Material() = default;
 
-		virtual bool Scatter(const Ray& in, const HitRecord& record, Vector3& attenuation, Ray& scattered) const
+		/**
+		 * @brief Samples a continuation ray for a path that hit this material.
+		 * @param in Incoming ray.
+		 * @param record Hit being shaded.
+		 * @param sampler The path's sampler, positioned at the dimensions reserved for scattering.
+		 * @param attenuation Receives the throughput weight of the scattered ray.
+		 * @param scattered Receives the continuation ray.
+		 * @return False if the path is absorbed.
+		 */
+		virtual bool Scatter(const Ray& in, const HitRecord& record, Sampler& sampler, Vector3& attenuation, Ray& scattered) const
 		{
 			return false;
 		}
+
+		/**
+		 * @brief BRDF times cosine for light arriving from a given direction, used for direct lighting.
+		 * @param direction Unit vector from the hit point towards the light.
+		 * @return Zero for materials that only scatter specularly.
+		 */
+		virtual Vector3 Evaluate(const Ray& in, const HitRecord& record, const Vector3& direction) const
+		{
+			return Vector3();
+		}
+
+		/**
+		 * @brief Reflectance at a hit, used as a denoising guide.
+		 * @return Zero for materials that absorb everything.
+		 */
+		virtual Vector3 Albedo(const HitRecord& record) const
+		{
+			return Vector3();
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Material.h"
+
+namespace Engine
+{
+	/**
+	 * @class MaterialTable
+	 * @brief Scene-wide list of materials addressed by HitRecord::materialId.
+	 *
+	 * Primitives store a 32-bit index instead of a shared_ptr, so copying a
+	 * HitRecord during closest-hit search is a plain memory copy. Shading
+	 * looks the material up once per accepted hit.
+	 */
+	class MaterialTable
+	{
+	public:
+
+		/** @brief Adds a material and returns its ID. */
+		uint32_t Add(std::shared_ptr<Material> material)
+		{
+			materials.push_back(std::move(material));
+			return uint32_t(materials.size() - 1);
+		}
+
+		/** @brief Returns the material with the given ID, or nullptr if there is none. */
+		const Material* Get(uint32_t id) const
+		{
+			return id < materials.size() ? materials[id].get() : nullptr;
+		}
+
+		size_t Size() const { return materials.size(); }
+		void Clear() { materials.clear(); }
+
+	private:
+
+		std::vector<std::shared_ptr<Material>> materials;
+	};
+}
\ No newline at end of file
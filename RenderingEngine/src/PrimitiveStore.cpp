@@ -0,0 +1,63 @@
+#include "pch.h"
+
+#include "PrimitiveStore.h"
+
+namespace Engine
+{
+	uint32_t PrimitiveStore::Add(const std::shared_ptr<Hittable>& object)
+	{
+		if (const Sphere* sphere = dynamic_cast<const Sphere*>(object.get()))
+		{
+			spheres.push_back(*sphere);
+			return MakeHandle(PrimitiveType::Sphere, spheres.size() - 1);
+		}
+
+		if (const SphereBatch* batch = dynamic_cast<const SphereBatch*>(object.get()))
+		{
+			sphereBatches.push_back(*batch);
+			return MakeHandle(PrimitiveType::SphereBatch, sphereBatches.size() - 1);
+		}
+
+		if (const Instance* instance = dynamic_cast<const Instance*>(object.get()))
+		{
+			instances.push_back(*instance);
+			return MakeHandle(PrimitiveType::Instance, instances.size() - 1);
+		}
+
+		others.push_back(object);
+		return MakeHandle(PrimitiveType::Other, others.size() - 1);
+	}
+
+	void PrimitiveStore::Clear()
+	{
+		spheres.clear();
+		sphereBatches.clear();
+		instances.clear();
+		others.clear();
+	}
+
+	AABB PrimitiveStore::BoundingBox(uint32_t handle) const
+	{
+		switch (Type(handle))
+		{
+		case PrimitiveType::Sphere:
+			return spheres[Index(handle)].BoundingBox();
+		case PrimitiveType::SphereBatch:
+			return sphereBatches[Index(handle)].BoundingBox();
+		case PrimitiveType::Instance:
+			return instances[Index(handle)].BoundingBox();
+		default:
+			return others[Index(handle)]->BoundingBox();
+		}
+	}
+
+	uint32_t PrimitiveStore::MakeHandle(PrimitiveType type, size_t index)
+	{
+		if (index > IndexMask)
+		{
+			throw std::runtime_error("Too many primitives of one type for a PrimitiveStore handle!");
+		}
+
+		return (uint32_t(type) << IndexBits) | uint32_t(index);
+	}
+}
\ No newline at end of file
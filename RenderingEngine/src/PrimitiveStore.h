@@ -0,0 +1,115 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Hittable.h"
+#include "Sphere.h"
+#include "SphereBatch.h"
+#include "Instance.h"
+
+namespace Engine
+{
+	/** @brief Concrete primitive types held by value in a PrimitiveStore. */
+	enum class PrimitiveType : uint32_t
+	{
+		Sphere,
+		SphereBatch,
+		Instance,
+		Other ///< Any other Hittable, still reached through its vtable.
+	};
+
+	/**
+	 * @class PrimitiveStore
+	 * @brief Flat per-type arrays of primitives addressed by 32-bit handles.
+	 *
+	 * Spheres, sphere batches and instances are copied into contiguous arrays of their
+	 * concrete (final) type, so an intersection is a switch on the handle's
+	 * type bits followed by a statically bound call: no shared_ptr is touched
+	 * and no vtable is loaded. Objects of any other type are kept as they are
+	 * and dispatched virtually.
+	 *
+	 * A handle stores the type in its top 'TypeBits' bits and the index within
+	 * that type's array in the rest.
+	 */
+	class PrimitiveStore
+	{
+	public:
+
+		static constexpr uint32_t TypeBits = 4;
+		static constexpr uint32_t IndexBits = 32 - TypeBits;
+		static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+
+		/**
+		 * @brief Copies a primitive into the array of its type.
+		 * @return Handle of the stored primitive.
+		 */
+		uint32_t Add(const std::shared_ptr<Hittable>& object);
+
+		void Clear();
+
+		size_t Size() const { return spheres.size() + sphereBatches.size() + instances.size() + others.size(); }
+
+		static PrimitiveType Type(uint32_t handle) { return PrimitiveType(handle >> IndexBits); }
+		static uint32_t Index(uint32_t handle) { return handle & IndexMask; }
+
+		bool Hit(uint32_t handle, const Ray& ray, Interval ray_t, HitRecord& record) const
+		{
+			switch (Type(handle))
+			{
+			case PrimitiveType::Sphere:
+				return spheres[Index(handle)].Hit(ray, ray_t, record);
+			case PrimitiveType::SphereBatch:
+				return sphereBatches[Index(handle)].Hit(ray, ray_t, record);
+			case PrimitiveType::Instance:
+				return instances[Index(handle)].Hit(ray, ray_t, record);
+			default:
+				return others[Index(handle)]->Hit(ray, ray_t, record);
+			}
+		}
+
+		void HitPacket(uint32_t handle, const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const
+		{
+			switch (Type(handle))
+			{
+			case PrimitiveType::Sphere:
+				spheres[Index(handle)].HitPacket(packet, tMin, indices, count, result);
+				break;
+			case PrimitiveType::SphereBatch:
+				sphereBatches[Index(handle)].HitPacket(packet, tMin, indices, count, result);
+				break;
+			case PrimitiveType::Instance:
+				instances[Index(handle)].HitPacket(packet, tMin, indices, count, result);
+				break;
+			default:
+				others[Index(handle)]->HitPacket(packet, tMin, indices, count, result);
+				break;
+			}
+		}
+
+		bool Occluded(uint32_t handle, const Ray& ray, Interval ray_t) const
+		{
+			switch (Type(handle))
+			{
+			case PrimitiveType::Sphere:
+				return spheres[Index(handle)].Occluded(ray, ray_t);
+			case PrimitiveType::SphereBatch:
+				return sphereBatches[Index(handle)].Occluded(ray, ray_t);
+			case PrimitiveType::Instance:
+				return instances[Index(handle)].Occluded(ray, ray_t);
+			default:
+				return others[Index(handle)]->Occluded(ray, ray_t);
+			}
+		}
+
+		AABB BoundingBox(uint32_t handle) const;
+
+	private:
+
+		std::vector<Sphere> spheres;
+		std::vector<SphereBatch> sphereBatches;
+		std::vector<Instance> instances;
+		std::vector<std::shared_ptr<Hittable>> others;
+
+		static uint32_t MakeHandle(PrimitiveType type, size_t index);
+	};
+}
\ No newline at end of file
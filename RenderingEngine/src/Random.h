@@ -2,39 +2,91 @@
 
 #include "pch.h"
 #include "Vector3.h"
+#include "Sampling.h"
 
 namespace Engine
 {
+	/**
+	 * @class Random
+	 * @brief Small-state PCG32 random number generator.
+	 *
+	 * The whole state is two 64-bit words, so every worker thread (or every
+	 * pixel sample) can own a generator by value instead of sharing a global
+	 * one. Generators created through ForSample() depend only on the pixel,
+	 * sample index and seed, which makes renders bit-identical regardless of
+	 * how the work is split across threads.
+	 *
+	 * See M.E. O'Neill, "PCG: A Family of Simple Fast Space-Efficient
+	 * Statistically Good Algorithms for Random Number Generation" (2014).
+	 */
 	class Random
 	{
-	private:
+	public:
 
-		static Random* instance;
+		/** @brief Creates a generator with a fixed default seed. */
+		Random() : Random(0x853c49e6748fea9bull, 0xda3e39cb94b95bdbull) {}
 
-		std::mt19937 generator;
-		std::uniform_real_distribution<double> uniformDistribution;
+		/**
+		 * @brief Creates a generator on a given seed and stream.
+		 * @param seed Starting point within the sequence.
+		 * @param stream Selects one of 2^63 independent sequences.
+		 */
+		Random(uint64_t seed, uint64_t stream)
+		{
+			Seed(seed, stream);
+		}
 
-		Random() : generator(std::chrono::system_clock::now().time_since_epoch().count()), uniformDistribution(0.0f, 1.0f) {}
-		~Random() {}
+		/**
+		 * @brief Creates the generator for one sample of one pixel.
+		 * @param x Pixel column.
+		 * @param y Pixel row.
+		 * @param sample Index of the sample within the pixel.
+		 * @param seed Per-render seed.
+		 */
+		static Random ForSample(uint32_t x, uint32_t y, uint32_t sample, uint64_t seed = 0)
+		{
+			const uint64_t pixel = (uint64_t(y) << 32) | x;
 
-	public:
+			return Random(Hash(seed ^ Hash(pixel)) + sample, Hash(pixel + seed));
+		}
+
+		/** @brief 64-bit integer finalizer (SplitMix64), used to decorrelate seeds. */
+		static uint64_t Hash(uint64_t x)
+		{
+			x ^= x >> 30;
+			x *= 0xbf58476d1ce4e5b9ull;
+			x ^= x >> 27;
+			x *= 0x94d049bb133111ebull;
+			x ^= x >> 31;
 
-		Random(const Random&) = delete;
-		Random operator=(const Random&) = delete;
+			return x;
+		}
 
-		static Random* Get()
+		void Seed(uint64_t seed, uint64_t stream)
 		{
-			if (instance == nullptr)
-			{
-				instance = new Random();
-			}
+			state = 0;
+			increment = (stream << 1) | 1;
+			NextUInt();
+			state += seed;
+			NextUInt();
+		}
 
-			return instance;
+		/** @brief Returns the next uniformly distributed 32-bit value. */
+		uint32_t NextUInt()
+		{
+			const uint64_t old = state;
+			state = old * 6364136223846793005ull + increment;
+
+			const uint32_t xorShifted = uint32_t(((old >> 18) ^ old) >> 27);
+			const uint32_t rotation = uint32_t(old >> 59);
+
+			return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1) & 31));
 		}
 
+		/** @brief Returns a uniformly distributed value in [0, 1). */
 		double RandomDouble()
 		{
-			return uniformDistribution(generator);
+			return NextUInt() * (1.0 / 4294967296.0);
 		}
 
 		double RandomDouble(double min, double max)
@@ -44,38 +96,43 @@ namespace Engine
 
 		Vector3 RandomVector3()
 		{
-			return Vector3(RandomDouble(), RandomDouble(), RandomDouble());
+			return Vector3(Real(RandomDouble()), Real(RandomDouble()), Real(RandomDouble()));
 		}
 
 		Vector3 RandomVector3(double min, double max)
 		{
-			return Vector3(RandomDouble(min, max), RandomDouble(min, max), RandomDouble(min, max));
+			return Vector3(Real(RandomDouble(min, max)), Real(RandomDouble(min, max)), Real(RandomDouble(min, max)));
 		}
 
+		/** @brief Uniform direction on the unit sphere, from exactly two draws. */
 		Vector3 RandomUnitVector3()
 		{
-			while (true)
-			{
-				Vector3 p = RandomVector3(-1.0, 1.0);
-				double lensq = p.Length2();
-				if (1e-160 < lensq && lensq <= 1)
-				{
-					return p / std::sqrt(lensq);
-				}
-			}
+			const double u0 = RandomDouble();
+			const double u1 = RandomDouble();
+
+			return SampleUniformSphere(Vector2(u0, u1));
 		}
 
+		/** @brief Uniform direction on the hemisphere about 'N'; mirrors a uniform sphere direction into it. */
 		Vector3 RandomOnUnitHemisphere(const Vector3& N)
 		{
-			Vector3 onUnitSphere = RandomUnitVector3();
-			if (Vector3::Dot(onUnitSphere, N) > 0.0)
-			{
-				return onUnitSphere;
-			}
-			else
-			{
-				return -onUnitSphere;
-			}
+			const Vector3 onUnitSphere = RandomUnitVector3();
+
+			return onUnitSphere * std::copysign(Real(1), Vector3::Dot(onUnitSphere, N));
 		}
+
+		/** @brief Cosine-weighted direction on the hemisphere about the unit vector 'N', as a Lambertian surface scatters. */
+		Vector3 RandomCosineDirection(const Vector3& N)
+		{
+			const double u0 = RandomDouble();
+			const double u1 = RandomDouble();
+
+			return ToWorld(SampleCosineHemisphere(Vector2(u0, u1)), N);
+		}
+
+	private:
+
+		uint64_t state;
+		uint64_t increment;
 	};
 }
\ No newline at end of file
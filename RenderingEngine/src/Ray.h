@@ -4,19 +4,24 @@
 
 namespace Engine
 {
-	class Ray
+	template<typename T>
+	class RayT
 	{
 	public:
 
-		Vector3 origin;
-		Vector3 direction;
+		Vector3T<T> origin;
+		Vector3T<T> direction;
 
-		Ray() {}
-		Ray(const Vector3& origin, const Vector3& direction) : origin(origin), direction(direction) {}
+		RayT() {}
+		RayT(const Vector3T<T>& origin, const Vector3T<T>& direction) : origin(origin), direction(direction) {}
 
-		Vector3 At(double t) const
+		Vector3T<T> At(T t) const
 		{
 			return origin + (t * direction);
 		}
 	};
+
+	using Rayf = RayT<float>;
+	using Rayd = RayT<double>;
+	using Ray = RayT<Real>;
 }
\ No newline at end of file
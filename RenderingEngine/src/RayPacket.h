@@ -0,0 +1,101 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Ray.h"
+#include "HitRecord.h"
+#include "Interval.h"
+
+namespace Engine
+{
+	/**
+	 * @class RayPacket
+	 * @brief Up to 8x8 rays stored in structure-of-arrays form.
+	 *
+	 * Packets are meant for coherent rays, such as primary rays through a
+	 * block of neighbouring pixels, so that acceleration structures can make
+	 * one traversal decision for the whole packet.
+	 */
+	class RayPacket
+	{
+	public:
+
+		static constexpr int MaxSize = 64;
+
+		int size = 0;
+
+		alignas(32) Real originX[MaxSize];
+		alignas(32) Real originY[MaxSize];
+		alignas(32) Real originZ[MaxSize];
+		alignas(32) Real directionX[MaxSize];
+		alignas(32) Real directionY[MaxSize];
+		alignas(32) Real directionZ[MaxSize];
+
+		void Clear() { size = 0; }
+
+		/** @brief Appends a ray and returns its index within the packet. */
+		int Add(const Ray& ray)
+		{
+			const int i = size++;
+
+			originX[i] = ray.origin.x;
+			originY[i] = ray.origin.y;
+			originZ[i] = ray.origin.z;
+			directionX[i] = ray.direction.x;
+			directionY[i] = ray.direction.y;
+			directionZ[i] = ray.direction.z;
+
+			return i;
+		}
+
+		Ray Get(int i) const
+		{
+			return Ray(Vector3(originX[i], originY[i], originZ[i]), Vector3(directionX[i], directionY[i], directionZ[i]));
+		}
+
+		/** @brief Returns true if every ray direction lies in the same octant. */
+		bool SharesOctant() const
+		{
+			if (size == 0)
+			{
+				return true;
+			}
+
+			const bool negX = directionX[0] < 0.0;
+			const bool negY = directionY[0] < 0.0;
+			const bool negZ = directionZ[0] < 0.0;
+
+			for (int i = 1; i < size; i++)
+			{
+				if ((directionX[i] < 0.0) != negX || (directionY[i] < 0.0) != negY || (directionZ[i] < 0.0) != negZ)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	};
+
+	/**
+	 * @brief Closest-hit results for every ray of a RayPacket.
+	 *
+	 * 'tMax' starts at the end of the query interval and shrinks as closer hits
+	 * are found, exactly like 'closestSoFar' in single-ray traversal.
+	 */
+	struct PacketHit
+	{
+		alignas(32) Real tMax[RayPacket::MaxSize];
+		bool hit[RayPacket::MaxSize];
+		HitRecord records[RayPacket::MaxSize];
+
+		void Reset(int size, const Interval& ray_t)
+		{
+			for (int i = 0; i < size; i++)
+			{
+				tMax[i] = ray_t.max;
+				hit[i] = false;
+			}
+		}
+	};
+}
\ No newline at end of file
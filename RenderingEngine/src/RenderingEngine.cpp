@@ -4,8 +4,6 @@
 
 namespace Engine
 {
-	Random* Random::instance = nullptr;
-
 	RenderingEngine::RenderingEngine(HINSTANCE hInstance, HWND hwnd)
 	{
 		// Create the Vulkan backend for rendering.
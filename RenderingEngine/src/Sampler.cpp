@@ -0,0 +1,266 @@
+#include "pch.h"
+
+#include "Sampler.h"
+
+namespace Engine
+{
+	namespace
+	{
+		/// The first 64 primes; the bases of the first 32 Halton dimensions.
+		constexpr uint32_t Primes[64] =
+		{
+			2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+			59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131,
+			137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+			227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311,
+		};
+
+		/// Largest double below one, so no sample rounds up to the excluded end of [0, 1).
+		constexpr double OneMinusEpsilon = 0x1.fffffffffffffp-1;
+
+		constexpr uint32_t ReverseBits(uint32_t x)
+		{
+			x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+			x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+			x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+			x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+
+			return (x >> 16) | (x << 16);
+		}
+
+		/**
+		 * @brief Vegdahl's improvement of the Laine-Karras permutation.
+		 *
+		 * Every step only lets a bit depend on the bits below it, so applied to a
+		 * bit-reversed fraction it flips each digit depending on the more
+		 * significant ones: a nested uniform (Owen) scramble.
+		 */
+		uint32_t LaineKarras(uint32_t x, uint32_t seed)
+		{
+			x ^= x * 0x3d20adeau;
+			x += seed;
+			x *= (seed >> 16) | 1;
+			x ^= x * 0x05526c56u;
+			x ^= x * 0x53a22864u;
+
+			return x;
+		}
+
+		/**
+		 * @brief Bit-reversed second Sobol dimension, one table per index byte.
+		 *
+		 * The direction numbers of the polynomial x + 1 follow v[i + 1] = v[i] ^ (v[i] >> 1);
+		 * reversed, r[i + 1] = r[i] ^ (r[i] << 1). Entry [k][b] is the XOR of the
+		 * directions selected by byte b at byte position k.
+		 */
+		constexpr auto SobolTables = []()
+			{
+				std::array<std::array<uint32_t, 256>, 4> tables{};
+
+				uint32_t directions[32] = {};
+				uint32_t r = 1;
+				for (int i = 0; i < 32; i++, r ^= r << 1)
+				{
+					directions[i] = r;
+				}
+
+				for (int k = 0; k < 4; k++)
+				{
+					for (uint32_t b = 0; b < 256; b++)
+					{
+						for (int i = 0; i < 8; i++)
+						{
+							if (b & (1u << i))
+							{
+								tables[k][b] ^= directions[8 * k + i];
+							}
+						}
+					}
+				}
+
+				return tables;
+			}();
+
+		/** @brief Second Sobol dimension of 'index', bit-reversed. */
+		uint32_t SobolReversed(uint32_t index)
+		{
+			return SobolTables[0][index & 0xff] ^ SobolTables[1][(index >> 8) & 0xff] ^
+				SobolTables[2][(index >> 16) & 0xff] ^ SobolTables[3][index >> 24];
+		}
+
+		double ToUnit(uint32_t x)
+		{
+			return x * (1.0 / 4294967296.0);
+		}
+
+		/** @brief Uniform value in [0, 1) derived from a hash, used for the toroidal shifts. */
+		double HashToUnit(uint64_t hash)
+		{
+			return double(hash >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+		double Fraction(double x)
+		{
+			return x - std::floor(x);
+		}
+
+		/**
+		 * @brief Element 'i' of a pseudo-random permutation of [0, length) chosen by 'seed'.
+		 *
+		 * A. Kensler, "Correlated Multi-Jittered Sampling" (2013): a hash that is
+		 * a bijection on the next power of two, repeated until it lands in range.
+		 */
+		uint32_t PermutationElement(uint32_t i, uint32_t length, uint32_t seed)
+		{
+			uint32_t mask = length - 1;
+			mask |= mask >> 1;
+			mask |= mask >> 2;
+			mask |= mask >> 4;
+			mask |= mask >> 8;
+			mask |= mask >> 16;
+
+			do
+			{
+				i ^= seed;
+				i *= 0xe170893du;
+				i ^= seed >> 16;
+				i ^= (i & mask) >> 4;
+				i ^= seed >> 8;
+				i *= 0x0929eb3fu;
+				i ^= seed >> 23;
+				i ^= (i & mask) >> 1;
+				i *= 1 | seed >> 27;
+				i *= 0x6935fa69u;
+				i ^= (i & mask) >> 11;
+				i *= 0x74dcb303u;
+				i ^= (i & mask) >> 2;
+				i *= 0x9e501cc3u;
+				i ^= (i & mask) >> 2;
+				i *= 0xc860a3dfu;
+				i &= mask;
+				i ^= i >> 5;
+			} while (i >= length);
+
+			return (i + seed) % length;
+		}
+
+		/**
+		 * @brief Owen-scrambled radical inverse of 'index' in a prime 'base': the Halton
+		 *        sequence of that base with every digit permuted depending on the digits above it.
+		 *
+		 * Unlike a plain shift this also breaks the near-linear relation between
+		 * the large bases of higher Halton dimensions at small sample counts.
+		 */
+		double ScrambledRadicalInverse(uint32_t base, uint64_t index, uint64_t seed)
+		{
+			const double inverse = 1.0 / base;
+
+			double factor = inverse;
+			double result = 0.0;
+			uint64_t prefix = 0;
+
+			while (index)
+			{
+				const uint32_t digit = PermutationElement(uint32_t(index % base), base, uint32_t(Random::Hash(seed ^ prefix)));
+
+				result += digit * factor;
+				prefix = prefix * base + digit + 1;
+				index /= base;
+				factor *= inverse;
+			}
+
+			// Past the last digit of 'index' the scrambled digits are independent
+			// and uniform, so together they are one uniform value below factor * base.
+			return result + HashToUnit(Random::Hash(seed ^ prefix)) * factor * base;
+		}
+	}
+
+	Sampler::Sampler(SamplerType type, uint32_t x, uint32_t y, uint32_t sample, uint64_t seed) : type(type), sample(sample)
+	{
+		const uint64_t pixel = (uint64_t(y) << 32) | x;
+		pixelSeed = Random::Hash(seed ^ Random::Hash(pixel));
+		random = Random::ForSample(x, y, sample, seed);
+	}
+
+	double Sampler::Get1D()
+	{
+		const uint64_t hash = DimensionSeed();
+		double value;
+
+		switch (type)
+		{
+		case SamplerType::Sobol:
+		{
+			// The first Sobol dimension is the bit-reversed index, so scrambling the
+			// reversed index directly skips two reversals.
+			const uint32_t index = ReverseBits(LaineKarras(ReverseBits(sample), uint32_t(hash)));
+			value = ToUnit(ReverseBits(LaineKarras(index, uint32_t(hash >> 32))));
+			break;
+		}
+		case SamplerType::Halton:
+			// Every dimension owns two bases whether it is read in 1D or 2D, so no two dimensions share one.
+			value = dimension < 32 ? ScrambledRadicalInverse(Primes[2 * dimension], sample, hash) : random.RandomDouble();
+			break;
+		case SamplerType::R2:
+			// The one-dimensional recurrence steps by the inverse golden ratio.
+			value = Fraction(HashToUnit(hash) + sample * 0.61803398874989484820);
+			break;
+		default:
+			value = random.RandomDouble();
+			break;
+		}
+
+		dimension++;
+
+		return std::min(value, OneMinusEpsilon);
+	}
+
+	Vector2 Sampler::Get2D()
+	{
+		const uint64_t hash = DimensionSeed();
+		Vector2 value;
+
+		switch (type)
+		{
+		case SamplerType::Sobol:
+		{
+			// Owen-scrambling the index shuffles the samples while keeping each
+			// power-of-two prefix a (0,2)-net, which decorrelates the dimensions.
+			const uint32_t index = ReverseBits(LaineKarras(ReverseBits(sample), uint32_t(hash)));
+			const uint64_t scramble = Random::Hash(hash);
+
+			value = Vector2(ToUnit(ReverseBits(LaineKarras(index, uint32_t(scramble)))),
+				ToUnit(ReverseBits(LaineKarras(SobolReversed(index), uint32_t(scramble >> 32)))));
+			break;
+		}
+		case SamplerType::Halton:
+			if (dimension < 32)
+			{
+				value = Vector2(ScrambledRadicalInverse(Primes[2 * dimension], sample, hash),
+					ScrambledRadicalInverse(Primes[2 * dimension + 1], sample, Random::Hash(hash)));
+			}
+			else
+			{
+				// Beyond the prime table the bases are too large to stratify small sample counts.
+				value = Vector2(random.RandomDouble(), random.RandomDouble());
+			}
+			break;
+		case SamplerType::R2:
+		{
+			// Steps by the inverse powers of the plastic number, the real root of x^3 = x + 1.
+			constexpr double a1 = 0.75487766624669276005;
+			constexpr double a2 = 0.56984029099805326591;
+
+			value = Vector2(Fraction(HashToUnit(hash) + sample * a1), Fraction(HashToUnit(Random::Hash(hash)) + sample * a2));
+			break;
+		}
+		default:
+			value = Vector2(random.RandomDouble(), random.RandomDouble());
+			break;
+		}
+
+		dimension++;
+
+		return Vector2(std::min(value.x, OneMinusEpsilon), std::min(value.y, OneMinusEpsilon));
+	}
+}
\ No newline at end of file
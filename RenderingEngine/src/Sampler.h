@@ -0,0 +1,78 @@
+#pragma once
+
+#include "pch.h"
+#include "Random.h"
+#include "Vector2.h"
+
+namespace Engine
+{
+	/** @brief Sequence a Sampler draws from. */
+	enum class SamplerType
+	{
+		Independent, ///< Uniform PCG32 randoms; converges at the plain Monte Carlo rate.
+		Sobol,		 ///< Owen-scrambled Sobol (0,2)-sequence, shuffled per pixel and dimension.
+		Halton,		 ///< Halton sequence with Owen-scrambled digits, scrambled per pixel.
+		R2,			 ///< Roberts' additive recurrence on the plastic number, shifted per pixel.
+	};
+
+	/**
+	 * @class Sampler
+	 * @brief Source of the sample values one pixel sample consumes, one dimension at a time.
+	 *
+	 * A path reads its decisions (pixel jitter, light sample, bounce
+	 * direction, Russian roulette) from numbered dimensions. Each Get1D() or
+	 * Get2D() call reads the current dimension and advances to the next, and
+	 * SetDimension() jumps to a fixed one, so the same decision of every
+	 * sample of a pixel reads the same dimension. Across the samples of a
+	 * pixel each dimension then follows a low-discrepancy sequence: its
+	 * first N points cover the unit square far more evenly than N uniform
+	 * randoms, and estimates converge faster than the Monte Carlo rate.
+	 *
+	 * Every dimension is decorrelated from the others and from neighbouring
+	 * pixels by a hash of the pixel, dimension and seed (Owen scrambling for
+	 * Sobol and Halton, a random toroidal shift for R2), so there is no visible
+	 * structure, and like Random::ForSample() the values depend only on the
+	 * pixel, sample index and seed.
+	 *
+	 * See B. Burley, "Practical Hash-based Owen Scrambling" (JCGT 2020), and
+	 * M. Roberts, "The Unreasonable Effectiveness of Quasirandom Sequences" (2018).
+	 */
+	class Sampler
+	{
+	public:
+
+		Sampler() = default;
+
+		/**
+		 * @brief Creates the sampler for one sample of one pixel.
+		 * @param x Pixel column.
+		 * @param y Pixel row.
+		 * @param sample Index of the sample within the pixel.
+		 * @param seed Per-render seed.
+		 */
+		Sampler(SamplerType type, uint32_t x, uint32_t y, uint32_t sample, uint64_t seed = 0);
+
+		/** @brief Moves to a given dimension; the next Get1D() or Get2D() reads it. */
+		void SetDimension(uint32_t dimension) { this->dimension = dimension; }
+		uint32_t Dimension() const { return dimension; }
+
+		/** @brief Returns the value of the current dimension in [0, 1) and advances. */
+		double Get1D();
+
+		/** @brief Returns a point of the current dimension in [0, 1)^2 and advances. */
+		Vector2 Get2D();
+
+		SamplerType Type() const { return type; }
+
+	private:
+
+		SamplerType type = SamplerType::Independent;
+		uint32_t sample = 0;
+		uint32_t dimension = 0;
+		uint64_t pixelSeed = 0;
+		Random random; ///< Stream of the independent sampler and of Halton dimensions past the prime table.
+
+		/** @brief Hash of the pixel, seed and current dimension. */
+		uint64_t DimensionSeed() const { return Random::Hash(pixelSeed + dimension); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "pch.h"
+
+#include "Sampling.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+#if defined(__AVX2__)
+		// One register of Real and the few operations the warps need, so the
+		// kernels below are written once for both precisions.
+#if defined(ENGINE_FLOAT_PRECISION)
+		using Lanes = __m256;
+
+		Lanes Load(const float* p) { return _mm256_loadu_ps(p); }
+		void Store(float* p, Lanes v) { _mm256_storeu_ps(p, v); }
+		Lanes Set(float v) { return _mm256_set1_ps(v); }
+		Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+		Lanes Sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+		Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+		Lanes Madd(Lanes a, Lanes b, Lanes c) { return _mm256_fmadd_ps(a, b, c); }
+		Lanes Div(Lanes a, Lanes b) { return _mm256_div_ps(a, b); }
+		Lanes Sqrt(Lanes a) { return _mm256_sqrt_ps(_mm256_max_ps(a, _mm256_setzero_ps())); }
+		Lanes Greater(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		Lanes Equal(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+		Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b, a, mask); }
+#else
+		using Lanes = __m256d;
+
+		Lanes Load(const double* p) { return _mm256_loadu_pd(p); }
+		void Store(double* p, Lanes v) { _mm256_storeu_pd(p, v); }
+		Lanes Set(double v) { return _mm256_set1_pd(v); }
+		Lanes Add(Lanes a, Lanes b) { return _mm256_add_pd(a, b); }
+		Lanes Sub(Lanes a, Lanes b) { return _mm256_sub_pd(a, b); }
+		Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_pd(a, b); }
+		Lanes Madd(Lanes a, Lanes b, Lanes c) { return _mm256_fmadd_pd(a, b, c); }
+		Lanes Div(Lanes a, Lanes b) { return _mm256_div_pd(a, b); }
+		Lanes Sqrt(Lanes a) { return _mm256_sqrt_pd(_mm256_max_pd(a, _mm256_setzero_pd())); }
+		Lanes Greater(Lanes a, Lanes b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+		Lanes Equal(Lanes a, Lanes b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+		Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_pd(b, a, mask); }
+#endif
+
+		constexpr size_t LaneCount = sizeof(Lanes) / sizeof(Real);
+
+		/** @brief ConcentricDisk() on a register of samples. */
+		void ConcentricDisk(Lanes u0, Lanes u1, Lanes& x, Lanes& y)
+		{
+			const Lanes one = Set(1);
+			const Lanes a = Sub(Add(u0, u0), one);
+			const Lanes b = Sub(Add(u1, u1), one);
+
+			const Lanes major = Greater(Mul(a, a), Mul(b, b));
+			const Lanes r = Select(major, a, b);
+			const Lanes minor = Select(major, b, a);
+			const Lanes theta = Mul(Set(Real(PI / 4)), Div(minor, Select(Equal(r, Set(0)), one, r)));
+
+			// SinCosQuarterPi() by Horner's rule.
+			const Lanes t2 = Mul(theta, theta);
+
+			const auto c = [](double v) { return Set(Real(v)); };
+
+			Lanes sine = Madd(c(-1.0 / 1307674368000), t2, c(1.0 / 6227020800));
+			sine = Madd(sine, t2, c(-1.0 / 39916800));
+			sine = Madd(sine, t2, c(1.0 / 362880));
+			sine = Madd(sine, t2, c(-1.0 / 5040));
+			sine = Madd(sine, t2, c(1.0 / 120));
+			sine = Madd(sine, t2, c(-1.0 / 6));
+			sine = Mul(Madd(sine, t2, c(1.0)), theta);
+
+			Lanes cosine = Madd(c(1.0 / 20922789888000), t2, c(-1.0 / 87178291200));
+			cosine = Madd(cosine, t2, c(1.0 / 479001600));
+			cosine = Madd(cosine, t2, c(-1.0 / 3628800));
+			cosine = Madd(cosine, t2, c(1.0 / 40320));
+			cosine = Madd(cosine, t2, c(-1.0 / 720));
+			cosine = Madd(cosine, t2, c(1.0 / 24));
+			cosine = Madd(cosine, t2, c(-1.0 / 2));
+			cosine = Madd(cosine, t2, c(1.0));
+
+			x = Mul(r, Select(major, cosine, sine));
+			y = Mul(r, Select(major, sine, cosine));
+		}
+#endif
+	}
+
+	void SampleCosineHemisphere(const Real* u0, const Real* u1, Real* x, Real* y, Real* z, size_t count)
+	{
+		size_t i = 0;
+
+#if defined(__AVX2__)
+		for (; i + LaneCount <= count; i += LaneCount)
+		{
+			Lanes dx, dy;
+			ConcentricDisk(Load(u0 + i), Load(u1 + i), dx, dy);
+
+			Store(x + i, dx);
+			Store(y + i, dy);
+			Store(z + i, Sqrt(Sub(Set(1), Madd(dx, dx, Mul(dy, dy)))));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			Real dx, dy;
+			ConcentricDisk(u0[i], u1[i], dx, dy);
+
+			x[i] = dx;
+			y[i] = dy;
+			z[i] = std::sqrt(std::max(Real(0), 1 - dx * dx - dy * dy));
+		}
+	}
+
+	void SampleUniformSphere(const Real* u0, const Real* u1, Real* x, Real* y, Real* z, size_t count)
+	{
+		size_t i = 0;
+
+#if defined(__AVX2__)
+		for (; i + LaneCount <= count; i += LaneCount)
+		{
+			Lanes dx, dy;
+			ConcentricDisk(Load(u0 + i), Load(u1 + i), dx, dy);
+
+			const Lanes r2 = Madd(dx, dx, Mul(dy, dy));
+			const Lanes scale = Mul(Set(2), Sqrt(Sub(Set(1), r2)));
+
+			Store(x + i, Mul(dx, scale));
+			Store(y + i, Mul(dy, scale));
+			Store(z + i, Sub(Set(1), Add(r2, r2)));
+		}
+#endif
+
+		// SampleUniformCone() with cosThetaMax = -1.
+		for (; i < count; i++)
+		{
+			Real dx, dy;
+			ConcentricDisk(u0[i], u1[i], dx, dy);
+
+			const Real r2 = dx * dx + dy * dy;
+			const Real scale = 2 * std::sqrt(std::max(Real(0), 1 - r2));
+
+			x[i] = dx * scale;
+			y[i] = dy * scale;
+			z[i] = 1 - 2 * r2;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "pch.h"
+#include "Vector2.h"
+#include "Vector3.h"
+
+namespace Engine
+{
+	/**
+	 * @file Sampling.h
+	 * @brief Closed-form warps from [0, 1)^2 to directions.
+	 *
+	 * Every warp is a fixed sequence of arithmetic with selects instead of
+	 * rejection loops, so its cost does not depend on the sample and it
+	 * keeps the stratification of low-discrepancy samples (see Sampler).
+	 * Local-frame directions are about +z; OrthonormalBasis() moves them
+	 * about a normal. The batched variants write structure-of-arrays output
+	 * for many samples in one call.
+	 */
+
+	/**
+	 * @brief Sine and cosine of an angle in [-pi/4, pi/4].
+	 *
+	 * Taylor series to the 16th order, accurate to double rounding on that
+	 * interval. Unlike std::sin and std::cos it is plain arithmetic, so loops
+	 * over it vectorize.
+	 */
+	template<typename T>
+	inline void SinCosQuarterPi(T x, T& sine, T& cosine)
+	{
+		const T x2 = x * x;
+
+		sine = x * (1 + x2 * (T(-1.0 / 6) + x2 * (T(1.0 / 120) + x2 * (T(-1.0 / 5040) + x2 * (T(1.0 / 362880) +
+			x2 * (T(-1.0 / 39916800) + x2 * (T(1.0 / 6227020800) + x2 * T(-1.0 / 1307674368000))))))));
+		cosine = 1 + x2 * (T(-1.0 / 2) + x2 * (T(1.0 / 24) + x2 * (T(-1.0 / 720) + x2 * (T(1.0 / 40320) +
+			x2 * (T(-1.0 / 3628800) + x2 * (T(1.0 / 479001600) + x2 * (T(-1.0 / 87178291200) + x2 * T(1.0 / 20922789888000))))))));
+	}
+
+	/**
+	 * @brief Maps (u0, u1) in the unit square to (x, y) in the unit disk, keeping adjacent strata adjacent.
+	 *
+	 * P. Shirley and K. Chiu, "A Low Distortion Map Between Disk and Square"
+	 * (1997). The larger of the centred coordinates picks the wedge and the
+	 * radius; the angle within the wedge stays in [-pi/4, pi/4].
+	 */
+	template<typename T>
+	inline void ConcentricDisk(T u0, T u1, T& x, T& y)
+	{
+		const T a = 2 * u0 - 1;
+		const T b = 2 * u1 - 1;
+
+		// Select before dividing, so no lane divides by zero: the divisor is
+		// the larger coordinate, which is only zero at the centre.
+		const bool major = a * a > b * b;
+		const T r = major ? a : b;
+		const T minor = major ? b : a;
+		const T theta = T(PI / 4) * (minor / (r != 0 ? r : T(1)));
+
+		T sine, cosine;
+		SinCosQuarterPi(theta, sine, cosine);
+
+		// The other wedge is at pi/2 - theta, which swaps sine and cosine.
+		x = r * (major ? cosine : sine);
+		y = r * (major ? sine : cosine);
+	}
+
+	inline Vector2 SampleConcentricDisk(const Vector2& u)
+	{
+		Vector2 d;
+		ConcentricDisk(u.x, u.y, d.x, d.y);
+
+		return d;
+	}
+
+	/** @brief Cosine-weighted direction about +z: a concentric disk sample lifted onto the hemisphere (Malley's method). */
+	inline Vector3 SampleCosineHemisphere(const Vector2& u)
+	{
+		const Vector2 d = SampleConcentricDisk(u);
+		const double z = std::sqrt(std::max(0.0, 1.0 - d.x * d.x - d.y * d.y));
+
+		return Vector3(Real(d.x), Real(d.y), Real(z));
+	}
+
+	/** @brief Density of SampleCosineHemisphere() per unit solid angle. */
+	inline Real CosineHemispherePdf(Real cosTheta)
+	{
+		return std::max(cosTheta, Real(0)) * Real(1.0 / PI);
+	}
+
+	/**
+	 * @brief Uniform direction within the cone about +z whose half-angle has cosine 'cosThetaMax'.
+	 *
+	 * The squared radius of a concentric disk sample is uniform, so it maps
+	 * linearly to a uniform z, and the disk point is rescaled to the circle of
+	 * that z without any trigonometry.
+	 */
+	inline Vector3 SampleUniformCone(const Vector2& u, double cosThetaMax)
+	{
+		const Vector2 d = SampleConcentricDisk(u);
+		const double r2 = d.x * d.x + d.y * d.y;
+		const double k = 1.0 - cosThetaMax;
+
+		// 1 - z^2 = r2 * k * (2 - r2 * k), so the disk point scales by the root of the rest.
+		const double scale = std::sqrt(std::max(0.0, k * (2.0 - r2 * k)));
+
+		return Vector3(Real(d.x * scale), Real(d.y * scale), Real(1.0 - r2 * k));
+	}
+
+	/** @brief Uniform direction on the unit sphere: the cone that covers everything. */
+	inline Vector3 SampleUniformSphere(const Vector2& u)
+	{
+		return SampleUniformCone(u, -1.0);
+	}
+
+	inline Real UniformSpherePdf()
+	{
+		return Real(1.0 / (4.0 * PI));
+	}
+
+	/**
+	 * @brief Completes a unit normal 'n' to an orthonormal basis without branching on its direction.
+	 *
+	 * T. Duff et al., "Building an Orthonormal Basis, Revisited" (JCGT 2017).
+	 */
+	inline void OrthonormalBasis(const Vector3& n, Vector3& tangent, Vector3& bitangent)
+	{
+		const Real sign = std::copysign(Real(1), n.z);
+		const Real a = -1 / (sign + n.z);
+		const Real b = n.x * n.y * a;
+
+		tangent = Vector3(1 + sign * n.x * n.x * a, sign * b, -sign * n.x);
+		bitangent = Vector3(b, sign + n.y * n.y * a, -n.y);
+	}
+
+	/** @brief Rotates a direction given about +z to be about the unit vector 'n'. */
+	inline Vector3 ToWorld(const Vector3& local, const Vector3& n)
+	{
+		Vector3 tangent, bitangent;
+		OrthonormalBasis(n, tangent, bitangent);
+
+		return local.x * tangent + local.y * bitangent + local.z * n;
+	}
+
+	/**
+	 * @brief Batched SampleCosineHemisphere(): 'count' directions about +z from the samples (u0[i], u1[i]).
+	 * @param x, y, z Output arrays of 'count' direction components each; 'x' and 'y'
+	 *                may be the input arrays, as each element is read before it is written.
+	 */
+	void SampleCosineHemisphere(const Real* u0, const Real* u1, Real* x, Real* y, Real* z, size_t count);
+
+	/** @brief Batched SampleUniformSphere(), written as structure-of-arrays like SampleCosineHemisphere(). */
+	void SampleUniformSphere(const Real* u0, const Real* u1, Real* x, Real* y, Real* z, size_t count);
+}
\ No newline at end of file
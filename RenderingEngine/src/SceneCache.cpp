@@ -0,0 +1,417 @@
+#include "pch.h"
+
+#include "SceneCache.h"
+#include "Lambertian.h"
+#include "Random.h"
+#include "TriangleMesh.h"
+
+#include <bit>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		constexpr char Magic[8] = { 'R', 'E', 'S', 'C', 'A', 'C', 'H', 'E' };
+
+		/**
+		 * @brief Unique name for a writer's temporary file next to 'path'.
+		 *
+		 * Jobs sharing a cache directory, even on different hosts, may write
+		 * the same cache file at once; each writes its own temporary file and
+		 * the last rename wins with a complete file.
+		 */
+		std::filesystem::path TemporaryPath(const std::filesystem::path& path)
+		{
+#if defined(_WIN32)
+			const unsigned long process = GetCurrentProcessId();
+#else
+			const unsigned long process = static_cast<unsigned long>(getpid());
+#endif
+			static std::atomic<uint32_t> writes = 0;
+
+			char suffix[64];
+			std::snprintf(suffix, sizeof(suffix), ".%lu.%u.%08x.tmp", process, unsigned(writes++), unsigned(std::random_device()()));
+
+			return path.string() + suffix;
+		}
+
+		/// Every array starts at a multiple of this, so mapped arrays are aligned like allocated ones.
+		constexpr uint64_t Alignment = 64;
+
+		struct FileHeader
+		{
+			char magic[8];
+			uint32_t version;
+			uint32_t realSize;
+			uint64_t contentHash;
+			uint64_t fileSize;
+			uint64_t meshCount;
+			uint64_t meshOffset; ///< Array of MeshRecord.
+			uint64_t materialCount;
+			uint64_t materialOffset; ///< Three Reals of albedo per material.
+		};
+
+		/** @brief Location of one array, in elements from a byte offset of the file. */
+		struct Section
+		{
+			uint64_t offset = 0;
+			uint64_t count = 0;
+		};
+
+		struct MeshRecord
+		{
+			Section positionX;
+			Section positionY;
+			Section positionZ;
+			Section indices;
+			Section nodes;
+			uint32_t materialId;
+			uint32_t padding;
+		};
+
+		static_assert(std::is_trivially_copyable_v<BVHNode>, "BVH nodes are written and mapped as raw bytes");
+
+		uint64_t AlignUp(uint64_t offset)
+		{
+			return (offset + Alignment - 1) & ~(Alignment - 1);
+		}
+
+		/** @brief Returns true if 'section' is aligned and its elements lie inside a file of 'fileSize' bytes. */
+		template<typename T>
+		bool Fits(const Section& section, uint64_t fileSize)
+		{
+			return section.offset % Alignment == 0 && section.offset <= fileSize && section.count <= (fileSize - section.offset) / sizeof(T);
+		}
+
+		template<typename T>
+		std::span<const T> View(const uint8_t* base, const Section& section)
+		{
+			return { reinterpret_cast<const T*>(base + section.offset), size_t(section.count) };
+		}
+	}
+
+#if defined(_WIN32)
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+		file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			throw std::runtime_error("Failed to open '" + path.string() + "'!");
+		}
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file, &fileSize))
+		{
+			size = size_t(fileSize.QuadPart);
+		}
+
+		// Windows cannot map an empty file; it simply has no data.
+		if (size > 0)
+		{
+			mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			data = mapping ? static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+			if (!data)
+			{
+				if (mapping)
+				{
+					CloseHandle(mapping);
+				}
+				CloseHandle(file);
+
+				throw std::runtime_error("Failed to map '" + path.string() + "'!");
+			}
+		}
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data)
+		{
+			UnmapViewOfFile(data);
+			CloseHandle(mapping);
+		}
+
+		CloseHandle(file);
+	}
+#else
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+		const int descriptor = open(path.c_str(), O_RDONLY);
+		if (descriptor < 0)
+		{
+			throw std::runtime_error("Failed to open '" + path.string() + "'!");
+		}
+
+		struct stat status;
+		if (fstat(descriptor, &status) == 0)
+		{
+			size = size_t(status.st_size);
+		}
+
+		// An empty file cannot be mapped; it simply has no data.
+		if (size > 0)
+		{
+			void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (address == MAP_FAILED)
+			{
+				close(descriptor);
+				throw std::runtime_error("Failed to map '" + path.string() + "'!");
+			}
+
+			data = static_cast<const uint8_t*>(address);
+		}
+
+		// The mapping keeps its own reference to the file.
+		close(descriptor);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (data)
+		{
+			munmap(const_cast<uint8_t*>(data), size);
+		}
+	}
+#endif
+
+	uint64_t SceneCache::HashFile(const std::filesystem::path& path)
+	{
+		const MappedFile file(path);
+		const uint8_t* bytes = file.Data();
+		const size_t size = file.Size();
+
+		// Four independent multiply-rotate lanes keep several multiplies in
+		// flight, so hashing a large asset runs close to memory bandwidth.
+		constexpr uint64_t Prime1 = 0x9e3779b185ebca87ull;
+		constexpr uint64_t Prime2 = 0xc2b2ae3d27d4eb4full;
+
+		uint64_t lanes[4] = { Prime1 + Prime2, Prime2, 0, 0 - Prime1 };
+
+		size_t i = 0;
+		for (; i + 32 <= size; i += 32)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				uint64_t word;
+				std::memcpy(&word, bytes + i + 8 * k, sizeof(word));
+				lanes[k] = std::rotl(lanes[k] + word * Prime2, 31) * Prime1;
+			}
+		}
+
+		uint64_t hash = Random::Hash(size);
+		for (const uint64_t lane : lanes)
+		{
+			hash = Random::Hash(hash ^ lane);
+		}
+
+		for (; i < size; i++)
+		{
+			hash = Random::Hash(hash ^ bytes[i]);
+		}
+
+		return hash;
+	}
+
+	std::string SceneCache::FileName(uint64_t contentHash)
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "%016llx.v%u.%s.rcache", (unsigned long long)contentHash, Version, sizeof(Real) == sizeof(double) ? "f64" : "f32");
+
+		return name;
+	}
+
+	bool SceneCache::Write(const std::filesystem::path& path, uint64_t contentHash, const HittableList& objects, const MaterialTable& materials)
+	{
+		std::vector<const TriangleMesh*> meshes;
+		for (const auto& object : objects.objects)
+		{
+			const auto* mesh = dynamic_cast<const TriangleMesh*>(object.get());
+			if (!mesh)
+			{
+				return false;
+			}
+
+			meshes.push_back(mesh);
+		}
+
+		std::vector<Real> albedos;
+		for (uint32_t id = 0; id < materials.Size(); id++)
+		{
+			const auto* lambertian = dynamic_cast<const Lambertian*>(materials.Get(id));
+			if (!lambertian)
+			{
+				return false;
+			}
+
+			const Vector3& albedo = lambertian->Albedo();
+			albedos.insert(albedos.end(), { albedo.x, albedo.y, albedo.z });
+		}
+
+		// Lay out the file first: header, mesh records, materials, then the arrays of every mesh.
+		FileHeader header = {};
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.version = Version;
+		header.realSize = sizeof(Real);
+		header.contentHash = contentHash;
+		header.meshCount = meshes.size();
+		header.meshOffset = AlignUp(sizeof(FileHeader));
+		header.materialCount = materials.Size();
+		header.materialOffset = AlignUp(header.meshOffset + meshes.size() * sizeof(MeshRecord));
+
+		uint64_t end = header.materialOffset + albedos.size() * sizeof(Real);
+		const auto place = [&end](size_t count, size_t elementSize)
+			{
+				const Section section = { AlignUp(end), count };
+				end = section.offset + count * elementSize;
+
+				return section;
+			};
+
+		std::vector<MeshRecord> records(meshes.size());
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			const TriangleMeshArrays& arrays = meshes[i]->Arrays();
+
+			records[i].positionX = place(arrays.positionX.size(), sizeof(Real));
+			records[i].positionY = place(arrays.positionY.size(), sizeof(Real));
+			records[i].positionZ = place(arrays.positionZ.size(), sizeof(Real));
+			records[i].indices = place(arrays.indices.size(), sizeof(uint32_t));
+			records[i].nodes = place(arrays.nodes.size(), sizeof(BVHNode));
+			records[i].materialId = arrays.materialId;
+		}
+
+		header.fileSize = end;
+
+		const std::filesystem::path temporary = TemporaryPath(path);
+
+		try
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			uint64_t position = 0;
+
+			// Writes 'bytes' at 'offset', padding the gap since the last write with zeros.
+			const auto write = [&](uint64_t offset, const void* bytes, size_t size)
+				{
+					static constexpr char zeros[Alignment] = {};
+
+					file.write(zeros, std::streamsize(offset - position));
+					file.write(static_cast<const char*>(bytes), std::streamsize(size));
+					position = offset + size;
+				};
+
+			write(0, &header, sizeof(header));
+			write(header.meshOffset, records.data(), records.size() * sizeof(MeshRecord));
+			write(header.materialOffset, albedos.data(), albedos.size() * sizeof(Real));
+
+			for (size_t i = 0; i < meshes.size(); i++)
+			{
+				const TriangleMeshArrays& arrays = meshes[i]->Arrays();
+
+				write(records[i].positionX.offset, arrays.positionX.data(), arrays.positionX.size_bytes());
+				write(records[i].positionY.offset, arrays.positionY.data(), arrays.positionY.size_bytes());
+				write(records[i].positionZ.offset, arrays.positionZ.data(), arrays.positionZ.size_bytes());
+				write(records[i].indices.offset, arrays.indices.data(), arrays.indices.size_bytes());
+				write(records[i].nodes.offset, arrays.nodes.data(), arrays.nodes.size_bytes());
+			}
+
+			file.close();
+			if (!file)
+			{
+				throw std::runtime_error("Failed to write scene cache '" + temporary.string() + "'!");
+			}
+
+			std::filesystem::rename(temporary, path);
+		}
+		catch (...)
+		{
+			// Leave nothing behind for the next writer or the directory listing.
+			std::error_code ignored;
+			std::filesystem::remove(temporary, ignored);
+			throw;
+		}
+
+		return true;
+	}
+
+	bool SceneCache::Load(const std::filesystem::path& path, uint64_t contentHash, HittableList& objects, MaterialTable& materials)
+	{
+		std::error_code error;
+		if (!std::filesystem::is_regular_file(path, error))
+		{
+			return false;
+		}
+
+		const auto file = std::make_shared<MappedFile>(path);
+		const uint8_t* base = file->Data();
+		const uint64_t size = file->Size();
+
+		if (size < sizeof(FileHeader))
+		{
+			return false;
+		}
+
+		FileHeader header;
+		std::memcpy(&header, base, sizeof(header));
+
+		if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version || header.realSize != sizeof(Real) ||
+			header.contentHash != contentHash || header.fileSize != size || header.materialCount > size)
+		{
+			return false;
+		}
+
+		const Section meshSection = { header.meshOffset, header.meshCount };
+		const Section materialSection = { header.materialOffset, header.materialCount * 3 };
+
+		if (!Fits<MeshRecord>(meshSection, size) || !Fits<Real>(materialSection, size))
+		{
+			return false;
+		}
+
+		// Check every mesh before adding any, so a malformed file adds nothing.
+		const std::span<const MeshRecord> records = View<MeshRecord>(base, meshSection);
+		for (const MeshRecord& record : records)
+		{
+			const uint64_t vertexCount = record.positionX.count;
+
+			if (record.positionY.count != vertexCount || record.positionZ.count != vertexCount ||
+				record.indices.count == 0 || record.indices.count % 3 != 0 || record.nodes.count == 0 ||
+				!Fits<Real>(record.positionX, size) || !Fits<Real>(record.positionY, size) || !Fits<Real>(record.positionZ, size) ||
+				!Fits<uint32_t>(record.indices, size) || !Fits<BVHNode>(record.nodes, size))
+			{
+				return false;
+			}
+		}
+
+		for (const MeshRecord& record : records)
+		{
+			TriangleMeshArrays arrays;
+			arrays.positionX = View<Real>(base, record.positionX);
+			arrays.positionY = View<Real>(base, record.positionY);
+			arrays.positionZ = View<Real>(base, record.positionZ);
+			arrays.indices = View<uint32_t>(base, record.indices);
+			arrays.nodes = View<BVHNode>(base, record.nodes);
+			arrays.materialId = record.materialId;
+
+			objects.Add(std::make_shared<TriangleMesh>(arrays, file));
+		}
+
+		const std::span<const Real> albedos = View<Real>(base, materialSection);
+		for (size_t i = 0; i < header.materialCount; i++)
+		{
+			materials.Add(std::make_shared<Lambertian>(Vector3(albedos[i * 3], albedos[i * 3 + 1], albedos[i * 3 + 2])));
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
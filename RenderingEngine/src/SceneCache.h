@@ -0,0 +1,98 @@
+#pragma once
+
+#include "pch.h"
+
+#include "HittableList.h"
+#include "MaterialTable.h"
+
+#include <filesystem>
+
+namespace Engine
+{
+	/**
+	 * @class MappedFile
+	 * @brief Read-only memory mapping of a whole file.
+	 *
+	 * Pages are read from disk when first touched and shared with the page
+	 * cache, so mapping a large file is nearly free and a second process
+	 * mapping the same file reads no memory of its own.
+	 */
+	class MappedFile
+	{
+	public:
+
+		/** @throws std::runtime_error if the file cannot be opened or mapped. */
+		explicit MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const uint8_t* Data() const { return data; }
+		size_t Size() const { return size; }
+
+	private:
+
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+
+#if defined(_WIN32)
+		void* file = nullptr;
+		void* mapping = nullptr;
+#endif
+	};
+
+	/**
+	 * @class SceneCache
+	 * @brief On-disk cache of built triangle meshes, their BVHs and their materials.
+	 *
+	 * A cache file stores every array a TriangleMesh traces (positions,
+	 * indices in leaf order and BVH nodes) at 64-byte aligned offsets from
+	 * the start of the file, so it holds no pointers. Load() maps the file
+	 * and hands each mesh views into the mapping: nothing is parsed, copied
+	 * or rebuilt, and pages are only read as rays reach them.
+	 *
+	 * Files are keyed by a hash of the source asset's bytes and record the
+	 * format version and the size of Real, so an edited asset, an older
+	 * engine or a build of the other precision misses instead of reading
+	 * arrays it does not understand. The arrays themselves are trusted: a
+	 * cache file is only as safe as the directory it is kept in.
+	 */
+	class SceneCache
+	{
+	public:
+
+		/// Format version, raised whenever the layout of a file or of the arrays it holds changes.
+		static constexpr uint32_t Version = 1;
+
+		/** @brief Hash of a file's contents, read through a mapping. */
+		static uint64_t HashFile(const std::filesystem::path& path);
+
+		/** @brief Name of the cache file for an asset with the given content hash, in this version and precision. */
+		static std::string FileName(uint64_t contentHash);
+
+		/**
+		 * @brief Writes the meshes and materials of a scene.
+		 *
+		 * The file is written under a unique temporary name next to 'path' and
+		 * then renamed over it, so a reader never maps a partly written file
+		 * and concurrent writers of the same file do not disturb each other.
+		 * The temporary file is removed if writing fails.
+		 *
+		 * @return False, writing nothing, unless every object is a TriangleMesh and every material a Lambertian.
+		 * @throws std::runtime_error if the file cannot be written.
+		 */
+		static bool Write(const std::filesystem::path& path, uint64_t contentHash, const HittableList& objects, const MaterialTable& materials);
+
+		/**
+		 * @brief Maps a cache file and appends its meshes and materials.
+		 *
+		 * The meshes keep the mapping alive; it is unmapped when the last of
+		 * them is destroyed. Material IDs are stored as written, so they only
+		 * match if 'materials' starts empty.
+		 *
+		 * @return False, appending nothing, if the file is missing, malformed, or written for another asset, version or precision.
+		 */
+		static bool Load(const std::filesystem::path& path, uint64_t contentHash, HittableList& objects, MaterialTable& materials);
+	};
+}
\ No newline at end of file
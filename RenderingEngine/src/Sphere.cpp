@@ -4,43 +4,84 @@
 
 namespace Engine
 {
-	Sphere::Sphere(const Vector3& center, double radius)
+	Sphere::Sphere(const Vector3& center, Real radius, uint32_t materialId)
 	{
 		this->center = center;
-		this->radius = std::fmax(0.0f, radius);
+		this->radius = std::fmax(Real(0), radius);
+		this->materialId = materialId;
+
+		const Vector3 extent(this->radius, this->radius, this->radius);
+		bbox = AABB(center - extent, center + extent);
 	}
 
 	bool Sphere::Hit(const Ray& ray, Interval ray_t, HitRecord& record) const
 	{
-		const Vector3 oc = center - ray.origin;
-		const double a = ray.direction.Length2();
-		const double h = Vector3::Dot(ray.direction, oc);
-		const double c = oc.Length2() - radius * radius;
-
-		const double d = h * h - a * c;
-		if (d < 0)
+		Real root;
+		if (!IntersectSphere(center, radius, ray, ray_t, root))
 		{
 			return false;
 		}
 
-		const double sqrtd = std::sqrt(d);
+		record.t = root;
+		record.p = ray.At(record.t);
+		Vector3 outwardNormal = (record.p - center) / radius;
+		record.SetFaceNormal(ray, outwardNormal);
+		record.materialId = materialId;
+
+		return true;
+	}
+
+	void Sphere::HitPacket(const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const
+	{
+		const Real radius2 = radius * radius;
 
-		// Find the nearest root that lies in the acceptable range.
-		double root = (h - sqrtd) / a;
-		if (!ray_t.Surrounds(root))
+		for (int k = 0; k < count; k++)
 		{
-			root = (h + sqrtd) / a;
+			const int i = indices[k];
+
+			// Same quadratic as Hit(), read straight from the packet's arrays.
+			const Real ocx = center.x - packet.originX[i];
+			const Real ocy = center.y - packet.originY[i];
+			const Real ocz = center.z - packet.originZ[i];
+
+			const Real dx = packet.directionX[i];
+			const Real dy = packet.directionY[i];
+			const Real dz = packet.directionZ[i];
+
+			const Real a = dx * dx + dy * dy + dz * dz;
+			const Real h = dx * ocx + dy * ocy + dz * ocz;
+			const Real c = (ocx * ocx + ocy * ocy + ocz * ocz) - radius2;
+
+			const Real d = h * h - a * c;
+			if (d < 0)
+			{
+				continue;
+			}
+
+			const Real sqrtd = std::sqrt(d);
+			const Interval ray_t(tMin, result.tMax[i]);
+
+			Real root = (h - sqrtd) / a;
 			if (!ray_t.Surrounds(root))
 			{
-				return false;
+				root = (h + sqrtd) / a;
+				if (!ray_t.Surrounds(root))
+				{
+					continue;
+				}
 			}
-		}
 
-		record.t = root;
-		record.p = ray.At(record.t);
-		Vector3 outwardNormal = (record.p - center) / radius;
-		record.SetFaceNormal(ray, outwardNormal);
+			const Ray ray = packet.Get(i);
+			HitRecord& record = result.records[i];
 
-		return true;
+			record.t = root;
+			record.p = ray.At(record.t);
+			Vector3 outwardNormal = (record.p - center) / radius;
+			record.SetFaceNormal(ray, outwardNormal);
+			record.materialId = materialId;
+
+			result.hit[i] = true;
+			result.tMax[i] = root;
+		}
 	}
 }
\ No newline at end of file
@@ -6,15 +6,66 @@
 
 namespace Engine
 {
-	class Sphere : public Hittable
+	/**
+	 * @brief Finds the nearest root of a ray/sphere intersection inside 'ray_t'.
+	 *
+	 * Written once for every scalar type so that float and double builds share
+	 * the same math.
+	 *
+	 * @return True and the root in 'root' if the ray hits the sphere within 'ray_t'.
+	 */
+	template<typename T>
+	bool IntersectSphere(const Vector3T<T>& center, T radius, const RayT<T>& ray, const IntervalT<T>& ray_t, T& root)
+	{
+		const Vector3T<T> oc = center - ray.origin;
+		const T a = ray.direction.Length2();
+		const T h = Vector3T<T>::Dot(ray.direction, oc);
+		const T c = oc.Length2() - radius * radius;
+
+		const T d = h * h - a * c;
+		if (d < 0)
+		{
+			return false;
+		}
+
+		const T sqrtd = std::sqrt(d);
+
+		// Find the nearest root that lies in the acceptable range.
+		root = (h - sqrtd) / a;
+		if (!ray_t.Surrounds(root))
+		{
+			root = (h + sqrtd) / a;
+			if (!ray_t.Surrounds(root))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	class Sphere final : public Hittable
 	{
 	public:
 
 		Vector3 center;
-		double radius;
+		Real radius;
+		uint32_t materialId;
 
-		Sphere(const Vector3& center, double radius);
+		Sphere(const Vector3& center, Real radius, uint32_t materialId = 0);
 
 		bool Hit(const Ray& ray, Interval ray_t, HitRecord& record) const override;
+		void HitPacket(const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const override;
+		AABB BoundingBox() const override { return bbox; }
+
+		bool Occluded(const Ray& ray, Interval ray_t) const override
+		{
+			Real root;
+			return IntersectSphere(center, radius, ray, ray_t, root);
+		}
+
+	private:
+
+		AABB bbox;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "pch.h"
+
+#include "SphereBatch.h"
+#include "BVHTree.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace Engine
+{
+	bool SphereBatch::Add(const Vector3& center, Real radius, uint32_t materialId)
+	{
+		if (Full())
+		{
+			return false;
+		}
+
+		const Real r = std::fmax(Real(0), radius);
+
+		centerX[count] = center.x;
+		centerY[count] = center.y;
+		centerZ[count] = center.z;
+		this->radius[count] = r;
+		radius2[count] = r * r;
+		this->materialId[count] = materialId;
+		count++;
+
+		const Vector3 extent(r, r, r);
+		bbox = AABB(bbox, AABB(center - extent, center + extent));
+
+		return true;
+	}
+
+	int SphereBatch::Intersect(const Ray& ray, const Interval& ray_t, Real& t) const
+	{
+		alignas(32) Real roots[Width];
+
+		const Real a = ray.direction.Length2();
+		const Real invA = 1 / a;
+		const Real infinity = std::numeric_limits<Real>::infinity();
+
+#if defined(__AVX__) && defined(ENGINE_FLOAT_PRECISION)
+		const __m256 dx = _mm256_set1_ps(ray.direction.x);
+		const __m256 dy = _mm256_set1_ps(ray.direction.y);
+		const __m256 dz = _mm256_set1_ps(ray.direction.z);
+
+		const __m256 ocx = _mm256_sub_ps(_mm256_load_ps(centerX), _mm256_set1_ps(ray.origin.x));
+		const __m256 ocy = _mm256_sub_ps(_mm256_load_ps(centerY), _mm256_set1_ps(ray.origin.y));
+		const __m256 ocz = _mm256_sub_ps(_mm256_load_ps(centerZ), _mm256_set1_ps(ray.origin.z));
+
+		const __m256 h = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, ocx), _mm256_mul_ps(dy, ocy)), _mm256_mul_ps(dz, ocz));
+		const __m256 oc2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ocx, ocx), _mm256_mul_ps(ocy, ocy)), _mm256_mul_ps(ocz, ocz));
+		const __m256 c = _mm256_sub_ps(oc2, _mm256_load_ps(radius2));
+
+		const __m256 d = _mm256_sub_ps(_mm256_mul_ps(h, h), _mm256_mul_ps(_mm256_set1_ps(a), c));
+		const __m256 hasRoots = _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ);
+		const __m256 sqrtd = _mm256_sqrt_ps(_mm256_max_ps(d, _mm256_setzero_ps()));
+
+		const __m256 vInvA = _mm256_set1_ps(invA);
+		const __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(h, sqrtd), vInvA);
+		const __m256 t1 = _mm256_mul_ps(_mm256_add_ps(h, sqrtd), vInvA);
+
+		// Same acceptance rule as Interval::Surrounds: min < t < max.
+		const __m256 tMin = _mm256_set1_ps(ray_t.min);
+		const __m256 tMax = _mm256_set1_ps(ray_t.max);
+		const __m256 nearValid = _mm256_and_ps(_mm256_cmp_ps(t0, tMin, _CMP_GT_OQ), _mm256_cmp_ps(t0, tMax, _CMP_LT_OQ));
+		const __m256 farValid = _mm256_and_ps(_mm256_cmp_ps(t1, tMin, _CMP_GT_OQ), _mm256_cmp_ps(t1, tMax, _CMP_LT_OQ));
+
+		const __m256 root = _mm256_blendv_ps(t1, t0, nearValid);
+		const __m256 valid = _mm256_and_ps(hasRoots, _mm256_or_ps(nearValid, farValid));
+
+		if (_mm256_movemask_ps(valid) == 0)
+		{
+			return -1;
+		}
+
+		_mm256_store_ps(roots, _mm256_blendv_ps(_mm256_set1_ps(infinity), root, valid));
+#elif defined(__AVX__)
+		const __m256d dx = _mm256_set1_pd(ray.direction.x);
+		const __m256d dy = _mm256_set1_pd(ray.direction.y);
+		const __m256d dz = _mm256_set1_pd(ray.direction.z);
+
+		const __m256d ocx = _mm256_sub_pd(_mm256_load_pd(centerX), _mm256_set1_pd(ray.origin.x));
+		const __m256d ocy = _mm256_sub_pd(_mm256_load_pd(centerY), _mm256_set1_pd(ray.origin.y));
+		const __m256d ocz = _mm256_sub_pd(_mm256_load_pd(centerZ), _mm256_set1_pd(ray.origin.z));
+
+		const __m256d h = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, ocx), _mm256_mul_pd(dy, ocy)), _mm256_mul_pd(dz, ocz));
+		const __m256d oc2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ocx, ocx), _mm256_mul_pd(ocy, ocy)), _mm256_mul_pd(ocz, ocz));
+		const __m256d c = _mm256_sub_pd(oc2, _mm256_load_pd(radius2));
+
+		const __m256d d = _mm256_sub_pd(_mm256_mul_pd(h, h), _mm256_mul_pd(_mm256_set1_pd(a), c));
+		const __m256d hasRoots = _mm256_cmp_pd(d, _mm256_setzero_pd(), _CMP_GE_OQ);
+		const __m256d sqrtd = _mm256_sqrt_pd(_mm256_max_pd(d, _mm256_setzero_pd()));
+
+		const __m256d vInvA = _mm256_set1_pd(invA);
+		const __m256d t0 = _mm256_mul_pd(_mm256_sub_pd(h, sqrtd), vInvA);
+		const __m256d t1 = _mm256_mul_pd(_mm256_add_pd(h, sqrtd), vInvA);
+
+		// Same acceptance rule as Interval::Surrounds: min < t < max.
+		const __m256d tMin = _mm256_set1_pd(ray_t.min);
+		const __m256d tMax = _mm256_set1_pd(ray_t.max);
+		const __m256d nearValid = _mm256_and_pd(_mm256_cmp_pd(t0, tMin, _CMP_GT_OQ), _mm256_cmp_pd(t0, tMax, _CMP_LT_OQ));
+		const __m256d farValid = _mm256_and_pd(_mm256_cmp_pd(t1, tMin, _CMP_GT_OQ), _mm256_cmp_pd(t1, tMax, _CMP_LT_OQ));
+
+		const __m256d root = _mm256_blendv_pd(t1, t0, nearValid);
+		const __m256d valid = _mm256_and_pd(hasRoots, _mm256_or_pd(nearValid, farValid));
+
+		if (_mm256_movemask_pd(valid) == 0)
+		{
+			return -1;
+		}
+
+		_mm256_store_pd(roots, _mm256_blendv_pd(_mm256_set1_pd(infinity), root, valid));
+#else
+		for (int i = 0; i < Width; i++)
+		{
+			const Real ocx = centerX[i] - ray.origin.x;
+			const Real ocy = centerY[i] - ray.origin.y;
+			const Real ocz = centerZ[i] - ray.origin.z;
+
+			const Real h = ray.direction.x * ocx + ray.direction.y * ocy + ray.direction.z * ocz;
+			const Real c = ocx * ocx + ocy * ocy + ocz * ocz - radius2[i];
+			const Real d = h * h - a * c;
+			const Real sqrtd = std::sqrt(std::fmax(d, Real(0)));
+
+			const Real t0 = (h - sqrtd) * invA;
+			const Real t1 = (h + sqrtd) * invA;
+
+			const bool nearValid = ray_t.Surrounds(t0);
+			const bool farValid = ray_t.Surrounds(t1);
+
+			roots[i] = (d >= 0.0 && (nearValid || farValid)) ? (nearValid ? t0 : t1) : infinity;
+		}
+#endif
+
+		int lane = -1;
+		t = infinity;
+
+		for (int i = 0; i < count; i++)
+		{
+			if (roots[i] < t)
+			{
+				t = roots[i];
+				lane = i;
+			}
+		}
+
+		return lane;
+	}
+
+	bool SphereBatch::Hit(const Ray& ray, Interval ray_t, HitRecord& record) const
+	{
+		Real t;
+		const int lane = Intersect(ray, ray_t, t);
+		if (lane < 0)
+		{
+			return false;
+		}
+
+		const Vector3 center(centerX[lane], centerY[lane], centerZ[lane]);
+
+		record.t = t;
+		record.p = ray.At(t);
+		Vector3 outwardNormal = (record.p - center) / radius[lane];
+		record.SetFaceNormal(ray, outwardNormal);
+		record.materialId = materialId[lane];
+
+		return true;
+	}
+
+	void SphereBatch::HitPacket(const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const
+	{
+		for (int k = 0; k < count; k++)
+		{
+			const int i = indices[k];
+			const Ray ray = packet.Get(i);
+
+			Real t;
+			const int lane = Intersect(ray, Interval(tMin, result.tMax[i]), t);
+			if (lane < 0)
+			{
+				continue;
+			}
+
+			const Vector3 center(centerX[lane], centerY[lane], centerZ[lane]);
+			HitRecord& record = result.records[i];
+
+			record.t = t;
+			record.p = ray.At(t);
+			Vector3 outwardNormal = (record.p - center) / radius[lane];
+			record.SetFaceNormal(ray, outwardNormal);
+			record.materialId = materialId[lane];
+
+			result.hit[i] = true;
+			result.tMax[i] = t;
+		}
+	}
+
+	HittableList SphereBatch::Pack(const HittableList& list)
+	{
+		std::vector<const Sphere*> spheres;
+		std::vector<AABB> bounds;
+		HittableList others;
+
+		for (const auto& object : list.objects)
+		{
+			if (const Sphere* sphere = dynamic_cast<const Sphere*>(object.get()))
+			{
+				spheres.push_back(sphere);
+				bounds.push_back(sphere->BoundingBox());
+			}
+			else
+			{
+				others.Add(object);
+			}
+		}
+
+		// Cluster with the SAH builder, making leaves of up to 'Width' spheres
+		// always cheaper than splitting so that batches come out full.
+		BVHBuildOptions options;
+		options.maxLeafSize = Width;
+		options.intersectionCost = 1.0 / (4 * Width);
+
+		BVHTree tree;
+		tree.Build(bounds, options);
+
+		HittableList packed;
+		for (const BVHNode& node : tree.nodes)
+		{
+			if (!node.IsLeaf())
+			{
+				continue;
+			}
+
+			auto batch = std::make_shared<SphereBatch>();
+			for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++)
+			{
+				// Leaves forced at the depth limit may exceed the batch width.
+				if (batch->Full())
+				{
+					packed.Add(batch);
+					batch = std::make_shared<SphereBatch>();
+				}
+
+				const Sphere* sphere = spheres[tree.primitiveIndices[i]];
+				batch->Add(sphere->center, sphere->radius, sphere->materialId);
+			}
+
+			packed.Add(batch);
+		}
+
+		for (const auto& object : others.objects)
+		{
+			packed.Add(object);
+		}
+
+		return packed;
+	}
+}
\ No newline at end of file
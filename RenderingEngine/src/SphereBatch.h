@@ -0,0 +1,75 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Hittable.h"
+#include "HittableList.h"
+#include "Sphere.h"
+
+namespace Engine
+{
+	/**
+	 * @class SphereBatch
+	 * @brief Up to 'Width' spheres stored in structure-of-arrays form and intersected together.
+	 *
+	 * Runs the quadratic from Sphere::Hit against every lane at once (AVX when
+	 * the build targets it, otherwise a scalar loop the compiler can vectorize)
+	 * and keeps the nearest valid root. A batch is a regular Hittable with a
+	 * bounding box, so it is meant to be used as a BVH leaf: Pack() groups
+	 * nearby spheres into batches before the scene BVH is built.
+	 */
+	class SphereBatch final : public Hittable
+	{
+	public:
+
+		/// Number of spheres tested per instruction: one 256-bit register of Real.
+		static constexpr int Width = int(32 / sizeof(Real));
+
+		SphereBatch() {}
+
+		/**
+		 * @brief Adds a sphere to the next free lane.
+		 * @return False if the batch is already full.
+		 */
+		bool Add(const Vector3& center, Real radius, uint32_t materialId = 0);
+
+		int Count() const { return count; }
+		bool Full() const { return count == Width; }
+
+		bool Hit(const Ray& ray, Interval ray_t, HitRecord& record) const override;
+		void HitPacket(const RayPacket& packet, Real tMin, const uint8_t* indices, int count, PacketHit& result) const override;
+		AABB BoundingBox() const override { return bbox; }
+
+		bool Occluded(const Ray& ray, Interval ray_t) const override
+		{
+			Real t;
+			return Intersect(ray, ray_t, t) >= 0;
+		}
+
+		/**
+		 * @brief Packs the spheres of a list into spatially coherent batches.
+		 *
+		 * Spheres are clustered with the SAH builder so each batch covers a
+		 * compact region; other objects are passed through unchanged.
+		 *
+		 * @param list Objects to pack.
+		 * @return A list of batches followed by the non-sphere objects.
+		 */
+		static HittableList Pack(const HittableList& list);
+
+	private:
+
+		alignas(32) Real centerX[Width] = {};
+		alignas(32) Real centerY[Width] = {};
+		alignas(32) Real centerZ[Width] = {};
+		alignas(32) Real radius[Width] = {};
+		alignas(32) Real radius2[Width] = {};
+		uint32_t materialId[Width] = {};
+
+		int count = 0;
+		AABB bbox;
+
+		/** @brief Returns the lane with the nearest valid root and writes that root to 't', or -1. */
+		int Intersect(const Ray& ray, const Interval& ray_t, Real& t) const;
+	};
+}
\ No newline at end of file
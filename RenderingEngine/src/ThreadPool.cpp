@@ -0,0 +1,191 @@
+#include "pch.h"
+
+#include "ThreadPool.h"
+
+namespace Engine
+{
+	namespace
+	{
+		thread_local const ThreadPool* currentPool = nullptr;
+		thread_local unsigned currentWorker = 0;
+	}
+
+	ThreadPool::ThreadPool(unsigned threadCount)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		for (unsigned i = 0; i <= threadCount; i++)
+		{
+			queues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		workers.reserve(threadCount);
+		for (unsigned i = 0; i < threadCount; i++)
+		{
+			workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			stopping = true;
+		}
+
+		wakeCondition.notify_all();
+
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	unsigned ThreadPool::WorkerIndex() const
+	{
+		return (currentPool == this) ? currentWorker : ThreadCount();
+	}
+
+	void ThreadPool::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& function)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		grainSize = std::max<size_t>(grainSize, 1);
+		const size_t chunks = (count + grainSize - 1) / grainSize;
+
+		std::atomic<size_t> remaining = chunks;
+		std::exception_ptr error;
+		std::mutex errorMutex;
+
+		for (size_t chunk = 0; chunk < chunks; chunk++)
+		{
+			const size_t begin = chunk * grainSize;
+			const size_t end = std::min(begin + grainSize, count);
+
+			Push([&, begin, end]()
+				{
+					try
+					{
+						function(begin, end);
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(errorMutex);
+						if (!error)
+						{
+							error = std::current_exception();
+						}
+					}
+
+					remaining.fetch_sub(1, std::memory_order_acq_rel);
+				});
+		}
+
+		// Help out until every chunk of this loop has completed.
+		const unsigned index = WorkerIndex();
+		while (remaining.load(std::memory_order_acquire) > 0)
+		{
+			if (!TryRunTask(index))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	void ThreadPool::Push(std::function<void()> task)
+	{
+		// Workers push onto their own queue; other threads spread tasks round-robin.
+		unsigned index = WorkerIndex();
+		if (index == ThreadCount())
+		{
+			index = nextQueue.fetch_add(1, std::memory_order_relaxed) % ThreadCount();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(queues[index]->mutex);
+			queues[index]->tasks.push_back(std::move(task));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			queuedTasks.fetch_add(1, std::memory_order_release);
+		}
+
+		wakeCondition.notify_one();
+	}
+
+	bool ThreadPool::TryRunTask(unsigned index)
+	{
+		std::function<void()> task;
+
+		// Pop the most recent task from our own queue first.
+		{
+			WorkQueue& own = *queues[index];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (!own.tasks.empty())
+			{
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+			}
+		}
+
+		// Otherwise steal the oldest task from another queue.
+		if (!task)
+		{
+			const unsigned queueCount = unsigned(queues.size());
+			for (unsigned i = 1; i < queueCount && !task; i++)
+			{
+				WorkQueue& victim = *queues[(index + i) % queueCount];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (!victim.tasks.empty())
+				{
+					task = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+				}
+			}
+		}
+
+		if (!task)
+		{
+			return false;
+		}
+
+		queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+		task();
+
+		return true;
+	}
+
+	void ThreadPool::WorkerLoop(unsigned index)
+	{
+		currentPool = this;
+		currentWorker = index;
+
+		while (true)
+		{
+			if (TryRunTask(index))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wakeCondition.wait(lock, [this]() { return stopping || queuedTasks.load(std::memory_order_acquire) > 0; });
+
+			if (stopping && queuedTasks.load(std::memory_order_acquire) == 0)
+			{
+				return;
+			}
+		}
+	}
+}
\ No newline at end of file
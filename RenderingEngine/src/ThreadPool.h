@@ -0,0 +1,76 @@
+#pragma once
+
+#include "pch.h"
+
+namespace Engine
+{
+	/**
+	 * @class ThreadPool
+	 * @brief Fixed-size pool of worker threads with per-worker work-stealing queues.
+	 *
+	 * Each worker owns a queue that it pops from the back (most recently pushed
+	 * first, which keeps nested work cache-warm). When its own queue is empty a
+	 * worker steals from the front of the other queues, so uneven tasks such as
+	 * image tiles with very different costs still keep every core busy.
+	 *
+	 * The thread that calls ParallelFor() participates in the work until the
+	 * loop is complete, which also makes nested ParallelFor() calls from inside
+	 * a task safe.
+	 */
+	class ThreadPool
+	{
+	public:
+
+		/**
+		 * @brief Starts the worker threads.
+		 * @param threadCount Number of workers; zero uses std::thread::hardware_concurrency().
+		 */
+		explicit ThreadPool(unsigned threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		unsigned ThreadCount() const { return unsigned(workers.size()); }
+
+		/**
+		 * @brief Returns the index of the calling thread within this pool.
+		 * @return A value in [0, ThreadCount()) for workers, or ThreadCount() for any other thread.
+		 */
+		unsigned WorkerIndex() const;
+
+		/**
+		 * @brief Runs 'function' over [0, count) in chunks of 'grainSize' and waits for completion.
+		 *
+		 * The function receives a half-open [begin, end) range. If any invocation
+		 * throws, the first exception is rethrown on the calling thread once all
+		 * chunks have finished.
+		 *
+		 * @param count Number of items.
+		 * @param grainSize Number of items per task.
+		 * @param function Callable invoked as function(begin, end).
+		 */
+		void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& function);
+
+	private:
+
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		std::vector<std::thread> workers;
+		std::vector<std::unique_ptr<WorkQueue>> queues; ///< One per worker plus one shared by external threads.
+
+		std::mutex sleepMutex;
+		std::condition_variable wakeCondition;
+		std::atomic<size_t> queuedTasks = 0;
+		std::atomic<unsigned> nextQueue = 0;
+		bool stopping = false;
+
+		void Push(std::function<void()> task);
+		bool TryRunTask(unsigned index);
+		void WorkerLoop(unsigned index);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "pch.h"
+
+#include "TriangleMesh.h"
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief Owned arrays of a mesh built from positions and indices. */
+		struct TriangleMeshStorage
+		{
+			std::vector<Real> positionX;
+			std::vector<Real> positionY;
+			std::vector<Real> positionZ;
+			std::vector<uint32_t> indices;
+			BVHTree tree;
+		};
+	}
+
+	TriangleMesh::TriangleMesh(const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices, uint32_t materialId, const BVHBuildOptions& options)
+	{
+		if (indices.empty() || indices.size() % 3 != 0)
+		{
+			throw std::runtime_error("Triangle mesh indices must describe at least one whole triangle!");
+		}
+
+		const auto storage = std::make_shared<TriangleMeshStorage>();
+
+		storage->positionX.reserve(positions.size());
+		storage->positionY.reserve(positions.size());
+		storage->positionZ.reserve(positions.size());
+
+		for (const Vector3& p : positions)
+		{
+			storage->positionX.push_back(p.x);
+			storage->positionY.push_back(p.y);
+			storage->positionZ.push_back(p.z);
+		}
+
+		const size_t triangleCount = indices.size() / 3;
+
+		std::vector<AABB> bounds;
+		bounds.reserve(triangleCount);
+
+		for (size_t i = 0; i < triangleCount; i++)
+		{
+			AABB box;
+			for (int k = 0; k < 3; k++)
+			{
+				const uint32_t vertex = indices[i * 3 + k];
+				if (vertex >= positions.size())
+				{
+					throw std::runtime_error("Triangle mesh index out of range!");
+				}
+
+				box.Grow(positions[vertex]);
+			}
+
+			bounds.push_back(box);
+		}
+
+		storage->tree.Build(bounds, options);
+
+		// Store the triangles in leaf order so each leaf is a contiguous range.
+		storage->indices.resize(indices.size());
+		for (size_t i = 0; i < triangleCount; i++)
+		{
+			const uint32_t source = storage->tree.primitiveIndices[i];
+
+			storage->indices[i * 3 + 0] = indices[source * 3 + 0];
+			storage->indices[i * 3 + 1] = indices[source * 3 + 1];
+			storage->indices[i * 3 + 2] = indices[source * 3 + 2];
+		}
+
+		arrays.positionX = storage->positionX;
+		arrays.positionY = storage->positionY;
+		arrays.positionZ = storage->positionZ;
+		arrays.indices = storage->indices;
+		arrays.nodes = storage->tree.nodes;
+		arrays.materialId = materialId;
+
+		owner = storage;
+	}
+
+	TriangleMesh::TriangleMesh(const TriangleMeshArrays& arrays, std::shared_ptr<const void> owner) :
+		arrays(arrays), owner(std::move(owner))
+	{
+	}
+
+	bool TriangleMesh::Hit(const Ray& ray, Interval ray_t, HitRecord& record) const
+	{
+		const ShearedRay sheared = Shear(ray);
+
+		Real closestSoFar = ray_t.max;
+		uint32_t closestTriangle = 0;
+		uint64_t nodesVisited = 0;
+
+		const bool hitAnything = BVHTree::Traverse(arrays.nodes.data(), 0, ray, ray_t.min, closestSoFar, nodesVisited, [&](uint32_t first, uint32_t count)
+			{
+				bool hitLeaf = false;
+
+				for (uint32_t triangle = first; triangle < first + count; triangle++)
+				{
+					Real t;
+					if (IntersectTriangle(ray, sheared, triangle, Interval(ray_t.min, closestSoFar), t))
+					{
+						hitLeaf = true;
+						closestSoFar = t;
+						closestTriangle = triangle;
+					}
+				}
+
+				return hitLeaf;
+			});
+
+		if (!hitAnything)
+		{
+			return false;
+		}
+
+		const Vector3 v0 = Position(arrays.indices[closestTriangle * 3 + 0]);
+		const Vector3 v1 = Position(arrays.indices[closestTriangle * 3 + 1]);
+		const Vector3 v2 = Position(arrays.indices[closestTriangle * 3 + 2]);
+
+		record.t = closestSoFar;
+		record.p = ray.At(closestSoFar);
+		record.SetFaceNormal(ray, Vector3::Normalize(Vector3::Cross(v1 - v0, v2 - v0)));
+		record.materialId = arrays.materialId;
+
+		return true;
+	}
+
+	bool TriangleMesh::Occluded(const Ray& ray, Interval ray_t) const
+	{
+		const ShearedRay sheared = Shear(ray);
+		uint64_t nodesVisited = 0;
+
+		return BVHTree::TraverseAny(arrays.nodes.data(), 0, ray, ray_t.min, ray_t.max, nodesVisited, [&](uint32_t first, uint32_t count)
+			{
+				for (uint32_t triangle = first; triangle < first + count; triangle++)
+				{
+					Real t;
+					if (IntersectTriangle(ray, sheared, triangle, ray_t, t))
+					{
+						return true;
+					}
+				}
+
+				return false;
+			});
+	}
+
+	TriangleMesh::ShearedRay TriangleMesh::Shear(const Ray& ray)
+	{
+		ShearedRay sheared;
+
+		// Make the dominant direction axis the new z, keeping the winding order.
+		const Vector3 absDirection(std::abs(ray.direction.x), std::abs(ray.direction.y), std::abs(ray.direction.z));
+		sheared.kz = (absDirection.x > absDirection.y) ? (absDirection.x > absDirection.z ? 0 : 2) : (absDirection.y > absDirection.z ? 1 : 2);
+		sheared.kx = (sheared.kz + 1) % 3;
+		sheared.ky = (sheared.kx + 1) % 3;
+
+		if (ray.direction[sheared.kz] < 0)
+		{
+			std::swap(sheared.kx, sheared.ky);
+		}
+
+		sheared.sx = ray.direction[sheared.kx] / ray.direction[sheared.kz];
+		sheared.sy = ray.direction[sheared.ky] / ray.direction[sheared.kz];
+		sheared.sz = 1 / ray.direction[sheared.kz];
+
+		return sheared;
+	}
+
+	bool TriangleMesh::IntersectTriangle(const Ray& ray, const ShearedRay& sheared, uint32_t triangle, const Interval& ray_t, Real& t) const
+	{
+		const uint32_t i0 = arrays.indices[triangle * 3 + 0];
+		const uint32_t i1 = arrays.indices[triangle * 3 + 1];
+		const uint32_t i2 = arrays.indices[triangle * 3 + 2];
+
+		// Vertices relative to the ray origin.
+		const Vector3 a = Position(i0) - ray.origin;
+		const Vector3 b = Position(i1) - ray.origin;
+		const Vector3 c = Position(i2) - ray.origin;
+
+		// Shear and scale so the ray runs along +z from the origin.
+		const Real ax = a[sheared.kx] - sheared.sx * a[sheared.kz];
+		const Real ay = a[sheared.ky] - sheared.sy * a[sheared.kz];
+		const Real bx = b[sheared.kx] - sheared.sx * b[sheared.kz];
+		const Real by = b[sheared.ky] - sheared.sy * b[sheared.kz];
+		const Real cx = c[sheared.kx] - sheared.sx * c[sheared.kz];
+		const Real cy = c[sheared.ky] - sheared.sy * c[sheared.kz];
+
+		// Scaled barycentric coordinates as 2D edge functions. Each edge is
+		// evaluated from its lower-indexed vertex so the two triangles sharing
+		// it get exactly opposite values, even if the compiler fuses the
+		// multiply-subtract; otherwise a ray could slip through the edge.
+		const auto edge = [](Real px, Real py, uint32_t p, Real qx, Real qy, uint32_t q)
+			{
+				const bool flip = q < p;
+				if (flip)
+				{
+					std::swap(px, qx);
+					std::swap(py, qy);
+				}
+
+				Real e = qx * py - qy * px;
+
+				// An edge function of exactly zero is ambiguous in single
+				// precision; recompute it in double to decide consistently.
+				if constexpr (std::is_same_v<Real, float>)
+				{
+					if (e == 0)
+					{
+						e = Real(double(qx) * double(py) - double(qy) * double(px));
+					}
+				}
+
+				return flip ? -e : e;
+			};
+
+		const Real u = edge(bx, by, i1, cx, cy, i2);
+		const Real v = edge(cx, cy, i2, ax, ay, i0);
+		const Real w = edge(ax, ay, i0, bx, by, i1);
+
+		// The ray misses unless all edge functions share a sign (both facings are accepted).
+		if ((u < 0 || v < 0 || w < 0) && (u > 0 || v > 0 || w > 0))
+		{
+			return false;
+		}
+
+		const Real det = u + v + w;
+		if (det == 0)
+		{
+			return false;
+		}
+
+		const Real az = sheared.sz * a[sheared.kz];
+		const Real bz = sheared.sz * b[sheared.kz];
+		const Real cz = sheared.sz * c[sheared.kz];
+
+		const Real root = (u * az + v * bz + w * cz) / det;
+		if (!ray_t.Surrounds(root))
+		{
+			return false;
+		}
+
+		t = root;
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "pch.h"
+
+#include "Hittable.h"
+#include "BVHTree.h"
+
+#include <span>
+
+namespace Engine
+{
+	/** @brief The arrays a TriangleMesh traces, as built or as stored by a SceneCache. */
+	struct TriangleMeshArrays
+	{
+		std::span<const Real> positionX;
+		std::span<const Real> positionY;
+		std::span<const Real> positionZ;
+		std::span<const uint32_t> indices; ///< Three per triangle, in the leaf order of 'nodes'.
+		std::span<const BVHNode> nodes;	   ///< Flattened BVH over the triangles.
+		uint32_t materialId = 0;
+	};
+
+	/**
+	 * @class TriangleMesh
+	 * @brief Indexed triangle mesh with its own BVH over the triangles.
+	 *
+	 * Vertex positions are kept in structure-of-arrays form and triangles as
+	 * three indices each, reordered to match the leaf ranges of the internal
+	 * BVHTree. The mesh only views its arrays, so a SceneCache can map them
+	 * from disk instead of building them. Intersection uses the watertight ray/triangle test of Woop,
+	 * Benthin and Wald, "Watertight Ray/Triangle Intersection" (JCGT 2013),
+	 * so rays never slip through the shared edges of adjacent triangles.
+	 */
+	class TriangleMesh final : public Hittable
+	{
+	public:
+
+		/**
+		 * @brief Builds a mesh and its BVH.
+		 * @param positions Vertex positions.
+		 * @param indices Three vertex indices per triangle.
+		 * @param materialId Material reported for every hit on the mesh.
+		 * @param options SAH parameters of the triangle BVH.
+		 */
+		TriangleMesh(const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices, uint32_t materialId = 0, const BVHBuildOptions& options = BVHBuildOptions());
+
+		/**
+		 * @brief Traces arrays built earlier in place, without copying or validating them.
+		 * @param arrays Views of a mesh's arrays, e.g. inside a mapped cache file.
+		 * @param owner Keeps the viewed memory alive as long as the mesh.
+		 */
+		TriangleMesh(const TriangleMeshArrays& arrays, std::shared_ptr<const void> owner);
+
+		bool Hit(const Ray& ray, Interval ray_t, HitRecord& record) const override;
+		bool Occluded(const Ray& ray, Interval ray_t) const override;
+		AABB BoundingBox() const override { return arrays.nodes.front().bounds; }
+
+		size_t VertexCount() const { return arrays.positionX.size(); }
+		size_t TriangleCount() const { return arrays.indices.size() / 3; }
+
+		const TriangleMeshArrays& Arrays() const { return arrays; }
+
+	private:
+
+		TriangleMeshArrays arrays;
+		std::shared_ptr<const void> owner; ///< Storage of a built mesh, or the mapped file 'arrays' points into.
+
+		/** @brief Per-ray constants of the watertight test: axis permutation and shear. */
+		struct ShearedRay
+		{
+			int kx, ky, kz;
+			Real sx, sy, sz;
+		};
+
+		Vector3 Position(uint32_t vertex) const { return Vector3(arrays.positionX[vertex], arrays.positionY[vertex], arrays.positionZ[vertex]); }
+
+		static ShearedRay Shear(const Ray& ray);
+
+		/** @brief Watertight test of one triangle; writes the hit distance to 't'. */
+		bool IntersectTriangle(const Ray& ray, const ShearedRay& sheared, uint32_t triangle, const Interval& ray_t, Real& t) const;
+	};
+}
\ No newline at end of file
@@ -23,7 +23,7 @@ namespace Engine
 		constexpr Vector2() : x(0.0), y(0.0) {};
 		constexpr Vector2(double x, double y) : x(x), y(y) {};
 		constexpr Vector2(const Vector2& other) : x(other.x), y(other.y) {};
-		//Vector2& operator=(const Vector2& other);
+		constexpr Vector2& operator=(const Vector2& other) = default;
 		//Vector2(Vector2&& other) noexcept;
 		//Vector2& operator=(Vector2&& other) noexcept;
 
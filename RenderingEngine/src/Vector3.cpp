@@ -5,7 +5,8 @@
 namespace Engine
 {
 	// Assignment operator.
-	Vector3& Vector3::operator=(const Vector3& other)
+	template<typename T>
+	Vector3T<T>& Vector3T<T>::operator=(const Vector3T<T>& other)
 	{
 		if (this == &other) return *this;
 
@@ -17,7 +18,8 @@ namespace Engine
 	}
 
 	// Move constructor.
-	Vector3::Vector3(Vector3&& other) noexcept
+	template<typename T>
+	Vector3T<T>::Vector3T(Vector3T<T>&& other) noexcept
 	{
 		x = other.x;
 		y = other.y;
@@ -29,7 +31,8 @@ namespace Engine
 	}
 
 	// Move assignment operator.
-	Vector3& Vector3::operator=(Vector3&& other) noexcept
+	template<typename T>
+	Vector3T<T>& Vector3T<T>::operator=(Vector3T<T>&& other) noexcept
 	{
 		if (this == &other) return *this;
 
@@ -44,31 +47,36 @@ namespace Engine
 		return *this;
 	}
 
-	double Vector3::Length2() const
+	template<typename T>
+	T Vector3T<T>::Length2() const
 	{
 		return x * x + y * y + z * z;
 	}
 
-	double Vector3::Length() const
+	template<typename T>
+	T Vector3T<T>::Length() const
 	{
 		return std::sqrt(Length2());
 	}
 
-	double Vector3::Dot(const Vector3& u, const Vector3& v)
+	template<typename T>
+	T Vector3T<T>::Dot(const Vector3T<T>& u, const Vector3T<T>& v)
 	{
 		return u.x * v.x + u.y * v.y + u.z * v.z;
 	}
 
-	Vector3 Vector3::Cross(const Vector3& u, const Vector3& v)
+	template<typename T>
+	Vector3T<T> Vector3T<T>::Cross(const Vector3T<T>& u, const Vector3T<T>& v)
 	{
-		return Vector3(u.y * v.z - u.z * v.y,
+		return Vector3T<T>(u.y * v.z - u.z * v.y,
 			u.z * v.x - u.x * v.z,
 			u.x * v.y - u.y * v.x);
 	}
 
-	Vector3& Vector3::Normalize()
+	template<typename T>
+	Vector3T<T>& Vector3T<T>::Normalize()
 	{
-		const double c = 1 / Length();
+		const T c = 1 / Length();
 
 		x *= c;
 		y *= c;
@@ -77,19 +85,22 @@ namespace Engine
 		return *this;
 	}
 
-	Vector3 Vector3::Normalize(const Vector3& v)
+	template<typename T>
+	Vector3T<T> Vector3T<T>::Normalize(const Vector3T<T>& v)
 	{
-		const double c = v.Length();
+		const T c = v.Length();
 
-		return Vector3(v.x / c, v.y / c, v.z / c);
+		return Vector3T<T>(v.x / c, v.y / c, v.z / c);
 	}
 
-	Vector3 Vector3::Lerp(const Vector3& start, const Vector3& end, double t)
+	template<typename T>
+	Vector3T<T> Vector3T<T>::Lerp(const Vector3T<T>& start, const Vector3T<T>& end, T t)
 	{
-		return ((1.0 - t) * start) + (t * end);
+		return ((1 - t) * start) + (t * end);
 	}
 
-	Vector3& Vector3::Clamp(double min, double max)
+	template<typename T>
+	Vector3T<T>& Vector3T<T>::Clamp(T min, T max)
 	{
 		x = std::clamp(x, min, max);
 		y = std::clamp(y, min, max);
@@ -98,14 +109,16 @@ namespace Engine
 		return *this;
 	}
 
-	Vector3 Vector3::Clamp(const Vector3& v, double min, double max)
+	template<typename T>
+	Vector3T<T> Vector3T<T>::Clamp(const Vector3T<T>& v, T min, T max)
 	{
-		return Vector3(std::clamp(v.x, min, max),
+		return Vector3T<T>(std::clamp(v.x, min, max),
 			std::clamp(v.y, min, max),
 			std::clamp(v.z, min, max));
 	}
 
-	std::string Vector3::ToString(int precision) const
+	template<typename T>
+	std::string Vector3T<T>::ToString(int precision) const
 	{
 		std::ostringstream oss;
 		oss << std::fixed << std::setprecision(precision) << x << ' ' << y << ' ' << z;
@@ -114,17 +127,20 @@ namespace Engine
 
 	// Unary operators.
 
-	double Vector3::operator[](int i) const
+	template<typename T>
+	T Vector3T<T>::operator[](int i) const
 	{
 		return data[i];
 	}
 
-	double& Vector3::operator[](int i)
+	template<typename T>
+	T& Vector3T<T>::operator[](int i)
 	{
 		return data[i];
 	}
 
-	Vector3& Vector3::operator+=(const Vector3& v)
+	template<typename T>
+	Vector3T<T>& Vector3T<T>::operator+=(const Vector3T<T>& v)
 	{
 		x += v.x;
 		y += v.y;
@@ -133,7 +149,8 @@ namespace Engine
 		return *this;
 	}
 
-	Vector3& Vector3::operator*=(double t)
+	template<typename T>
+	Vector3T<T>& Vector3T<T>::operator*=(T t)
 	{
 		x *= t;
 		y *= t;
@@ -142,13 +159,18 @@ namespace Engine
 		return *this;
 	}
 
-	Vector3& Vector3::operator/=(double t)
+	template<typename T>
+	Vector3T<T>& Vector3T<T>::operator/=(T t)
 	{
 		return *this *= (1 / t);
 	}
 
-	bool Vector3::operator==(const Vector3& v) const
+	template<typename T>
+	bool Vector3T<T>::operator==(const Vector3T<T>& v) const
 	{
 		return x == v.x && y == v.y && z == v.z;
 	}
+
+	template class Vector3T<float>;
+	template class Vector3T<double>;
 }
\ No newline at end of file
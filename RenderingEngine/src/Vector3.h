@@ -1,18 +1,23 @@
 #pragma once
 
 #include "pch.h"
+#include "Precision.h"
 
 namespace Engine
 {
 	/**
-	 * @class Vector3
+	 * @class Vector3T
 	 * @brief A simple 3D vector class for representing and manipulating 3D vectors.
 	 * 
 	 * Supports common vector operations such as addition, scaling, normalization, 
 	 * dot and cross products, and interpolation. Uses a union for both named 
 	 * access ('x', 'y', 'z') and array-style access via 'data[3]'.
+	 *
+	 * Templated on the scalar type; only float and double are instantiated
+	 * (see Vector3.cpp). The tracer uses the 'Vector3' alias of type Real.
 	 */
-	class Vector3
+	template<typename T>
+	class Vector3T
 	{
 	public:
 
@@ -21,16 +26,16 @@ namespace Engine
 		{
 			struct
 			{
-				double x; ///< X component
-				double y; ///< Y component
-				double z; ///< Z component
+				T x; ///< X component
+				T y; ///< Y component
+				T z; ///< Z component
 			};
 
-			double data[3]; ///< Array-style access to components
+			T data[3]; ///< Array-style access to components
 		};
 
 		/** @brief Default constructor. Initializes all components to zero. */
-		constexpr Vector3() : x(0.0), y(0.0), z(0.0) {};
+		constexpr Vector3T() : x(0.0), y(0.0), z(0.0) {};
 
 		/**
 		 * @brief Parameterized constructor.
@@ -38,60 +43,60 @@ namespace Engine
 		 * @param y The y-component of the vector.
 		 * @param z The z-component of the vector.
 		 */
-		constexpr Vector3(double x, double y, double z) : x(x), y(y), z(z) {};
+		constexpr Vector3T(T x, T y, T z) : x(x), y(y), z(z) {};
 
 		/**
 		 * @brief Copy constructor.
 		 * @param other The vector to copy.
 		 */
-		constexpr Vector3(const Vector3& other) : x(other.x), y(other.y), z(other.z) {};
+		constexpr Vector3T(const Vector3T& other) : x(other.x), y(other.y), z(other.z) {};
 
 		/**
 		 * @brief Assignment operator.
 		 * @param other The vector to copy.
 		 * @return A reference to the copied vector.
 		 */
-		Vector3& operator=(const Vector3& other);
+		Vector3T& operator=(const Vector3T& other);
 
 		/**
 		 * @brief Move constructor.
 		 * @param other The vector to move.
 		 */
-		Vector3(Vector3&& other) noexcept;
+		Vector3T(Vector3T&& other) noexcept;
 
 		/**
 		 * @brief Move assignment operator.
 		 * @param other The vector to move.
 		 * @return A reference to the moved vector.
 		 */
-		Vector3& operator=(Vector3&& other) noexcept;
+		Vector3T& operator=(Vector3T&& other) noexcept;
 
 		/**
 		 * @brief Returns a vector with all components set to zero.
 		 * @return The zero vector.
 		 */
-		static constexpr Vector3 Zero() { return Vector3(0.0, 0.0, 0.0); }
+		static constexpr Vector3T Zero() { return Vector3T(0.0, 0.0, 0.0); }
 
 		/**
 		 * @brief Returns a vector with the y-component set to 1.0.
 		 * @return The up vector.
 		 */
-		static constexpr Vector3 Up() { return Vector3(0.0, 1.0, 0.0); }
+		static constexpr Vector3T Up() { return Vector3T(0.0, 1.0, 0.0); }
 
 		/**
 		 * @brief Returns a vector with the x-component set to 1.0.
 		 * @return The right vector.
 		 */
-		static constexpr Vector3 Right() { return Vector3(1.0, 0.0, 0.0); }
+		static constexpr Vector3T Right() { return Vector3T(1.0, 0.0, 0.0); }
 
 		/**
 		 * @brief Returns a vector with the z-component set to 1.0.
 		 * @return The forward vector.
 		 */
-		static constexpr Vector3 Forward() { return Vector3(0.0, 0.0, 1.0); }
+		static constexpr Vector3T Forward() { return Vector3T(0.0, 0.0, 1.0); }
 
 		/** @brief Unary minus operator. Returns the negation of the vector. */
-		constexpr Vector3 operator-() const { return Vector3(-x, -y, -z); }
+		constexpr Vector3T operator-() const { return Vector3T(-x, -y, -z); }
 
 		/** 
 		 * @brief Unary plus operator. Returns a copy of the vector.
@@ -101,61 +106,61 @@ namespace Engine
 		 * 
 		 * @return A copy of the vector.
 		 */
-		constexpr Vector3 operator+() const { return *this; };
+		constexpr Vector3T operator+() const { return *this; };
 
 		/**
 		 * @brief Read-only access to a component by index. 
 		 * @param i Index (0 = x, 1 = y, 2 = z).
 		 * @return Value of the component.
 		 */
-		double operator[](int i) const;
+		T operator[](int i) const;
 
 		/**
 		 * @brief Mutable access to a component by index.
 		 * @param i Index (0 = x, 1 = y, 2 = z).
 		 * @return Reference to the component.
 		 */
-		double& operator[](int i);
+		T& operator[](int i);
 
 		/**
 		 * @brief Adds another vector to this vector.
 		 * @param v Vector to add.
 		 * @return Reference to this vector.
 		 */
-		Vector3& operator+=(const Vector3& v);
+		Vector3T& operator+=(const Vector3T& v);
 
 		/**
 		 * @brief Multiplies this vector by a scalar.
 		 * @param t Scalar multiplier.
 		 * @return Reference to this vector.
 		 */
-		Vector3& operator*=(double t);
+		Vector3T& operator*=(T t);
 
 		/**
 		 * @brief Divides this vector by a scalar.
 		 * @param t Scalar divisor.
 		 * @return Reference to this vector.
 		 */
-		Vector3& operator/=(double t);
+		Vector3T& operator/=(T t);
 
 		/**
 		 * @brief Checks for equality with another vector.
 		 * @param v Vector to compare.
 		 * @return True if all components are equal, false otherwise.
 		 */
-		bool operator==(const Vector3& v) const;
+		bool operator==(const Vector3T& v) const;
 
 		/** @brief Returns the squared length (magnitude) of the vector. */
-		double Length2() const;
+		T Length2() const;
 
 		/** @brief Returns the length (magnitude) of the vector. */
-		double Length() const;
+		T Length() const;
 
 		/**
 		 * @brief Normalizes this vector in place.
 		 * @return Reference to this vector.
 		 */
-		Vector3& Normalize();
+		Vector3T& Normalize();
 
 		/**
 		 * @brief Computes the dot product of two vectors.
@@ -163,7 +168,7 @@ namespace Engine
 		 * @param v Second vector.
 		 * @return The dot product.
 		 */
-		static double Dot(const Vector3& u, const Vector3& v);
+		static T Dot(const Vector3T& u, const Vector3T& v);
 
 		/**
 		 * @brief Computes the cross product of two vectors.
@@ -171,14 +176,14 @@ namespace Engine
 		 * @param v Second vector.
 		 * @return The resulting vector.
 		 */
-		static Vector3 Cross(const Vector3& u, const Vector3& v);
+		static Vector3T Cross(const Vector3T& u, const Vector3T& v);
 
 		/**
 		 * @brief Returns a normalized copy of the input vector.
 		 * @param v Vector to normalize.
 		 * @return The normalized vector.
 		 */
-		static Vector3 Normalize(const Vector3& v);
+		static Vector3T Normalize(const Vector3T& v);
 
 		/**
 		 * @brief Linearly interpolates between two vectors.
@@ -187,7 +192,7 @@ namespace Engine
 		 * @param t Interpolation factor (0.0 = u, 1.0 = v).
 		 * @return The interpolated vector.
 		 */
-		static Vector3 Lerp(const Vector3& u, const Vector3& v, double t);
+		static Vector3T Lerp(const Vector3T& u, const Vector3T& v, T t);
 
 		/**
 		 * @brief Clamps the components of this vector to a specified range.
@@ -195,7 +200,7 @@ namespace Engine
 		 * @param max The maximum value.
 		 * @return Reference to this vector.
 		 */
-		Vector3& Clamp(double min, double max);
+		Vector3T& Clamp(T min, T max);
 
 		/**
 		 * @brief Clamps the components of a vector to a specified range.
@@ -204,7 +209,7 @@ namespace Engine
 		 * @param max The maximum value.
 		 * @return The clamped vector.
 		 */
-		static Vector3 Clamp(const Vector3& v, double min, double max);
+		static Vector3T Clamp(const Vector3T& v, T min, T max);
 
 		/**
 		 * @brief Converts the vector to a string representation.
@@ -214,6 +219,10 @@ namespace Engine
 		std::string ToString(int precision = 3) const;
 	};
 
+	using Vector3f = Vector3T<float>;
+	using Vector3d = Vector3T<double>;
+	using Vector3 = Vector3T<Real>;
+
 	// *************************
 	// Binary operators.
 	// *************************
@@ -224,7 +233,8 @@ namespace Engine
 	 * @param v The vector to print.
 	 * @return Reference to the output stream.
 	 */
-	inline std::ostream& operator<<(std::ostream& out, const Vector3& v)
+	template<typename T>
+	inline std::ostream& operator<<(std::ostream& out, const Vector3T<T>& v)
 	{
 		return out << v.x << ' ' << v.y << ' ' << v.z;
 	}
@@ -235,9 +245,10 @@ namespace Engine
 	 * @param v Second vector.
 	 * @return Resulting vector.
 	 */
-	inline Vector3 operator+(const Vector3& u, const Vector3& v)
+	template<typename T>
+	inline Vector3T<T> operator+(const Vector3T<T>& u, const Vector3T<T>& v)
 	{
-		return Vector3(u.x + v.x, u.y + v.y, u.z + v.z);
+		return Vector3T<T>(u.x + v.x, u.y + v.y, u.z + v.z);
 	}
 
 	/**
@@ -246,13 +257,15 @@ namespace Engine
 	 * @param v Vector.
 	 * @return Resulting vector.
 	 */
-	inline Vector3 operator+(double t, const Vector3& v)
+	template<typename T>
+	inline Vector3T<T> operator+(std::type_identity_t<T> t, const Vector3T<T>& v)
 	{
-		return Vector3(v.x + t, v.y + t, v.z + t);
+		return Vector3T<T>(v.x + t, v.y + t, v.z + t);
 	}
 
-	/** @copydoc operator+(double, const Vector3&) */
-	inline Vector3 operator+(const Vector3& v, double t)
+	/** @copydoc operator+(std::type_identity_t<T>, const Vector3T<T>&) */
+	template<typename T>
+	inline Vector3T<T> operator+(const Vector3T<T>& v, std::type_identity_t<T> t)
 	{
 		return t + v;
 	}
@@ -263,9 +276,10 @@ namespace Engine
 	 * @param v Vector to subtract.
 	 * @return Resulting vector.
 	 */
-	inline Vector3 operator-(const Vector3& u, const Vector3& v)
+	template<typename T>
+	inline Vector3T<T> operator-(const Vector3T<T>& u, const Vector3T<T>& v)
 	{
-		return Vector3(u.x - v.x, u.y - v.y, u.z - v.z);
+		return Vector3T<T>(u.x - v.x, u.y - v.y, u.z - v.z);
 	}
 
 	/**
@@ -274,9 +288,10 @@ namespace Engine
 	 * @param t Scalar to subtract.
 	 * @return Resulting vector.
 	 */
-	inline Vector3 operator-(const Vector3& v, double t)
+	template<typename T>
+	inline Vector3T<T> operator-(const Vector3T<T>& v, std::type_identity_t<T> t)
 	{
-		return Vector3(v.x - t, v.y - t, v.z - t);
+		return Vector3T<T>(v.x - t, v.y - t, v.z - t);
 	}
 
 	/**
@@ -285,9 +300,10 @@ namespace Engine
 	 * @param v Second vector.
 	 * @return Resulting vector.
 	 */
-	inline Vector3 operator*(const Vector3& u, const Vector3& v)
+	template<typename T>
+	inline Vector3T<T> operator*(const Vector3T<T>& u, const Vector3T<T>& v)
 	{
-		return Vector3(u.x * v.x, u.y * v.y, u.z * v.z);
+		return Vector3T<T>(u.x * v.x, u.y * v.y, u.z * v.z);
 	}
 
 	/**
@@ -296,13 +312,15 @@ namespace Engine
 	 * @param v Vector.
 	 * @return Resulting vector.
 	 */
-	inline Vector3 operator*(double t, const Vector3& v)
+	template<typename T>
+	inline Vector3T<T> operator*(std::type_identity_t<T> t, const Vector3T<T>& v)
 	{
-		return Vector3(v.x * t, v.y * t, v.z * t);
+		return Vector3T<T>(v.x * t, v.y * t, v.z * t);
 	}
 
-	/** @copydoc operator*(double, const Vector3&) */
-	inline Vector3 operator*(const Vector3& v, double t)
+	/** @copydoc operator*(std::type_identity_t<T>, const Vector3T<T>&) */
+	template<typename T>
+	inline Vector3T<T> operator*(const Vector3T<T>& v, std::type_identity_t<T> t)
 	{
 		return t * v;
 	}
@@ -313,7 +331,8 @@ namespace Engine
 	 * @param t Scalar divisor.
 	 * @return Resulting vector.
 	 */
-	inline Vector3 operator/(const Vector3& v, double t)
+	template<typename T>
+	inline Vector3T<T> operator/(const Vector3T<T>& v, std::type_identity_t<T> t)
 	{
 		return (1 / t) * v;
 	}
@@ -0,0 +1,320 @@
+#include "pch.h"
+
+#include "WideBVHTree.h"
+
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		/// Exit distances are scaled by this to cover the rounding of the single-precision slab tests.
+		constexpr float RobustExit = 1.0f + 4 * std::numeric_limits<float>::epsilon();
+
+		/// Children are not pulled into a node whose grid would grow their surface area by more than this.
+		constexpr double MaxQuantizationGrowth = 1.5;
+
+		/** @brief Returns 2^exponent for an exponent of a normal float. */
+		float Scale(int exponent)
+		{
+			return std::bit_cast<float>(uint32_t(exponent + 127) << 23);
+		}
+
+		/**
+		 * @brief Widening of a child's slab on 'axis' that covers rounding the ray origin and the decoded bounds to float.
+		 *
+		 * Both are absolute errors of up to half an ulp of the coordinates, so
+		 * far from the world origin they outgrow the relative RobustExit.
+		 */
+		float SlabMargin(const WideBVHNode& node, int axis, float rayOrigin)
+		{
+			const float boundMagnitude = std::abs(node.origin[axis]) + 255.0f * Scale(node.exponent[axis]);
+			return std::numeric_limits<float>::epsilon() * (std::abs(rayOrigin) + boundMagnitude);
+		}
+
+		/** @brief Grid coordinate 'q' of an axis; exact up to the final rounding since q * scale is exact. */
+		float Decode(float origin, float scale, int q)
+		{
+			return origin + float(q) * scale;
+		}
+
+		/**
+		 * @brief Quantizes the child boxes of 'node' against their union 'bounds'.
+		 *
+		 * Each axis starts from the finest power-of-two step that spans the
+		 * parent in 255 steps, rounds every child outwards and checks the
+		 * decoded value against the exact bound. If rounding pushes a child
+		 * past the grid the step is doubled and the axis done again.
+		 */
+		void Quantize(WideBVHNode& node, const AABB& bounds, const AABB* children, int count)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const Interval& extent = bounds.Axis(axis);
+
+				float origin = float(extent.min);
+				if (double(origin) > double(extent.min))
+				{
+					origin = std::nextafter(origin, -std::numeric_limits<float>::infinity());
+				}
+
+				const double step = (double(extent.max) - origin) / 255.0;
+
+				int exponent = -126;
+				if (step > 0.0)
+				{
+					std::frexp(step, &exponent);
+					exponent = std::clamp(exponent, -126, 127);
+				}
+
+				for (;; exponent++)
+				{
+					const float scale = Scale(exponent);
+					bool fits = true;
+
+					for (int i = 0; i < count && fits; i++)
+					{
+						const Interval& child = children[i].Axis(axis);
+
+						int lower = int(std::clamp(std::floor((double(child.min) - origin) / scale), 0.0, 255.0));
+						while (lower > 0 && Decode(origin, scale, lower) > child.min)
+						{
+							lower--;
+						}
+
+						int upper = int(std::clamp(std::ceil((double(child.max) - origin) / scale), 0.0, 255.0));
+						while (upper < 255 && Decode(origin, scale, upper) < child.max)
+						{
+							upper++;
+						}
+
+						fits = Decode(origin, scale, upper) >= child.max;
+						node.lower[axis][i] = uint8_t(lower);
+						node.upper[axis][i] = uint8_t(upper);
+					}
+
+					if (fits || exponent == 127)
+					{
+						break;
+					}
+				}
+
+				node.origin[axis] = origin;
+				node.exponent[axis] = int8_t(exponent);
+			}
+		}
+
+		/**
+		 * @brief Returns true if 'box' stays tight on the 8-bit grid of 'parent'.
+		 *
+		 * Rounding outwards can grow a box by up to one grid step per side. A
+		 * small box beside a huge sibling (a ground sphere, say) would grow to
+		 * many times its size and be entered by rays that miss it.
+		 */
+		bool QuantizesTightly(const AABB& parent, const AABB& box)
+		{
+			const double stepX = parent.x.Size() / 255.0;
+			const double stepY = parent.y.Size() / 255.0;
+			const double stepZ = parent.z.Size() / 255.0;
+
+			const double dx = box.x.Size() + 2 * stepX;
+			const double dy = box.y.Size() + 2 * stepY;
+			const double dz = box.z.Size() + 2 * stepZ;
+
+			return 2 * (dx * dy + dy * dz + dz * dx) <= MaxQuantizationGrowth * box.SurfaceArea();
+		}
+
+#if defined(__AVX2__)
+		/** @brief Widens eight quantized bytes to floats. */
+		__m256 Unpack(const uint8_t* bytes)
+		{
+			return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes))));
+		}
+#endif
+	}
+
+	void WideBVHTree::Build(const BVHTree& tree)
+	{
+		struct BuildTask
+		{
+			uint32_t node;	 ///< Wide node to fill.
+			uint32_t source; ///< Binary node it is collapsed from.
+		};
+
+		nodes.clear();
+		primitiveIndices.clear();
+
+		if (tree.Empty())
+		{
+			return;
+		}
+
+		primitiveIndices.reserve(tree.primitiveIndices.size());
+		nodes.reserve(tree.nodes.size() / 4 + 1);
+		nodes.emplace_back();
+
+		std::vector<BuildTask> tasks;
+		tasks.push_back({ 0, 0 });
+
+		while (!tasks.empty())
+		{
+			const BuildTask task = tasks.back();
+			tasks.pop_back();
+
+			const BVHNode& source = tree.nodes[task.source];
+
+			uint32_t children[Width];
+			int count = 0;
+
+			if (source.IsLeaf())
+			{
+				children[count++] = task.source;
+			}
+			else
+			{
+				children[count++] = source.leftFirst;
+				children[count++] = source.leftFirst + 1;
+			}
+
+			// Open the largest interior child until the node is full or holds only leaves. Children
+			// whose own children would be coarse on this node's grid get a wide node of their own.
+			while (count < Width)
+			{
+				int open = -1;
+				Real openArea = -1;
+
+				for (int i = 0; i < count; i++)
+				{
+					const BVHNode& child = tree.nodes[children[i]];
+					if (!child.IsLeaf() && child.bounds.SurfaceArea() > openArea &&
+						QuantizesTightly(source.bounds, tree.nodes[child.leftFirst].bounds) &&
+						QuantizesTightly(source.bounds, tree.nodes[child.leftFirst + 1].bounds))
+					{
+						open = i;
+						openArea = child.bounds.SurfaceArea();
+					}
+				}
+
+				if (open < 0)
+				{
+					break;
+				}
+
+				const uint32_t left = tree.nodes[children[open]].leftFirst;
+				children[open] = left;
+				children[count++] = left + 1;
+			}
+
+			WideBVHNode node = {};
+			AABB childBounds[Width];
+			for (int i = 0; i < count; i++)
+			{
+				childBounds[i] = tree.nodes[children[i]].bounds;
+			}
+
+			Quantize(node, source.bounds, childBounds, count);
+
+			// Interior children get consecutive nodes; leaf children append their primitives in slot order.
+			node.childMask = uint8_t((1u << count) - 1);
+			node.childBase = uint32_t(nodes.size());
+			node.primitiveBase = uint32_t(primitiveIndices.size());
+
+			uint32_t interiorCount = 0;
+			for (int i = 0; i < count; i++)
+			{
+				const BVHNode& child = tree.nodes[children[i]];
+
+				if (child.IsLeaf())
+				{
+					if (child.count > MaxLeafSize)
+					{
+						throw std::invalid_argument("WideBVHTree::Build requires leaves of at most 127 primitives!");
+					}
+
+					node.meta[i] = uint8_t(child.count);
+					primitiveIndices.insert(primitiveIndices.end(), tree.primitiveIndices.begin() + child.leftFirst, tree.primitiveIndices.begin() + child.leftFirst + child.count);
+				}
+				else
+				{
+					node.meta[i] = uint8_t(0x80 | interiorCount);
+					tasks.push_back({ node.childBase + interiorCount, children[i] });
+					interiorCount++;
+				}
+			}
+
+			nodes.resize(nodes.size() + interiorCount);
+			nodes[task.node] = node;
+		}
+	}
+
+	WideBVHTree::RayData WideBVHTree::Prepare(const Ray& ray)
+	{
+		RayData data;
+		data.origin[0] = float(ray.origin.x);
+		data.origin[1] = float(ray.origin.y);
+		data.origin[2] = float(ray.origin.z);
+		data.invDirection[0] = float(1 / ray.direction.x);
+		data.invDirection[1] = float(1 / ray.direction.y);
+		data.invDirection[2] = float(1 / ray.direction.z);
+
+		return data;
+	}
+
+	uint32_t WideBVHTree::IntersectChildren(const WideBVHNode& node, const RayData& ray, float tMin, float tMax, float* tEntry)
+	{
+#if defined(__AVX2__)
+		__m256 entry = _mm256_set1_ps(tMin);
+		__m256 exit = _mm256_set1_ps(tMax);
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const __m256 scale = _mm256_set1_ps(Scale(node.exponent[axis]));
+			const __m256 origin = _mm256_set1_ps(node.origin[axis]);
+			const __m256 margin = _mm256_set1_ps(SlabMargin(node, axis, ray.origin[axis]));
+			const __m256 lower = _mm256_sub_ps(_mm256_fmadd_ps(Unpack(node.lower[axis]), scale, origin), margin);
+			const __m256 upper = _mm256_add_ps(_mm256_fmadd_ps(Unpack(node.upper[axis]), scale, origin), margin);
+
+			const __m256 rayOrigin = _mm256_set1_ps(ray.origin[axis]);
+			const __m256 invDirection = _mm256_set1_ps(ray.invDirection[axis]);
+			const __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(lower, rayOrigin), invDirection);
+			const __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(upper, rayOrigin), invDirection);
+
+			entry = _mm256_max_ps(_mm256_min_ps(t0, t1), entry);
+			exit = _mm256_min_ps(_mm256_max_ps(t0, t1), exit);
+		}
+
+		exit = _mm256_mul_ps(exit, _mm256_set1_ps(RobustExit));
+		_mm256_storeu_ps(tEntry, entry);
+
+		return uint32_t(_mm256_movemask_ps(_mm256_cmp_ps(entry, exit, _CMP_LE_OQ))) & node.childMask;
+#else
+		uint32_t hits = 0;
+
+		for (int i = 0; i < Width; i++)
+		{
+			float entry = tMin;
+			float exit = tMax;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const float scale = Scale(node.exponent[axis]);
+				const float margin = SlabMargin(node, axis, ray.origin[axis]);
+				const float t0 = (Decode(node.origin[axis], scale, node.lower[axis][i]) - margin - ray.origin[axis]) * ray.invDirection[axis];
+				const float t1 = (Decode(node.origin[axis], scale, node.upper[axis][i]) + margin - ray.origin[axis]) * ray.invDirection[axis];
+
+				entry = std::max(std::min(t0, t1), entry);
+				exit = std::min(std::max(t0, t1), exit);
+			}
+
+			tEntry[i] = entry;
+			hits |= uint32_t(entry <= exit * RobustExit) << i;
+		}
+
+		return hits & node.childMask;
+#endif
+	}
+}
\ No newline at end of file
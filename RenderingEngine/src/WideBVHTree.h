@@ -0,0 +1,222 @@
+#pragma once
+
+#include "pch.h"
+
+#include "BVHTree.h"
+
+namespace Engine
+{
+	/**
+	 * @brief A node of a WideBVHTree: up to eight children with 8-bit quantized bounds.
+	 *
+	 * Child boxes lie on a grid local to the node. Along each axis child i
+	 * spans origin + lower[axis][i] * 2^exponent[axis] to
+	 * origin + upper[axis][i] * 2^exponent[axis], with the grid rounded
+	 * outwards so the decoded single-precision box always encloses the child.
+	 * The bytes are axis-major, so one 8-byte load holds a plane of all
+	 * eight children. At 80 bytes a node is smaller than the seven binary
+	 * nodes (392 bytes) it replaces.
+	 */
+	struct WideBVHNode
+	{
+		float origin[3];
+		int8_t exponent[3];
+		uint8_t childMask;		///< Bit i is set if slot i holds a child.
+		uint32_t childBase;		///< Node index of the first interior child; interior children are stored together.
+		uint32_t primitiveBase; ///< First primitive of the first leaf child; leaf children's ranges follow each other in slot order.
+		uint8_t meta[8];		///< Interior child: 0x80 | index after 'childBase'. Leaf child: its primitive count.
+		uint8_t lower[3][8];
+		uint8_t upper[3][8];
+	};
+
+	static_assert(sizeof(WideBVHNode) == 80);
+
+	/**
+	 * @class WideBVHTree
+	 * @brief Compressed 8-wide BVH collapsed from a BVHTree, for single-ray traversal.
+	 *
+	 * A binary tree stores each box in six Reals and visits one node per box
+	 * test. Here a node tests all eight children against the ray at once
+	 * (one AVX2 register per slab), and the whole tree takes several times
+	 * less memory, so far more of a large scene's hierarchy stays in cache.
+	 *
+	 * Box tests run in single precision. Each slab is widened by the
+	 * rounding of the ray origin and of its bounds, and the exit distances
+	 * by a few ulps, so rounding never culls a box the ray touches, however
+	 * far the scene lies from the world origin. Leaves are
+	 * those of the binary tree, so the tree refits by collapsing again.
+	 */
+	class WideBVHTree
+	{
+	public:
+
+		static constexpr int Width = 8;
+
+		/// Largest leaf the node format can hold.
+		static constexpr uint32_t MaxLeafSize = 127;
+
+		std::vector<WideBVHNode> nodes;
+		std::vector<uint32_t> primitiveIndices; ///< Same meaning as BVHTree::primitiveIndices, in this tree's leaf order.
+
+		/** @brief Ray origin and inverse direction in the precision of the child tests. */
+		struct RayData
+		{
+			float origin[3];
+			float invDirection[3];
+		};
+
+		/**
+		 * @brief Collapses a built binary tree.
+		 *
+		 * Each wide node starts from the two children of a binary node and
+		 * repeatedly opens the interior child with the largest surface area
+		 * until it has eight children or only leaves. Children whose own
+		 * children would quantize coarsely on the node's grid stay closed.
+		 *
+		 * @throws std::invalid_argument if a leaf of 'tree' holds more than MaxLeafSize primitives.
+		 */
+		void Build(const BVHTree& tree);
+
+		/**
+		 * @brief Tests a ray against every child of 'node'.
+		 * @param tEntry Receives the entry distance of each child.
+		 * @return Mask of the children overlapping the ray within [tMin, tMax].
+		 */
+		static uint32_t IntersectChildren(const WideBVHNode& node, const RayData& ray, float tMin, float tMax, float* tEntry);
+
+		static RayData Prepare(const Ray& ray);
+
+		/**
+		 * @brief Ordered closest-hit traversal with the contract of BVHTree::Traverse().
+		 *
+		 * Children that are hit are pushed far to near, so leaves are tested
+		 * front to back and anything behind the closest hit is skipped.
+		 */
+		template<typename LeafFunction>
+		bool Traverse(const Ray& ray, Real tMin, Real& closestSoFar, uint64_t& nodesVisited, LeafFunction&& intersectLeaf) const
+		{
+			struct StackEntry
+			{
+				uint32_t index; ///< Node index, or first primitive of a leaf.
+				uint32_t count; ///< Zero for a node, primitive count for a leaf.
+				float tEntry;
+			};
+
+			const RayData data = Prepare(ray);
+
+			StackEntry stack[Width * BVHTree::MaxDepth];
+			int stackSize = 0;
+			bool hitAnything = false;
+
+			stack[stackSize++] = { 0, 0, float(tMin) };
+
+			while (stackSize > 0)
+			{
+				const StackEntry entry = stack[--stackSize];
+
+				if (entry.tEntry > closestSoFar)
+				{
+					continue;
+				}
+
+				if (entry.count > 0)
+				{
+					hitAnything |= intersectLeaf(entry.index, entry.count);
+					continue;
+				}
+
+				const WideBVHNode& node = nodes[entry.index];
+				nodesVisited++;
+
+				float tEntry[Width];
+				const uint32_t hits = IntersectChildren(node, data, float(tMin), float(closestSoFar), tEntry);
+
+				// Insertion sort the children hit by decreasing distance.
+				StackEntry children[Width];
+				int childCount = 0;
+				uint32_t primitive = node.primitiveBase;
+
+				for (int i = 0; i < Width; i++)
+				{
+					const uint8_t meta = node.meta[i];
+					const bool interior = (meta & 0x80) != 0;
+
+					if ((hits >> i) & 1)
+					{
+						const StackEntry child = interior ? StackEntry{ node.childBase + (meta & 0x7f), 0, tEntry[i] } : StackEntry{ primitive, meta, tEntry[i] };
+
+						int k = childCount++;
+						for (; k > 0 && children[k - 1].tEntry < child.tEntry; k--)
+						{
+							children[k] = children[k - 1];
+						}
+						children[k] = child;
+					}
+
+					if (!interior)
+					{
+						primitive += meta;
+					}
+				}
+
+				for (int i = 0; i < childCount; i++)
+				{
+					stack[stackSize++] = children[i];
+				}
+			}
+
+			return hitAnything;
+		}
+
+		/** @brief Any-hit traversal with the contract of BVHTree::TraverseAny(); leaves are tested as soon as they are hit. */
+		template<typename LeafFunction>
+		bool TraverseAny(const Ray& ray, Real tMin, Real tMax, uint64_t& nodesVisited, LeafFunction&& intersectLeaf) const
+		{
+			const RayData data = Prepare(ray);
+
+			uint32_t stack[Width * BVHTree::MaxDepth];
+			int stackSize = 0;
+
+			stack[stackSize++] = 0;
+
+			while (stackSize > 0)
+			{
+				const WideBVHNode& node = nodes[stack[--stackSize]];
+				nodesVisited++;
+
+				float tEntry[Width];
+				const uint32_t hits = IntersectChildren(node, data, float(tMin), float(tMax), tEntry);
+
+				uint32_t primitive = node.primitiveBase;
+				for (int i = 0; i < Width; i++)
+				{
+					const uint8_t meta = node.meta[i];
+
+					if (meta & 0x80)
+					{
+						if ((hits >> i) & 1)
+						{
+							stack[stackSize++] = node.childBase + (meta & 0x7f);
+						}
+
+						continue;
+					}
+
+					if (((hits >> i) & 1) && intersectLeaf(primitive, uint32_t(meta)))
+					{
+						return true;
+					}
+
+					primitive += meta;
+				}
+			}
+
+			return false;
+		}
+
+		bool Empty() const { return nodes.empty(); }
+
+		/** @brief Bytes taken by the nodes. */
+		size_t NodeBytes() const { return nodes.size() * sizeof(WideBVHNode); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,886 @@
+#include "pch.h"
+
+#include "CpuRenderer.h"
+
+#include <bit>
+
+namespace Engine
+{
+	namespace
+	{
+		/// Sampler dimensions read by the camera: the pixel jitter.
+		constexpr uint32_t CameraDimensions = 1;
+
+		/// Sampler dimensions of each path vertex: the light sample, the Russian
+		/// roulette and two for the material's Scatter().
+		constexpr uint32_t VertexDimensions = 4;
+
+		/** @brief Spreads the low 10 bits of 'v' so that two zero bits follow each one. */
+		uint32_t ExpandBits(uint32_t v)
+		{
+			v = (v * 0x00010001u) & 0xFF0000FFu;
+			v = (v * 0x00000101u) & 0x0F00F00Fu;
+			v = (v * 0x00000011u) & 0xC30C30C3u;
+			v = (v * 0x00000005u) & 0x49249249u;
+
+			return v;
+		}
+
+		/** @brief 30-bit Morton code of a point given in [0, 1]^3. */
+		uint32_t MortonCode(Real x, Real y, Real z)
+		{
+			const auto quantize = [](Real v) { return uint32_t(std::clamp(v * 1024, Real(0), Real(1023))); };
+
+			return (ExpandBits(quantize(x)) << 2) | (ExpandBits(quantize(y)) << 1) | ExpandBits(quantize(z));
+		}
+
+		/** @brief Number of leading bits two 33-bit ray keys have in common. */
+		int SharedKeyBits(uint64_t a, uint64_t b)
+		{
+			return std::countl_zero(a ^ b) - (64 - 33);
+		}
+	}
+
+	CpuRenderer::CpuRenderer(int imageWidth, int imageHeight, const CpuRenderSettings& settings) :
+		width(imageWidth), height(imageHeight), settings(settings), pool(settings.threadCount)
+	{
+		if (width <= 0 || height <= 0)
+		{
+			throw std::runtime_error("CPU renderer image dimensions must be positive!");
+		}
+
+		this->settings.tileSize = std::max(this->settings.tileSize, 1);
+		this->settings.samplesPerPixel = std::max(this->settings.samplesPerPixel, 1);
+		this->settings.packetSize = std::clamp(this->settings.packetSize, 0, 8);
+		this->settings.adaptiveThreshold = std::max(this->settings.adaptiveThreshold, 0.0);
+		this->settings.adaptiveMinSamples = std::max(this->settings.adaptiveMinSamples, 2);
+		this->settings.maxDepth = std::max(this->settings.maxDepth, 1);
+		this->settings.wavefrontSize = std::max(this->settings.wavefrontSize, 1);
+		this->settings.sunAngle = std::clamp(this->settings.sunAngle, 0.0, 0.5 * PI);
+
+		if (this->settings.sunDirection.Length2() > 0)
+		{
+			this->settings.sunDirection = Vector3::Normalize(this->settings.sunDirection);
+		}
+
+		accumulation.assign(size_t(width) * height * 3, 0.0f);
+		estimates.assign(size_t(width) * height, PixelEstimate());
+		albedoAccumulation.assign(size_t(width) * height * 3, 0.0f);
+		normalAccumulation.assign(size_t(width) * height * 3, 0.0f);
+		depthAccumulation.assign(size_t(width) * height, 0.0f);
+	}
+
+	void CpuRenderer::Render(const Camera& camera, const Hittable& world, const MaterialTable* materials)
+	{
+		if (camera.ImageWidth() != width || camera.ImageHeight() != height)
+		{
+			throw std::runtime_error("Camera image size does not match the CPU renderer!");
+		}
+
+		const int tileSize = settings.tileSize;
+		const int samples = settings.samplesPerPixel;
+		const int tilesX = (width + tileSize - 1) / tileSize;
+		const int tilesY = (height + tileSize - 1) / tileSize;
+
+		stats = CpuRenderStats();
+		reorderedPairs = 0;
+		stats.tiles.resize(size_t(tilesX) * tilesY);
+
+		for (size_t tile = 0; tile < stats.tiles.size(); tile++)
+		{
+			TileTiming& timing = stats.tiles[tile];
+			timing.x = int(tile % tilesX) * tileSize;
+			timing.y = int(tile / tilesX) * tileSize;
+			timing.width = std::min(tileSize, width - timing.x);
+			timing.height = std::min(tileSize, height - timing.y);
+			timing.worker = 0;
+			timing.milliseconds = 0.0;
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		TraceCounters traced;
+
+		if (settings.adaptiveThreshold <= 0.0)
+		{
+			traced = RenderPass(camera, world, materials, samples);
+		}
+		else
+		{
+			// Spend the same total budget as uniform sampling, split evenly over the
+			// pixels that are still noisy after each pass.
+			const uint64_t budget = uint64_t(samples) * width * height;
+
+			while (traced.paths < budget)
+			{
+				uint64_t active = 0;
+				for (const PixelEstimate& estimate : estimates)
+				{
+					active += !Converged(estimate);
+				}
+
+				if (active == 0)
+				{
+					break;
+				}
+
+				const uint64_t perPixel = (budget - traced.paths) / active;
+				const int passSamples = int(std::clamp<uint64_t>(perPixel, 1, uint64_t(settings.adaptiveMinSamples)));
+
+				traced += RenderPass(camera, world, materials, passSamples);
+			}
+
+			for (const PixelEstimate& estimate : estimates)
+			{
+				stats.convergedPixels += Converged(estimate);
+			}
+		}
+
+		stats.rays = traced.rays;
+		stats.paths = traced.paths;
+		stats.pathSegments = traced.segments;
+
+		if (reorderedPairs > 0)
+		{
+			stats.keySimilarityBefore /= double(reorderedPairs);
+			stats.keySimilarityAfter /= double(reorderedPairs);
+		}
+
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		sampleCount += samples;
+		stats.renderTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	CpuRenderStats CpuRenderer::Benchmark(const Camera& camera, const Hittable& world, const MaterialTable* materials, int frames)
+	{
+		Clear();
+		Render(camera, world, materials);
+
+		CpuRenderStats total;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			Clear();
+			Render(camera, world, materials);
+
+			total.renderTimeMs += stats.renderTimeMs;
+			total.rays += stats.rays;
+			total.paths += stats.paths;
+			total.pathSegments += stats.pathSegments;
+			total.convergedPixels += stats.convergedPixels;
+			total.passes += stats.passes;
+			total.reorderedRays += stats.reorderedRays;
+			total.tiles = stats.tiles;
+		}
+
+		return total;
+	}
+
+	std::string CpuRenderStats::Summary() const
+	{
+		char line[256];
+		std::snprintf(line, sizeof(line), "%.1f ms, %.2f Mrays/s, %llu rays, %llu paths, mean path length %.2f",
+			renderTimeMs, RaysPerSecond() / 1e6, (unsigned long long)rays, (unsigned long long)paths, MeanPathLength());
+
+		return line;
+	}
+
+	CpuRenderer::TraceCounters CpuRenderer::RenderPass(const Camera& camera, const Hittable& world, const MaterialTable* materials, int samples)
+	{
+		if (settings.wavefront)
+		{
+			stats.passes++;
+			return RenderWavefront(camera, world, materials, samples);
+		}
+
+		TraceCounters total;
+		std::mutex totalMutex;
+
+		pool.ParallelFor(stats.tiles.size(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t tile = begin; tile < end; tile++)
+				{
+					const auto tileStart = std::chrono::high_resolution_clock::now();
+
+					TileTiming& timing = stats.tiles[tile];
+					timing.worker = pool.WorkerIndex();
+
+					const TraceCounters counters = (settings.packetSize > 1) ?
+						RenderTilePackets(timing, camera, world, materials, samples) :
+						RenderTile(timing, camera, world, materials, samples);
+
+					{
+						std::lock_guard<std::mutex> lock(totalMutex);
+						total += counters;
+					}
+
+					const auto tileEnd = std::chrono::high_resolution_clock::now();
+					timing.milliseconds += std::chrono::duration<double, std::milli>(tileEnd - tileStart).count();
+				}
+			});
+
+		stats.passes++;
+
+		return total;
+	}
+
+	bool CpuRenderer::Converged(const PixelEstimate& estimate) const
+	{
+		if (settings.adaptiveThreshold <= 0.0 || estimate.samples < uint32_t(settings.adaptiveMinSamples))
+		{
+			return false;
+		}
+
+		// 95% confidence half-width of the mean, relative to the mean itself so the
+		// threshold behaves the same in dark and bright regions.
+		const double halfWidth = 1.96 * std::sqrt(estimate.Variance() / estimate.samples);
+
+		return halfWidth <= settings.adaptiveThreshold * std::max(estimate.mean, 1e-3);
+	}
+
+	void CpuRenderer::Clear()
+	{
+		std::fill(accumulation.begin(), accumulation.end(), 0.0f);
+		std::fill(estimates.begin(), estimates.end(), PixelEstimate());
+		std::fill(albedoAccumulation.begin(), albedoAccumulation.end(), 0.0f);
+		std::fill(normalAccumulation.begin(), normalAccumulation.end(), 0.0f);
+		std::fill(depthAccumulation.begin(), depthAccumulation.end(), 0.0f);
+		sampleCount = 0;
+	}
+
+	std::vector<float> CpuRenderer::Resolve() const
+	{
+		return ResolveAov(accumulation, 3);
+	}
+
+	std::vector<float> CpuRenderer::ResolveAlbedo() const
+	{
+		return ResolveAov(albedoAccumulation, 3);
+	}
+
+	std::vector<float> CpuRenderer::ResolveNormal() const
+	{
+		return ResolveAov(normalAccumulation, 3);
+	}
+
+	std::vector<float> CpuRenderer::ResolveDepth() const
+	{
+		return ResolveAov(depthAccumulation, 1);
+	}
+
+	std::vector<float> CpuRenderer::ResolveVariance() const
+	{
+		std::vector<float> variance(estimates.size(), 0.0f);
+
+		for (size_t i = 0; i < estimates.size(); i++)
+		{
+			if (estimates[i].samples > 0)
+			{
+				variance[i] = float(estimates[i].Variance() / estimates[i].samples);
+			}
+		}
+
+		return variance;
+	}
+
+	std::vector<float> CpuRenderer::ResolveAov(const std::vector<float>& sums, size_t channels) const
+	{
+		std::vector<float> image(sums.size(), 0.0f);
+
+		for (size_t i = 0; i < estimates.size(); i++)
+		{
+			if (estimates[i].samples == 0)
+			{
+				continue;
+			}
+
+			const float scale = 1.0f / estimates[i].samples;
+			for (size_t c = 0; c < channels; c++)
+			{
+				image[i * channels + c] = sums[i * channels + c] * scale;
+			}
+		}
+
+		return image;
+	}
+
+	std::vector<float> CpuRenderer::Denoise(const DenoiserSettings& denoiserSettings)
+	{
+		Denoiser denoiser(pool, denoiserSettings);
+
+		return denoiser.Denoise(Resolve(), ResolveAlbedo(), ResolveNormal(), ResolveDepth(), ResolveVariance(), width, height);
+	}
+
+	std::vector<float> CpuRenderer::SampleCountHeatmap() const
+	{
+		uint32_t maxSamples = 0;
+		for (const PixelEstimate& estimate : estimates)
+		{
+			maxSamples = std::max(maxSamples, estimate.samples);
+		}
+
+		std::vector<float> heatmap(estimates.size(), 0.0f);
+		if (maxSamples == 0)
+		{
+			return heatmap;
+		}
+
+		for (size_t i = 0; i < estimates.size(); i++)
+		{
+			heatmap[i] = float(estimates[i].samples) / maxSamples;
+		}
+
+		return heatmap;
+	}
+
+	CpuRenderer::TraceCounters CpuRenderer::RenderTile(const TileTiming& tile, const Camera& camera, const Hittable& world, const MaterialTable* materials, int samples)
+	{
+		const Interval ray_t(Real(0.001), std::numeric_limits<Real>::infinity());
+		TraceCounters counters;
+
+		for (int y = tile.y; y < tile.y + tile.height; y++)
+		{
+			for (int x = tile.x; x < tile.x + tile.width; x++)
+			{
+				const size_t index = size_t(y) * width + x;
+				PixelEstimate& estimate = estimates[index];
+
+				if (Converged(estimate))
+				{
+					continue;
+				}
+
+				Vector3 color;
+				for (int s = 0; s < samples; s++)
+				{
+					Sampler sampler(settings.sampler, x, y, estimate.samples, settings.seed);
+					const Ray ray = camera.GetJitteredRay(x, y, sampler);
+
+					HitRecord record{};
+					const bool hit = world.Hit(ray, ray_t, record);
+					AccumulateAov(index, ray, hit, record, materials);
+
+					const Vector3 sample = TracePath(ray, hit, record, world, materials, sampler, counters);
+					estimate.Add(Luminance(sample));
+					color += sample;
+				}
+
+				counters.rays += samples;
+				counters.paths += samples;
+				counters.segments += samples;
+
+				float* pixel = &accumulation[index * 3];
+				pixel[0] += float(color.x);
+				pixel[1] += float(color.y);
+				pixel[2] += float(color.z);
+			}
+		}
+
+		return counters;
+	}
+
+	CpuRenderer::TraceCounters CpuRenderer::RenderTilePackets(const TileTiming& tile, const Camera& camera, const Hittable& world, const MaterialTable* materials, int samples)
+	{
+		const int packetSize = settings.packetSize;
+		const Interval ray_t(Real(0.001), std::numeric_limits<Real>::infinity());
+
+		RayPacket packet;
+		PacketHit result{};
+		Vector3 colors[RayPacket::MaxSize];
+		Sampler samplers[RayPacket::MaxSize];
+		int pixelX[RayPacket::MaxSize];
+		int pixelY[RayPacket::MaxSize];
+		TraceCounters counters;
+
+		for (int y0 = tile.y; y0 < tile.y + tile.height; y0 += packetSize)
+		{
+			for (int x0 = tile.x; x0 < tile.x + tile.width; x0 += packetSize)
+			{
+				const int blockWidth = std::min(packetSize, tile.x + tile.width - x0);
+				const int blockHeight = std::min(packetSize, tile.y + tile.height - y0);
+
+				// Gather the pixels of the block that still need samples.
+				int count = 0;
+				for (int y = y0; y < y0 + blockHeight; y++)
+				{
+					for (int x = x0; x < x0 + blockWidth; x++)
+					{
+						if (!Converged(estimates[size_t(y) * width + x]))
+						{
+							pixelX[count] = x;
+							pixelY[count] = y;
+							colors[count] = Vector3();
+							count++;
+						}
+					}
+				}
+
+				if (count == 0)
+				{
+					continue;
+				}
+
+				for (int s = 0; s < samples; s++)
+				{
+					packet.Clear();
+					for (int i = 0; i < count; i++)
+					{
+						const PixelEstimate& estimate = estimates[size_t(pixelY[i]) * width + pixelX[i]];
+
+						samplers[i] = Sampler(settings.sampler, pixelX[i], pixelY[i], estimate.samples, settings.seed);
+						packet.Add(camera.GetJitteredRay(pixelX[i], pixelY[i], samplers[i]));
+					}
+
+					world.TracePacket(packet, ray_t, result);
+
+					for (int i = 0; i < count; i++)
+					{
+						AccumulateAov(size_t(pixelY[i]) * width + pixelX[i], packet.Get(i), result.hit[i], result.records[i], materials);
+
+						const Vector3 sample = TracePath(packet.Get(i), result.hit[i], result.records[i], world, materials, samplers[i], counters);
+						estimates[size_t(pixelY[i]) * width + pixelX[i]].Add(Luminance(sample));
+						colors[i] += sample;
+					}
+
+					counters.rays += count;
+					counters.paths += count;
+					counters.segments += count;
+				}
+
+				for (int i = 0; i < count; i++)
+				{
+					float* pixel = &accumulation[(size_t(pixelY[i]) * width + pixelX[i]) * 3];
+					pixel[0] += float(colors[i].x);
+					pixel[1] += float(colors[i].y);
+					pixel[2] += float(colors[i].z);
+				}
+			}
+		}
+
+		return counters;
+	}
+
+	Vector3 CpuRenderer::Shade(const Ray& ray, bool hit, const HitRecord& record) const
+	{
+		if (hit)
+		{
+			// Visualize the surface normal until materials are shaded.
+			return 0.5 * (record.N + Vector3(1.0, 1.0, 1.0));
+		}
+
+		// Sky gradient.
+		const Vector3 direction = Vector3::Normalize(ray.direction);
+		const Real a = Real(0.5) * (direction.y + 1);
+
+		return Vector3::Lerp(Vector3(1.0, 1.0, 1.0), Vector3(Real(0.5), Real(0.7), Real(1.0)), a);
+	}
+
+	void CpuRenderer::AccumulateAov(size_t pixel, const Ray& ray, bool hit, const HitRecord& record, const MaterialTable* materials)
+	{
+		const Material* material = (hit && materials) ? materials->Get(record.materialId) : nullptr;
+		const Vector3 albedo = material ? material->Albedo(record) : Shade(ray, hit, record);
+
+		float* a = &albedoAccumulation[pixel * 3];
+		a[0] += float(albedo.x);
+		a[1] += float(albedo.y);
+		a[2] += float(albedo.z);
+
+		if (hit)
+		{
+			float* n = &normalAccumulation[pixel * 3];
+			n[0] += float(record.N.x);
+			n[1] += float(record.N.y);
+			n[2] += float(record.N.z);
+
+			depthAccumulation[pixel] += float(record.t * ray.direction.Length());
+		}
+	}
+
+	bool CpuRenderer::ShadeVertex(const Ray& ray, bool hit, const HitRecord& record, const MaterialTable* materials, int depth,
+		Sampler& sampler, Vector3& throughput, Vector3& radiance, Vector3& shadow, Vector3& shadowDirection, Ray& next) const
+	{
+		shadow = Vector3();
+
+		// Every vertex owns a fixed block of dimensions, so the same decision of
+		// every sample of a pixel reads the same low-discrepancy sequence.
+		const uint32_t dimension = CameraDimensions + uint32_t(depth) * VertexDimensions;
+
+		const Material* material = (hit && materials) ? materials->Get(record.materialId) : nullptr;
+		if (!material)
+		{
+			radiance += throughput * Shade(ray, hit, record);
+			return false;
+		}
+
+		if (settings.sunRadiance.Length2() > 0)
+		{
+			sampler.SetDimension(dimension);
+			shadowDirection = SampleSunDirection(sampler.Get2D());
+			shadow = throughput * material->Evaluate(ray, record, shadowDirection) * settings.sunRadiance;
+		}
+
+		Vector3 attenuation;
+		sampler.SetDimension(dimension + 2);
+		if (depth + 1 >= settings.maxDepth || !material->Scatter(ray, record, sampler, attenuation, next))
+		{
+			return false;
+		}
+
+		throughput = throughput * attenuation;
+
+		// Russian roulette: end dim paths early and reweight the survivors so
+		// the expected contribution is unchanged.
+		if (settings.russianRouletteDepth > 0 && depth + 1 >= settings.russianRouletteDepth)
+		{
+			const Real survival = std::min(Real(0.95), std::max({ throughput.x, throughput.y, throughput.z }));
+			sampler.SetDimension(dimension + 1);
+			if (sampler.Get1D() >= survival)
+			{
+				return false;
+			}
+
+			throughput = throughput * (1 / survival);
+		}
+
+		return true;
+	}
+
+	Vector3 CpuRenderer::SampleSunDirection(const Vector2& u) const
+	{
+		if (settings.sunAngle <= 0.0)
+		{
+			return settings.sunDirection;
+		}
+
+		return ToWorld(SampleUniformCone(u, std::cos(settings.sunAngle)), settings.sunDirection);
+	}
+
+	bool CpuRenderer::Unoccluded(const HitRecord& record, const Vector3& direction, const Hittable& world) const
+	{
+		return !world.Occluded(Ray(record.p, direction), Interval(Real(0.001), std::numeric_limits<Real>::infinity()));
+	}
+
+	Vector3 CpuRenderer::TracePath(Ray ray, bool hit, const HitRecord& primary, const Hittable& world, const MaterialTable* materials, Sampler& sampler, TraceCounters& counters) const
+	{
+		const Interval ray_t(Real(0.001), std::numeric_limits<Real>::infinity());
+
+		// A miss leaves the primary record unwritten, so it is only copied on a hit.
+		HitRecord record{};
+		if (hit)
+		{
+			record = primary;
+		}
+
+		Vector3 throughput(1.0, 1.0, 1.0);
+		Vector3 radiance;
+
+		for (int depth = 0;; depth++)
+		{
+			if (depth > 0)
+			{
+				hit = world.Hit(ray, ray_t, record);
+				counters.rays++;
+				counters.segments++;
+			}
+
+			Vector3 shadow;
+			Vector3 shadowDirection;
+			Ray next;
+			const bool continues = ShadeVertex(ray, hit, record, materials, depth, sampler, throughput, radiance, shadow, shadowDirection, next);
+
+			if (shadow.Length2() > 0)
+			{
+				counters.rays++;
+				if (Unoccluded(record, shadowDirection, world))
+				{
+					radiance += shadow;
+				}
+			}
+
+			if (!continues)
+			{
+				return radiance;
+			}
+
+			ray = next;
+		}
+	}
+
+	CpuRenderer::TraceCounters CpuRenderer::RenderWavefront(const Camera& camera, const Hittable& world, const MaterialTable* materials, int samples)
+	{
+		const size_t pixelCount = size_t(width) * height;
+		const size_t batchSize = std::min(size_t(settings.wavefrontSize), pixelCount);
+
+		if (paths.Size() != batchSize)
+		{
+			paths.Resize(batchSize);
+		}
+
+		std::vector<uint32_t> pixels;
+		pixels.reserve(batchSize);
+
+		TraceCounters counters;
+
+		// Each batch holds one sample of each of its pixels, so the final write
+		// of a path never races with another path of the same batch.
+		for (size_t first = 0; first < pixelCount; first += batchSize)
+		{
+			const size_t last = std::min(first + batchSize, pixelCount);
+
+			pixels.clear();
+			for (size_t p = first; p < last; p++)
+			{
+				if (!Converged(estimates[p]))
+				{
+					pixels.push_back(uint32_t(p));
+				}
+			}
+
+			if (pixels.empty())
+			{
+				continue;
+			}
+
+			for (int s = 0; s < samples; s++)
+			{
+				counters += TraceWavefront(pixels, camera, world, materials);
+			}
+		}
+
+		return counters;
+	}
+
+	CpuRenderer::TraceCounters CpuRenderer::TraceWavefront(const std::vector<uint32_t>& pixels, const Camera& camera, const Hittable& world, const MaterialTable* materials)
+	{
+		constexpr size_t grainSize = 256;
+
+		const Interval ray_t(Real(0.001), std::numeric_limits<Real>::infinity());
+		const size_t count = pixels.size();
+
+		// Generate: one camera ray per pixel.
+		pool.ParallelFor(count, grainSize, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const uint32_t p = pixels[i];
+					const int x = int(p % uint32_t(width));
+					const int y = int(p / uint32_t(width));
+
+					Sampler sampler(settings.sampler, x, y, estimates[p].samples, settings.seed);
+					const Ray ray = camera.GetJitteredRay(x, y, sampler);
+
+					paths.Start(i, p, ray, sampler);
+				}
+			});
+
+		activePaths.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			activePaths[i] = uint32_t(i);
+		}
+
+		const AABB bounds = world.BoundingBox();
+
+		std::atomic<uint64_t> shadowRays = 0;
+
+		TraceCounters counters;
+		counters.paths = count;
+
+		for (int depth = 0; !activePaths.empty(); depth++)
+		{
+			counters.segments += activePaths.size();
+
+			// Primary rays are already coherent in pixel order; bounced rays are not.
+			if (settings.reorderRays && depth > 0)
+			{
+				ReorderRays(bounds);
+			}
+
+			// Extend: closest hit of every active path.
+			pool.ParallelFor(activePaths.size(), grainSize, [&](size_t begin, size_t end)
+				{
+					for (size_t k = begin; k < end; k++)
+					{
+						const uint32_t i = activePaths[k];
+						paths.hit[i] = world.Hit(paths.GetRay(i), ray_t, paths.records[i]);
+					}
+				});
+
+			SortByMaterial(materials);
+
+			// Shade: scatter every path and queue its shadow ray. A path that
+			// ends is marked by clearing its 'hit' flag.
+			pool.ParallelFor(activePaths.size(), grainSize, [&](size_t begin, size_t end)
+				{
+					for (size_t k = begin; k < end; k++)
+					{
+						const uint32_t i = activePaths[k];
+
+						if (depth == 0)
+						{
+							AccumulateAov(paths.pixel[i], paths.GetRay(i), paths.hit[i], paths.records[i], materials);
+						}
+
+						Vector3 throughput = paths.Throughput(i);
+						Vector3 radiance;
+						Vector3 shadow;
+						Vector3 shadowDirection;
+						Ray next;
+
+						const bool continues = ShadeVertex(paths.GetRay(i), paths.hit[i], paths.records[i], materials, depth,
+							paths.sampler[i], throughput, radiance, shadow, shadowDirection, next);
+
+						paths.AddRadiance(i, radiance);
+						paths.shadowPending[i] = shadow.Length2() > 0;
+						paths.shadowR[i] = shadow.x;
+						paths.shadowG[i] = shadow.y;
+						paths.shadowB[i] = shadow.z;
+						paths.shadowDirectionX[i] = shadowDirection.x;
+						paths.shadowDirectionY[i] = shadowDirection.y;
+						paths.shadowDirectionZ[i] = shadowDirection.z;
+
+						if (continues)
+						{
+							paths.SetThroughput(i, throughput);
+							paths.SetRay(i, next);
+						}
+
+						paths.hit[i] = continues;
+					}
+				});
+
+			// Shadow: resolve the queued direct light.
+			pool.ParallelFor(activePaths.size(), grainSize, [&](size_t begin, size_t end)
+				{
+					uint64_t traced = 0;
+					for (size_t k = begin; k < end; k++)
+					{
+						const uint32_t i = activePaths[k];
+						if (!paths.shadowPending[i])
+						{
+							continue;
+						}
+
+						traced++;
+						const Vector3 direction(paths.shadowDirectionX[i], paths.shadowDirectionY[i], paths.shadowDirectionZ[i]);
+						if (Unoccluded(paths.records[i], direction, world))
+						{
+							paths.AddRadiance(i, Vector3(paths.shadowR[i], paths.shadowG[i], paths.shadowB[i]));
+						}
+					}
+
+					shadowRays.fetch_add(traced, std::memory_order_relaxed);
+				});
+
+			// Compact the paths that continue.
+			size_t alive = 0;
+			for (const uint32_t i : activePaths)
+			{
+				if (paths.hit[i])
+				{
+					activePaths[alive++] = i;
+				}
+			}
+
+			activePaths.resize(alive);
+		}
+
+		// Write every finished sample to its pixel.
+		pool.ParallelFor(count, grainSize, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const uint32_t p = paths.pixel[i];
+					const Vector3 sample = paths.Radiance(i);
+
+					estimates[p].Add(Luminance(sample));
+
+					float* pixel = &accumulation[size_t(p) * 3];
+					pixel[0] += float(sample.x);
+					pixel[1] += float(sample.y);
+					pixel[2] += float(sample.z);
+				}
+			});
+
+		counters.rays = counters.segments + shadowRays.load();
+
+		return counters;
+	}
+
+	void CpuRenderer::ReorderRays(const AABB& bounds)
+	{
+		const Vector3 origin = bounds.Min();
+		const Vector3 extent = bounds.Max() - origin;
+		const Vector3 scale(extent.x > 0 ? 1 / extent.x : 0, extent.y > 0 ? 1 / extent.y : 0, extent.z > 0 ? 1 / extent.z : 0);
+
+		rayKeys.resize(activePaths.size());
+
+		pool.ParallelFor(activePaths.size(), 1024, [&](size_t begin, size_t end)
+			{
+				for (size_t k = begin; k < end; k++)
+				{
+					const uint32_t i = activePaths[k];
+
+					const uint64_t octant = (paths.directionX[i] < 0 ? 4u : 0u) | (paths.directionY[i] < 0 ? 2u : 0u) | (paths.directionZ[i] < 0 ? 1u : 0u);
+					const uint32_t morton = MortonCode((paths.originX[i] - origin.x) * scale.x,
+						(paths.originY[i] - origin.y) * scale.y, (paths.originZ[i] - origin.z) * scale.z);
+
+					rayKeys[k] = { (octant << 30) | morton, i };
+				}
+			});
+
+		uint64_t sharedBefore = 0;
+		for (size_t k = 1; k < rayKeys.size(); k++)
+		{
+			sharedBefore += SharedKeyBits(rayKeys[k - 1].first, rayKeys[k].first);
+		}
+
+		std::sort(rayKeys.begin(), rayKeys.end());
+
+		uint64_t sharedAfter = 0;
+		for (size_t k = 0; k < rayKeys.size(); k++)
+		{
+			activePaths[k] = rayKeys[k].second;
+
+			if (k > 0)
+			{
+				sharedAfter += SharedKeyBits(rayKeys[k - 1].first, rayKeys[k].first);
+			}
+		}
+
+		stats.reorderedRays += rayKeys.size();
+		reorderedPairs += rayKeys.empty() ? 0 : rayKeys.size() - 1;
+		stats.keySimilarityBefore += double(sharedBefore);
+		stats.keySimilarityAfter += double(sharedAfter);
+	}
+
+	void CpuRenderer::SortByMaterial(const MaterialTable* materials)
+	{
+		// Counting sort: bucket 0 holds misses and unknown materials, bucket m + 1 material m.
+		const size_t materialCount = materials ? materials->Size() : 0;
+		const auto bucket = [&](uint32_t i) -> size_t
+			{
+				const uint32_t id = paths.records[i].materialId;
+				return (paths.hit[i] && id < materialCount) ? id + 1 : 0;
+			};
+
+		materialOffsets.assign(materialCount + 2, 0);
+		for (const uint32_t i : activePaths)
+		{
+			materialOffsets[bucket(i) + 1]++;
+		}
+
+		for (size_t b = 1; b < materialOffsets.size(); b++)
+		{
+			materialOffsets[b] += materialOffsets[b - 1];
+		}
+
+		sortedPaths.resize(activePaths.size());
+		for (const uint32_t i : activePaths)
+		{
+			sortedPaths[materialOffsets[bucket(i)]++] = i;
+		}
+
+		activePaths.swap(sortedPaths);
+	}
+}
\ No newline at end of file
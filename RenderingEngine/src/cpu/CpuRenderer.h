@@ -0,0 +1,321 @@
+#pragma once
+
+#include "pch.h"
+
+#include "../Camera.h"
+#include "../Hittable.h"
+#include "../MaterialTable.h"
+#include "../ThreadPool.h"
+#include "Denoiser.h"
+#include "PathStates.h"
+
+namespace Engine
+{
+	/** @brief User-facing parameters of the CPU renderer. */
+	struct CpuRenderSettings
+	{
+		int samplesPerPixel = 16; ///< Samples added to every pixel by one Render() call (the average, with adaptive sampling).
+		int tileSize = 32;		  ///< Width and height of a square tile in pixels.
+		unsigned threadCount = 0; ///< Worker threads; zero uses every hardware thread.
+		uint64_t seed = 0;		  ///< Seed of the per-pixel samplers.
+		SamplerType sampler = SamplerType::Sobol; ///< Sequence of the pixel jitter, light samples, bounces and roulette.
+		int packetSize = 0;		  ///< Side of the square primary ray packets (e.g. 4 or 8); zero traces single rays.
+
+		/// Relative half-width of a pixel's 95% confidence interval below which it stops
+		/// sampling; zero disables adaptive sampling.
+		double adaptiveThreshold = 0.0;
+		int adaptiveMinSamples = 16; ///< Samples a pixel takes before its variance estimate is trusted.
+
+		int maxDepth = 8;								///< Longest path in segments when materials are shaded.
+		int russianRouletteDepth = 3;					///< Path vertices shaded before Russian roulette may end a path; zero disables it.
+		Vector3 sunDirection = Vector3(0.0, 1.0, 0.0); ///< Direction towards the directional light.
+		Vector3 sunRadiance;							///< Radiance of the directional light; zero disables direct lighting.
+		double sunAngle = 0.0;							///< Angular radius of the light in radians; zero gives hard shadows.
+
+		/// Trace batches of paths one stage at a time (generate, extend, shade, shadow) instead of one path at a time.
+		bool wavefront = false;
+		int wavefrontSize = 1 << 16; ///< Paths in flight per wavefront batch.
+
+		/// Wavefront mode: sort secondary rays by direction octant and the Morton code of their
+		/// origin before each extend stage, so neighbouring rays traverse similar BVH nodes.
+		bool reorderRays = false;
+	};
+
+	/** @brief Timing of a single tile from the last Render() call. */
+	struct TileTiming
+	{
+		int x, y;			 ///< Top-left pixel of the tile.
+		int width, height;	 ///< Tile size in pixels (smaller at the image border).
+		unsigned worker;	 ///< Index of the worker that rendered the tile.
+		double milliseconds; ///< Wall-clock time spent on the tile.
+	};
+
+	/** @brief Statistics from the last Render() call. */
+	struct CpuRenderStats
+	{
+		double renderTimeMs = 0.0;
+		uint64_t rays = 0;			///< Every ray traced: camera, bounce and shadow rays.
+		uint64_t paths = 0;			///< Pixel samples, each one path.
+		uint64_t pathSegments = 0;	///< Camera and bounce rays, i.e. the summed length of all paths.
+		uint64_t convergedPixels = 0; ///< Pixels that met the adaptive threshold by the end of the call.
+		int passes = 0;				  ///< Sampling passes over the image (one without adaptive sampling).
+
+		/// Secondary rays sorted by the reordering stage.
+		uint64_t reorderedRays = 0;
+		/// Mean number of leading bits (of 33) shared by the octant + Morton sort keys of consecutively
+		/// traced secondary rays, before and after reordering. A proxy for how alike neighbouring rays
+		/// are, not a measurement of traversal; sorting by the key raises it by construction.
+		double keySimilarityBefore = 0.0;
+		double keySimilarityAfter = 0.0;
+		std::vector<TileTiming> tiles;
+
+		double RaysPerSecond() const { return renderTimeMs > 0.0 ? rays / (renderTimeMs / 1000.0) : 0.0; }
+		double MeanPathLength() const { return paths ? double(pathSegments) / paths : 0.0; }
+
+		/** @brief One-line report of throughput and path statistics. */
+		std::string Summary() const;
+	};
+
+	/**
+	 * @class CpuRenderer
+	 * @brief Multithreaded tile-based renderer that traces Camera rays against a Hittable.
+	 *
+	 * The image is split into square tiles which are rendered in parallel on a
+	 * work-stealing ThreadPool. Samples are summed into a float RGB accumulation
+	 * buffer, so successive Render() calls refine the same image progressively.
+	 * Every tile writes to a disjoint region of the buffer, so workers never
+	 * synchronize on a per-sample basis.
+	 *
+	 * Each sample draws from its own Sampler keyed by pixel, sample index and
+	 * seed, so the image is bit-identical for any thread count or tile size.
+	 * Every decision of a path reads a fixed sampler dimension: the pixel
+	 * jitter, then per vertex the light sample, the Russian roulette and
+	 * the bounce direction. With a low-discrepancy 'sampler' each of them is
+	 * stratified over a pixel's samples, which lowers the noise at equal
+	 * sample counts.
+	 *
+	 * With a non-zero 'packetSize', primary rays of each packetSize x packetSize
+	 * pixel block are traced together through Hittable::TracePacket. The rays
+	 * are the same as in single-ray mode, only the traversal differs.
+	 *
+	 * Every pixel keeps a running mean and variance of its luminance (Welford's
+	 * algorithm). With a non-zero 'adaptiveThreshold', Render() spends a budget
+	 * of samplesPerPixel * width * height samples in passes: each pass samples
+	 * only the pixels whose confidence interval is still too wide, so the
+	 * budget freed by converged pixels goes to the noisy ones.
+	 *
+	 * Given a MaterialTable, hits are shaded by path tracing: each vertex
+	 * adds the directional light through a shadow ray towards a direction
+	 * sampled within its 'sunAngle' cone and continues along
+	 * Material::Scatter. After 'russianRouletteDepth' vertices a path
+	 * survives each bounce with a probability equal to its largest
+	 * throughput component (at most 0.95), and survivors are reweighted by
+	 * its inverse, so dim paths end early without biasing the image.
+	 *
+	 * In wavefront mode the paths of up to 'wavefrontSize' pixels live in
+	 * PathStates and every stage runs as a parallel loop over the whole
+	 * batch, with hits sorted by material ID before shading so that each
+	 * material's code and data stay hot in cache. Both modes use the same
+	 * samplers and produce the same image.
+	 *
+	 * With 'reorderRays', bounced rays are also sorted by direction octant
+	 * and origin Morton code before each extend stage. Diffuse bounces leave
+	 * rays in random directions; after sorting, consecutive rays have
+	 * similar keys, i.e. start near each other and head the same way.
+	 * CpuRenderStats reports how alike the keys are before and after.
+	 *
+	 * Every camera sample also adds the albedo, normal and distance of its
+	 * first hit to AOV buffers. Denoise() uses them to guide an edge-avoiding
+	 * filter over the resolved image.
+	 */
+	class CpuRenderer
+	{
+	public:
+
+		CpuRenderer() = delete;
+		CpuRenderer(int imageWidth, int imageHeight, const CpuRenderSettings& settings = CpuRenderSettings());
+
+		/**
+		 * @brief Adds 'samplesPerPixel' samples to every pixel.
+		 * @param camera Camera generating the primary rays; its image size must match the renderer.
+		 * @param world Scene to trace against.
+		 * @param materials Materials indexed by HitRecord::materialId; without them hits are shaded by their normal.
+		 */
+		void Render(const Camera& camera, const Hittable& world, const MaterialTable* materials = nullptr);
+
+		/**
+		 * @brief Benchmark mode: renders 'frames' frames from a cleared buffer and returns their combined statistics.
+		 *
+		 * One extra frame is rendered first to warm up caches and the thread pool
+		 * and is not counted. The accumulation buffer holds the last frame.
+		 */
+		CpuRenderStats Benchmark(const Camera& camera, const Hittable& world, const MaterialTable* materials, int frames);
+
+		/** @brief Resets the accumulation buffer and sample count. */
+		void Clear();
+
+		int Width() const { return width; }
+		int Height() const { return height; }
+		/** @brief Samples per pixel requested so far; with adaptive sampling individual pixels differ. */
+		int SampleCount() const { return sampleCount; }
+
+		/** @brief Number of samples taken by pixel (x, y). */
+		uint32_t PixelSampleCount(int x, int y) const { return estimates[size_t(y) * width + x].samples; }
+		unsigned ThreadCount() const { return pool.ThreadCount(); }
+
+		/** @brief Sum of all samples per pixel, stored as interleaved RGB floats in row-major order. */
+		const std::vector<float>& AccumulationBuffer() const { return accumulation; }
+
+		/** @brief Returns the averaged image (accumulation divided by each pixel's sample count) as RGB floats. */
+		std::vector<float> Resolve() const;
+
+		/**
+		 * @brief Sample-count heatmap AOV.
+		 * @return One float per pixel in row-major order: the pixel's sample count
+		 *         divided by the largest count in the image, so 1 marks the noisiest pixels.
+		 */
+		std::vector<float> SampleCountHeatmap() const;
+
+		/** @brief First-hit albedo AOV averaged over each pixel's samples, as RGB floats; the background colour where rays missed. */
+		std::vector<float> ResolveAlbedo() const;
+
+		/** @brief First-hit normal AOV averaged over each pixel's samples, as XYZ floats; zero where rays missed. */
+		std::vector<float> ResolveNormal() const;
+
+		/** @brief First-hit distance AOV averaged over each pixel's samples, one float per pixel; zero where rays missed. */
+		std::vector<float> ResolveDepth() const;
+
+		/** @brief Variance of each pixel's mean luminance, one float per pixel; the noise estimate the denoiser adapts to. */
+		std::vector<float> ResolveVariance() const;
+
+		/**
+		 * @brief Post stage: the resolved image filtered by a Denoiser guided by the AOVs.
+		 *
+		 * Runs on the renderer's thread pool and leaves the accumulation buffer
+		 * untouched, so rendering can continue afterwards.
+		 */
+		std::vector<float> Denoise(const DenoiserSettings& denoiserSettings = DenoiserSettings());
+
+		const CpuRenderStats& Stats() const { return stats; }
+		const CpuRenderSettings& Settings() const { return settings; }
+
+	private:
+
+		int width, height;
+		int sampleCount = 0;
+
+		CpuRenderSettings settings;
+		ThreadPool pool;
+
+		/** @brief Work done by a tile or wavefront batch. */
+		struct TraceCounters
+		{
+			uint64_t rays = 0;
+			uint64_t paths = 0;
+			uint64_t segments = 0;
+
+			TraceCounters& operator+=(const TraceCounters& other)
+			{
+				rays += other.rays;
+				paths += other.paths;
+				segments += other.segments;
+				return *this;
+			}
+		};
+
+		/** @brief Running luminance statistics of one pixel (Welford's online algorithm). */
+		struct PixelEstimate
+		{
+			uint32_t samples = 0;
+			double mean = 0.0;
+			double m2 = 0.0;
+
+			void Add(double value)
+			{
+				samples++;
+				const double delta = value - mean;
+				mean += delta / samples;
+				m2 += delta * (value - mean);
+			}
+
+			double Variance() const { return samples > 1 ? m2 / (samples - 1) : 0.0; }
+		};
+
+		std::vector<float> accumulation;
+		std::vector<PixelEstimate> estimates;
+
+		// Sums of the first-hit AOVs, laid out like the accumulation buffer.
+		std::vector<float> albedoAccumulation;
+		std::vector<float> normalAccumulation;
+		std::vector<float> depthAccumulation;
+		CpuRenderStats stats;
+
+		// Wavefront buffers, kept between batches.
+		PathStates paths;
+		std::vector<uint32_t> activePaths;
+		std::vector<uint32_t> sortedPaths;
+		std::vector<uint32_t> materialOffsets;
+		std::vector<std::pair<uint64_t, uint32_t>> rayKeys;
+		uint64_t reorderedPairs = 0; ///< Consecutive ray pairs behind the key similarity sums of the current Render().
+
+		/** @brief Rec. 709 luminance, the quantity whose variance drives adaptive sampling. */
+		static double Luminance(const Vector3& color) { return 0.2126 * color.x + 0.7152 * color.y + 0.0722 * color.z; }
+
+		/** @brief Returns true once a pixel's confidence interval is within the adaptive threshold. */
+		bool Converged(const PixelEstimate& estimate) const;
+
+		/** @brief Renders every tile once with 'samples' samples per unconverged pixel. */
+		TraceCounters RenderPass(const Camera& camera, const Hittable& world, const MaterialTable* materials, int samples);
+
+		Vector3 Shade(const Ray& ray, bool hit, const HitRecord& record) const;
+
+		/** @brief Adds the first hit of a camera ray to the AOV buffers of 'pixel'. */
+		void AccumulateAov(size_t pixel, const Ray& ray, bool hit, const HitRecord& record, const MaterialTable* materials);
+
+		/** @brief Divides an AOV sum buffer with 'channels' floats per pixel by each pixel's sample count. */
+		std::vector<float> ResolveAov(const std::vector<float>& sums, size_t channels) const;
+
+		/**
+		 * @brief Shades one path vertex; shared by both modes so they make identical decisions.
+		 * @param depth Index of the vertex along the path, zero for the primary hit.
+		 * @param throughput Path throughput, multiplied by the scatter attenuation.
+		 * @param radiance Receives the background or normal shading that ends a path.
+		 * @param shadow Receives the direct light to add if the shadow ray is unoccluded, or zero.
+		 * @param shadowDirection Receives the direction of the shadow ray.
+		 * @param next Receives the continuation ray.
+		 * @return True if the path continues along 'next'.
+		 */
+		bool ShadeVertex(const Ray& ray, bool hit, const HitRecord& record, const MaterialTable* materials, int depth,
+			Sampler& sampler, Vector3& throughput, Vector3& radiance, Vector3& shadow, Vector3& shadowDirection, Ray& next) const;
+
+		/** @brief Samples a unit direction within the light's cone from a 2D sample. */
+		Vector3 SampleSunDirection(const Vector2& u) const;
+
+		/** @brief Returns true if a shadow ray from 'record' along 'direction' is unoccluded. */
+		bool Unoccluded(const HitRecord& record, const Vector3& direction, const Hittable& world) const;
+
+		/** @brief Follows a path from its primary hit to the end; counts the rays traced after the primary. 'primary' is only read on a hit. */
+		Vector3 TracePath(Ray ray, bool hit, const HitRecord& primary, const Hittable& world, const MaterialTable* materials, Sampler& sampler, TraceCounters& counters) const;
+
+		/** @brief Renders one tile with single rays. */
+		TraceCounters RenderTile(const TileTiming& tile, const Camera& camera, const Hittable& world, const MaterialTable* materials, int samples);
+
+		/** @brief Renders one tile with primary ray packets. */
+		TraceCounters RenderTilePackets(const TileTiming& tile, const Camera& camera, const Hittable& world, const MaterialTable* materials, int samples);
+
+		/** @brief Renders the image in wavefront batches. */
+		TraceCounters RenderWavefront(const Camera& camera, const Hittable& world, const MaterialTable* materials, int samples);
+
+		/** @brief Traces one sample for each listed pixel through every wavefront stage. */
+		TraceCounters TraceWavefront(const std::vector<uint32_t>& pixels, const Camera& camera, const Hittable& world, const MaterialTable* materials);
+
+		/**
+		 * @brief Reorders the active paths by ray direction octant, then by the Morton code of the ray origin.
+		 * @param bounds Scene bounds over which the origins are quantized.
+		 */
+		void ReorderRays(const AABB& bounds);
+
+		/** @brief Reorders the active paths by the material of their hit; misses and unknown materials come first. */
+		void SortByMaterial(const MaterialTable* materials);
+	};
+}
\ No newline at end of file
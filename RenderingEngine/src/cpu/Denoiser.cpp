@@ -0,0 +1,343 @@
+#include "pch.h"
+
+#include "Denoiser.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		// Guide planes, in order.
+		enum Guide { NormalX, NormalY, NormalZ, AlbedoR, AlbedoG, AlbedoB, Depth, GuideCount };
+
+		/// B3-spline taps, indexed by offset + 2.
+		constexpr float Kernel[5] = { 1.0f / 16, 1.0f / 4, 3.0f / 8, 1.0f / 4, 1.0f / 16 };
+
+		/// Depth below which a pixel counts as a miss when depth differences are made relative.
+		constexpr float MinDepth = 1e-3f;
+
+		/// Variance floor, so pixels without noise still accept identical neighbours.
+		constexpr float MinVariance = 1e-6f;
+
+		/// Colour planes, followed by the variance plane.
+		constexpr size_t ColorPlanes = 4;
+
+#if defined(__AVX2__)
+		__m256 Madd(__m256 a, __m256 b, __m256 c)
+		{
+			return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+		}
+
+		/** @brief e^x for x <= 0 in eight lanes (the Cephes expf polynomial, accurate to about one ulp). */
+		__m256 Exp(__m256 x)
+		{
+			x = _mm256_max_ps(x, _mm256_set1_ps(-87.0f));
+
+			// e^x = 2^n * e^r with n = round(x / ln 2) and |r| <= ln 2 / 2.
+			const __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+			x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(-2.12194440e-4f)));
+
+			__m256 y = _mm256_set1_ps(1.9875691500e-4f);
+			y = Madd(y, x, _mm256_set1_ps(1.3981999507e-3f));
+			y = Madd(y, x, _mm256_set1_ps(8.3334519073e-3f));
+			y = Madd(y, x, _mm256_set1_ps(4.1665795894e-2f));
+			y = Madd(y, x, _mm256_set1_ps(1.6666665459e-1f));
+			y = Madd(y, x, _mm256_set1_ps(5.0000001201e-1f));
+			y = Madd(y, _mm256_mul_ps(x, x), _mm256_add_ps(x, _mm256_set1_ps(1.0f)));
+
+			// Build 2^n directly in the exponent bits.
+			const __m256i exponent = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+
+			return _mm256_mul_ps(y, _mm256_castsi256_ps(exponent));
+		}
+
+		__m256 DistanceSquared(const float* plane, size_t p, ptrdiff_t offset, __m256 centerA, __m256 centerB, __m256 centerC, size_t stride)
+		{
+			const __m256 a = _mm256_sub_ps(_mm256_loadu_ps(plane + p + offset), centerA);
+			const __m256 b = _mm256_sub_ps(_mm256_loadu_ps(plane + stride + p + offset), centerB);
+			const __m256 c = _mm256_sub_ps(_mm256_loadu_ps(plane + 2 * stride + p + offset), centerC);
+
+			return Madd(a, a, Madd(b, b, _mm256_mul_ps(c, c)));
+		}
+#endif
+	}
+
+	Denoiser::Denoiser(ThreadPool& pool, const DenoiserSettings& settings) :
+		pool(pool), settings(settings)
+	{
+		this->settings.iterations = std::clamp(this->settings.iterations, 0, 10);
+	}
+
+	std::vector<float> Denoiser::Denoise(const std::vector<float>& color, const std::vector<float>& albedo,
+		const std::vector<float>& normal, const std::vector<float>& depth, const std::vector<float>& variance, int width, int height)
+	{
+		const size_t count = size_t(std::max(width, 0)) * std::max(height, 0);
+
+		if (color.size() != count * 3 || albedo.size() != count * 3 || normal.size() != count * 3 ||
+			depth.size() != count || variance.size() != count)
+		{
+			throw std::runtime_error("Denoiser buffers do not match the image size!");
+		}
+
+		this->width = width;
+		this->height = height;
+
+		colors[0].resize(count * ColorPlanes);
+		colors[1].resize(count * ColorPlanes);
+		guides.resize(count * GuideCount);
+		blurredVariance.resize(count);
+
+		constexpr size_t grainSize = 4096;
+
+		// Split the interleaved buffers into planes so every kernel load is contiguous.
+		pool.ParallelFor(count, grainSize, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					for (size_t c = 0; c < 3; c++)
+					{
+						colors[0][c * count + i] = color[i * 3 + c];
+						guides[(NormalX + c) * count + i] = normal[i * 3 + c];
+						guides[(AlbedoR + c) * count + i] = albedo[i * 3 + c];
+					}
+
+					colors[0][3 * count + i] = variance[i];
+					guides[Depth * count + i] = depth[i];
+				}
+			});
+
+		int source = 0;
+		for (int iteration = 0; iteration < settings.iterations; iteration++)
+		{
+			Pass pass;
+			pass.step = 1 << iteration;
+			pass.colorPhi = std::max(settings.colorPhi, 1e-6f);
+			pass.invNormalPhi = 1.0f / std::max(settings.normalPhi, 1e-6f);
+			pass.invAlbedoPhi = 1.0f / std::max(settings.albedoPhi, 1e-6f);
+			pass.invDepthPhi = 1.0f / std::max(settings.depthPhi, 1e-6f);
+
+			const float* in = colors[source].data();
+			float* out = colors[1 - source].data();
+
+			pool.ParallelFor(size_t(height), 16, [&](size_t begin, size_t end)
+				{
+					for (size_t y = begin; y < end; y++)
+					{
+						BlurVariance(in, int(y));
+					}
+				});
+
+			pool.ParallelFor(size_t(height), 4, [&](size_t begin, size_t end)
+				{
+					for (size_t y = begin; y < end; y++)
+					{
+						FilterRow(pass, in, out, int(y));
+					}
+				});
+
+			source = 1 - source;
+		}
+
+		std::vector<float> image(count * 3);
+		pool.ParallelFor(count, grainSize, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					for (size_t c = 0; c < 3; c++)
+					{
+						image[i * 3 + c] = colors[source][c * count + i];
+					}
+				}
+			});
+
+		return image;
+	}
+
+	void Denoiser::BlurVariance(const float* in, int y)
+	{
+		const size_t count = size_t(width) * height;
+		const float* variance = in + 3 * count;
+
+		constexpr float taps[3] = { 0.25f, 0.5f, 0.25f };
+
+		for (int x = 0; x < width; x++)
+		{
+			float sum = 0.0f, weightSum = 0.0f;
+
+			for (int dy = -1; dy <= 1; dy++)
+			{
+				for (int dx = -1; dx <= 1; dx++)
+				{
+					const int qx = x + dx, qy = y + dy;
+					if (qx < 0 || qx >= width || qy < 0 || qy >= height)
+					{
+						continue;
+					}
+
+					const float weight = taps[dy + 1] * taps[dx + 1];
+					sum += weight * variance[size_t(qy) * width + qx];
+					weightSum += weight;
+				}
+			}
+
+			blurredVariance[size_t(y) * width + x] = sum / weightSum;
+		}
+	}
+
+	void Denoiser::FilterScalar(const Pass& pass, const float* in, float* out, int y, int x0, int x1) const
+	{
+		const size_t count = size_t(width) * height;
+		const float* g = guides.data();
+
+		for (int x = x0; x < x1; x++)
+		{
+			const size_t p = size_t(y) * width + x;
+			const float invColorPhi = 1.0f / (pass.colorPhi * std::max(blurredVariance[p], MinVariance));
+			const float invDepth = 1.0f / std::max(g[Depth * count + p], MinDepth);
+
+			float weightSum = 0.0f;
+			float sum[3] = {};
+			float varianceSum = 0.0f;
+
+			for (int dy = -2; dy <= 2; dy++)
+			{
+				const int qy = y + dy * pass.step;
+				if (qy < 0 || qy >= height)
+				{
+					continue;
+				}
+
+				for (int dx = -2; dx <= 2; dx++)
+				{
+					const int qx = x + dx * pass.step;
+					if (qx < 0 || qx >= width)
+					{
+						continue;
+					}
+
+					const size_t q = size_t(qy) * width + qx;
+
+					float colorDistance = 0.0f, normalDistance = 0.0f, albedoDistance = 0.0f;
+					for (size_t c = 0; c < 3; c++)
+					{
+						const float dc = in[c * count + q] - in[c * count + p];
+						const float dn = g[(NormalX + c) * count + q] - g[(NormalX + c) * count + p];
+						const float da = g[(AlbedoR + c) * count + q] - g[(AlbedoR + c) * count + p];
+
+						colorDistance += dc * dc;
+						normalDistance += dn * dn;
+						albedoDistance += da * da;
+					}
+
+					const float dd = (g[Depth * count + q] - g[Depth * count + p]) * invDepth;
+
+					const float weight = Kernel[dy + 2] * Kernel[dx + 2] * std::exp(-(colorDistance * invColorPhi +
+						normalDistance * pass.invNormalPhi + albedoDistance * pass.invAlbedoPhi + dd * dd * pass.invDepthPhi));
+
+					weightSum += weight;
+					for (size_t c = 0; c < 3; c++)
+					{
+						sum[c] += weight * in[c * count + q];
+					}
+
+					varianceSum += weight * weight * in[3 * count + q];
+				}
+			}
+
+			// The centre tap always has full weight, so the sum is never zero.
+			for (size_t c = 0; c < 3; c++)
+			{
+				out[c * count + p] = sum[c] / weightSum;
+			}
+
+			out[3 * count + p] = varianceSum / (weightSum * weightSum);
+		}
+	}
+
+	void Denoiser::FilterRow(const Pass& pass, const float* in, float* out, int y) const
+	{
+		int x = 0;
+
+#if defined(__AVX2__)
+		const int border = 2 * pass.step;
+
+		if (y >= border && y < height - border && width - 2 * border >= 8)
+		{
+			FilterScalar(pass, in, out, y, 0, border);
+
+			const size_t count = size_t(width) * height;
+			const float* g = guides.data();
+
+			const __m256 colorPhi = _mm256_set1_ps(pass.colorPhi);
+			const __m256 invNormalPhi = _mm256_set1_ps(pass.invNormalPhi);
+			const __m256 invAlbedoPhi = _mm256_set1_ps(pass.invAlbedoPhi);
+			const __m256 invDepthPhi = _mm256_set1_ps(pass.invDepthPhi);
+			const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+			// Every tap of these pixels is inside the image, so eight neighbouring
+			// pixels read eight neighbouring taps with one unaligned load per plane.
+			for (x = border; x + 8 <= width - border; x += 8)
+			{
+				const size_t p = size_t(y) * width + x;
+
+				const __m256 r = _mm256_loadu_ps(in + p);
+				const __m256 gr = _mm256_loadu_ps(in + count + p);
+				const __m256 b = _mm256_loadu_ps(in + 2 * count + p);
+				const __m256 nx = _mm256_loadu_ps(g + NormalX * count + p);
+				const __m256 ny = _mm256_loadu_ps(g + NormalY * count + p);
+				const __m256 nz = _mm256_loadu_ps(g + NormalZ * count + p);
+				const __m256 ar = _mm256_loadu_ps(g + AlbedoR * count + p);
+				const __m256 ag = _mm256_loadu_ps(g + AlbedoG * count + p);
+				const __m256 ab = _mm256_loadu_ps(g + AlbedoB * count + p);
+				const __m256 variance = _mm256_max_ps(_mm256_loadu_ps(blurredVariance.data() + p), _mm256_set1_ps(MinVariance));
+				const __m256 invColorPhi = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(colorPhi, variance));
+				const __m256 d = _mm256_loadu_ps(g + Depth * count + p);
+				const __m256 invDepth = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_max_ps(d, _mm256_set1_ps(MinDepth)));
+
+				__m256 weightSum = _mm256_setzero_ps();
+				__m256 sumR = _mm256_setzero_ps();
+				__m256 sumG = _mm256_setzero_ps();
+				__m256 sumB = _mm256_setzero_ps();
+				__m256 varianceSum = _mm256_setzero_ps();
+
+				for (int dy = -2; dy <= 2; dy++)
+				{
+					for (int dx = -2; dx <= 2; dx++)
+					{
+						const ptrdiff_t offset = (ptrdiff_t(dy) * width + dx) * pass.step;
+
+						const __m256 colorDistance = DistanceSquared(in, p, offset, r, gr, b, count);
+						const __m256 normalDistance = DistanceSquared(g + NormalX * count, p, offset, nx, ny, nz, count);
+						const __m256 albedoDistance = DistanceSquared(g + AlbedoR * count, p, offset, ar, ag, ab, count);
+						const __m256 dd = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(g + Depth * count + p + offset), d), invDepth);
+
+						__m256 exponent = _mm256_mul_ps(colorDistance, invColorPhi);
+						exponent = Madd(normalDistance, invNormalPhi, exponent);
+						exponent = Madd(albedoDistance, invAlbedoPhi, exponent);
+						exponent = Madd(_mm256_mul_ps(dd, dd), invDepthPhi, exponent);
+
+						const __m256 weight = _mm256_mul_ps(_mm256_set1_ps(Kernel[dy + 2] * Kernel[dx + 2]), Exp(_mm256_xor_ps(exponent, signBit)));
+
+						weightSum = _mm256_add_ps(weightSum, weight);
+						sumR = Madd(weight, _mm256_loadu_ps(in + p + offset), sumR);
+						sumG = Madd(weight, _mm256_loadu_ps(in + count + p + offset), sumG);
+						sumB = Madd(weight, _mm256_loadu_ps(in + 2 * count + p + offset), sumB);
+						varianceSum = Madd(_mm256_mul_ps(weight, weight), _mm256_loadu_ps(in + 3 * count + p + offset), varianceSum);
+					}
+				}
+
+				_mm256_storeu_ps(out + p, _mm256_div_ps(sumR, weightSum));
+				_mm256_storeu_ps(out + count + p, _mm256_div_ps(sumG, weightSum));
+				_mm256_storeu_ps(out + 2 * count + p, _mm256_div_ps(sumB, weightSum));
+				_mm256_storeu_ps(out + 3 * count + p, _mm256_div_ps(varianceSum, _mm256_mul_ps(weightSum, weightSum)));
+			}
+		}
+#endif
+
+		FilterScalar(pass, in, out, y, x, width);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "pch.h"
+
+#include "../ThreadPool.h"
+
+namespace Engine
+{
+	/** @brief Parameters of the edge-avoiding à-trous filter. */
+	struct DenoiserSettings
+	{
+		/// Filter passes. Pass i spaces its 5x5 taps 2^i pixels apart, so five passes
+		/// cover a 125 pixel wide footprint with only 125 taps per pixel.
+		int iterations = 5;
+
+		// Edge-stopping scales: a tap whose squared difference to the centre pixel
+		// equals the scale keeps 1/e of its weight. Smaller values preserve more edges.
+		float colorPhi = 64.0f;	 ///< Colour, in units of the centre pixel's variance.
+		float normalPhi = 0.1f;	 ///< First-hit normal.
+		float albedoPhi = 0.05f; ///< First-hit albedo.
+		float depthPhi = 0.01f;	 ///< First-hit depth, relative to the centre pixel's depth.
+	};
+
+	/**
+	 * @class Denoiser
+	 * @brief Edge-avoiding à-trous wavelet filter (Dammertz et al. 2010) guided by first-hit AOVs.
+	 *
+	 * Each pass blurs the image with a 5x5 B3-spline kernel whose taps are
+	 * 2^pass pixels apart. Every tap is further weighted by how similar its
+	 * colour, normal, albedo and depth are to the centre pixel, so the blur
+	 * stays within surfaces: geometric edges are kept by the normal and depth
+	 * guides and texture or material edges by the albedo guide, none of which
+	 * are noisy at the first hit.
+	 *
+	 * Colour differences are measured against the variance of the centre
+	 * pixel (as in SVGF), so noisy pixels are smoothed strongly while
+	 * converged ones, and lighting detail such as shadow edges, are kept.
+	 * Each pass also filters the variance with the squared weights, so it
+	 * tracks the noise left in the image.
+	 *
+	 * Passes run rows in parallel on a ThreadPool over planar float buffers.
+	 * Interior pixels are filtered eight at a time with AVX2 when the build
+	 * targets it; the scalar loop handles the image border.
+	 */
+	class Denoiser
+	{
+	public:
+
+		Denoiser(ThreadPool& pool, const DenoiserSettings& settings = DenoiserSettings());
+
+		/**
+		 * @brief Filters an image.
+		 * @param color Noisy image as interleaved RGB floats in row-major order.
+		 * @param albedo First-hit albedo, interleaved RGB.
+		 * @param normal First-hit normal, interleaved XYZ; zero where the camera ray missed.
+		 * @param depth First-hit distance, one float per pixel; zero where the camera ray missed.
+		 * @param variance Variance of each pixel's mean luminance, one float per pixel.
+		 * @return The filtered image as interleaved RGB floats.
+		 */
+		std::vector<float> Denoise(const std::vector<float>& color, const std::vector<float>& albedo,
+			const std::vector<float>& normal, const std::vector<float>& depth, const std::vector<float>& variance, int width, int height);
+
+		const DenoiserSettings& Settings() const { return settings; }
+
+	private:
+
+		ThreadPool& pool;
+		DenoiserSettings settings;
+
+		int width = 0, height = 0;
+
+		// Planar working buffers, kept between calls.
+		std::vector<float> colors[2]; ///< R, G, B and variance planes of the pass input and output.
+		std::vector<float> guides;	  ///< Normal XYZ, albedo RGB and depth planes.
+		std::vector<float> blurredVariance; ///< Variance of the pass input after a 3x3 Gaussian.
+
+		/** @brief Per-pass constants shared by the scalar and SIMD kernels. */
+		struct Pass
+		{
+			int step;
+			float colorPhi, invNormalPhi, invAlbedoPhi, invDepthPhi;
+		};
+
+		/** @brief Fills 'blurredVariance' for row y from the variance plane of 'in'. */
+		void BlurVariance(const float* in, int y);
+
+		/** @brief Filters pixels [x0, x1) of row y, checking every tap against the image border. */
+		void FilterScalar(const Pass& pass, const float* in, float* out, int y, int x0, int x1) const;
+
+		/** @brief Filters one row; pixels whose taps are all inside the image go through the SIMD kernel. */
+		void FilterRow(const Pass& pass, const float* in, float* out, int y) const;
+	};
+}
\ No newline at end of file
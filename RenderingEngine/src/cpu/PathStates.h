@@ -0,0 +1,111 @@
+#pragma once
+
+#include "pch.h"
+
+#include "../Ray.h"
+#include "../HitRecord.h"
+#include "../Sampler.h"
+
+namespace Engine
+{
+	/**
+	 * @class PathStates
+	 * @brief Structure-of-arrays state of a batch of paths for wavefront rendering.
+	 *
+	 * Each stage of the wavefront pipeline (generate, extend, shade, shadow)
+	 * streams through only the arrays it needs, so a batch of tens of
+	 * thousands of paths is processed with contiguous, predictable loads
+	 * instead of one path's state scattered through a deep call stack.
+	 *
+	 * Slot i belongs to one pixel sample for the whole life of the batch;
+	 * paths that terminate simply leave the active list.
+	 */
+	struct PathStates
+	{
+		// Current ray of each path.
+		std::vector<Real> originX, originY, originZ;
+		std::vector<Real> directionX, directionY, directionZ;
+
+		// Product of the attenuations along the path so far.
+		std::vector<Real> throughputR, throughputG, throughputB;
+
+		// Radiance gathered by the path so far.
+		std::vector<Real> radianceR, radianceG, radianceB;
+
+		std::vector<uint32_t> pixel; ///< Row-major pixel index.
+		std::vector<Sampler> sampler; ///< Per-sample sampler.
+
+		// Result of the last extend stage.
+		std::vector<uint8_t> hit;
+		std::vector<HitRecord> records;
+
+		// Shadow ray queued by the shade stage: it starts at the hit point, runs
+		// along 'shadowDirection' and adds 'shadowR/G/B' to the radiance if it
+		// reaches the light.
+		std::vector<uint8_t> shadowPending;
+		std::vector<Real> shadowR, shadowG, shadowB;
+		std::vector<Real> shadowDirectionX, shadowDirectionY, shadowDirectionZ;
+
+		size_t Size() const { return pixel.size(); }
+
+		void Resize(size_t size)
+		{
+			for (auto* array : { &originX, &originY, &originZ, &directionX, &directionY, &directionZ,
+				&throughputR, &throughputG, &throughputB, &radianceR, &radianceG, &radianceB, &shadowR, &shadowG, &shadowB,
+				&shadowDirectionX, &shadowDirectionY, &shadowDirectionZ })
+			{
+				array->resize(size);
+			}
+
+			pixel.resize(size);
+			sampler.resize(size);
+			hit.resize(size);
+			records.resize(size);
+			shadowPending.resize(size);
+		}
+
+		/** @brief Starts a new path in slot 'i'. */
+		void Start(size_t i, uint32_t pixelIndex, const Ray& ray, const Sampler& pathSampler)
+		{
+			SetRay(i, ray);
+			throughputR[i] = throughputG[i] = throughputB[i] = 1;
+			radianceR[i] = radianceG[i] = radianceB[i] = 0;
+			pixel[i] = pixelIndex;
+			sampler[i] = pathSampler;
+			shadowPending[i] = false;
+		}
+
+		Ray GetRay(size_t i) const
+		{
+			return Ray(Vector3(originX[i], originY[i], originZ[i]), Vector3(directionX[i], directionY[i], directionZ[i]));
+		}
+
+		void SetRay(size_t i, const Ray& ray)
+		{
+			originX[i] = ray.origin.x;
+			originY[i] = ray.origin.y;
+			originZ[i] = ray.origin.z;
+			directionX[i] = ray.direction.x;
+			directionY[i] = ray.direction.y;
+			directionZ[i] = ray.direction.z;
+		}
+
+		Vector3 Throughput(size_t i) const { return Vector3(throughputR[i], throughputG[i], throughputB[i]); }
+
+		void SetThroughput(size_t i, const Vector3& throughput)
+		{
+			throughputR[i] = throughput.x;
+			throughputG[i] = throughput.y;
+			throughputB[i] = throughput.z;
+		}
+
+		Vector3 Radiance(size_t i) const { return Vector3(radianceR[i], radianceG[i], radianceB[i]); }
+
+		void AddRadiance(size_t i, const Vector3& radiance)
+		{
+			radianceR[i] += radiance.x;
+			radianceG[i] += radiance.y;
+			radianceB[i] += radiance.z;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "pch.h"
+
+#include "BenchmarkRunner.h"
+
+namespace RenderingEngineBench
+{
+	namespace
+	{
+		/// Every checksum is stored here, so no benchmark's work is dead code.
+		volatile double checksumSink = 0.0;
+
+		using Clock = std::chrono::steady_clock;
+
+		/** @brief Runs one call and returns its duration in nanoseconds. */
+		double TimeCall(const Benchmark& benchmark, uint64_t iterations, uint64_t& items)
+		{
+			const auto start = Clock::now();
+			const BenchmarkWork work = benchmark.run(iterations);
+			const auto end = Clock::now();
+
+			checksumSink = checksumSink + work.checksum;
+			items = std::max<uint64_t>(work.items, 1);
+
+			return std::chrono::duration<double, std::nano>(end - start).count();
+		}
+
+		/** @brief Extracts the value following '"key": ' in a line, or an empty string. */
+		std::string FieldValue(const std::string& line, const std::string& key)
+		{
+			const std::string pattern = "\"" + key + "\": ";
+			const size_t start = line.find(pattern);
+			if (start == std::string::npos)
+			{
+				return "";
+			}
+
+			size_t begin = start + pattern.size();
+			size_t end;
+			if (begin < line.size() && line[begin] == '"')
+			{
+				begin++;
+				end = line.find('"', begin);
+			}
+			else
+			{
+				end = line.find_first_of(",}", begin);
+			}
+
+			return end == std::string::npos ? "" : line.substr(begin, end - begin);
+		}
+	}
+
+	std::vector<BenchmarkResult> BenchmarkRunner::Run(const std::string& filter, std::ostream& log) const
+	{
+		std::vector<BenchmarkResult> results;
+
+		for (const Benchmark& benchmark : benchmarks)
+		{
+			if (benchmark.name.find(filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			const BenchmarkResult result = Run(benchmark);
+
+			char line[256];
+			std::snprintf(line, sizeof(line), "%-32s %12.2f ns/%-6s %12.3f M%ss/s  (min %.2f, stddev %.1f%%)",
+				result.name.c_str(), result.medianNs, result.unit.c_str(), result.ItemsPerSecond() / 1e6, result.unit.c_str(),
+				result.minNs, result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0);
+			log << line << std::endl;
+
+			results.push_back(result);
+		}
+
+		return results;
+	}
+
+	BenchmarkResult BenchmarkRunner::Run(const Benchmark& benchmark) const
+	{
+		BenchmarkResult result;
+		result.name = benchmark.name;
+		result.unit = benchmark.unit;
+
+		// Warm up while doubling the iteration count until one call is long
+		// enough to time reliably, then scale it to the sample length.
+		const double sampleNs = settings.sampleMs * 1e6;
+
+		uint64_t iterations = 1;
+		uint64_t items = 0;
+		double elapsedNs = 0.0;
+		double warmupNs = 0.0;
+
+		while (true)
+		{
+			elapsedNs = TimeCall(benchmark, iterations, items);
+			warmupNs += elapsedNs;
+
+			if (warmupNs >= settings.warmupMs * 1e6 && elapsedNs >= sampleNs / 4)
+			{
+				break;
+			}
+
+			if (elapsedNs < sampleNs / 4)
+			{
+				iterations *= 2;
+			}
+		}
+
+		result.iterations = std::max<uint64_t>(1, uint64_t(double(iterations) * sampleNs / std::max(elapsedNs, 1.0)));
+
+		for (int sample = 0; sample < std::max(settings.samples, 1); sample++)
+		{
+			const double ns = TimeCall(benchmark, result.iterations, items);
+			result.samples.push_back(ns / double(items));
+		}
+
+		std::vector<double> sorted = result.samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		const size_t count = sorted.size();
+		result.minNs = sorted.front();
+		result.medianNs = (count % 2) ? sorted[count / 2] : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+
+		double sum = 0.0;
+		for (const double ns : sorted)
+		{
+			sum += ns;
+		}
+		result.meanNs = sum / count;
+
+		double squares = 0.0;
+		for (const double ns : sorted)
+		{
+			squares += (ns - result.meanNs) * (ns - result.meanNs);
+		}
+		result.stddevNs = count > 1 ? std::sqrt(squares / (count - 1)) : 0.0;
+
+		return result;
+	}
+
+	void WriteBaseline(std::ostream& out, const std::vector<BenchmarkResult>& results, const std::vector<std::pair<std::string, std::string>>& context)
+	{
+		out << "{\n";
+		for (const auto& [key, value] : context)
+		{
+			out << "  \"" << key << "\": \"" << value << "\",\n";
+		}
+
+		// One benchmark per line, which is what ReadBaseline() relies on.
+		out << "  \"benchmarks\": [\n";
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const BenchmarkResult& result = results[i];
+
+			char line[512];
+			std::snprintf(line, sizeof(line),
+				"    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %llu, \"samples\": %zu, "
+				"\"medianNs\": %.4f, \"minNs\": %.4f, \"meanNs\": %.4f, \"stddevNs\": %.4f, \"itemsPerSecond\": %.1f}%s\n",
+				result.name.c_str(), result.unit.c_str(), (unsigned long long)result.iterations, result.samples.size(),
+				result.medianNs, result.minNs, result.meanNs, result.stddevNs, result.ItemsPerSecond(),
+				i + 1 < results.size() ? "," : "");
+			out << line;
+		}
+		out << "  ]\n}\n";
+	}
+
+	std::map<std::string, double> ReadBaseline(std::istream& in)
+	{
+		std::map<std::string, double> medians;
+
+		std::string line;
+		while (std::getline(in, line))
+		{
+			const std::string name = FieldValue(line, "name");
+			const std::string median = FieldValue(line, "medianNs");
+
+			if (!name.empty() && !median.empty())
+			{
+				medians[name] = std::strtod(median.c_str(), nullptr);
+			}
+		}
+
+		return medians;
+	}
+}
\ No newline at end of file
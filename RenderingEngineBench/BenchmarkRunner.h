@@ -0,0 +1,88 @@
+#pragma once
+
+#include "pch.h"
+
+namespace RenderingEngineBench
+{
+	/** @brief What one timed call of a benchmark did. */
+	struct BenchmarkWork
+	{
+		uint64_t items = 0;	   ///< Operations performed (rays traced, vectors generated, ...).
+		double checksum = 0.0; ///< Depends on every result, so the compiler cannot drop the work.
+	};
+
+	/** @brief A named piece of work that performs 'iterations' repetitions per call. */
+	struct Benchmark
+	{
+		std::string name;
+		std::string unit; ///< What one item is, e.g. "ray" or "vector".
+		std::function<BenchmarkWork(uint64_t iterations)> run;
+	};
+
+	/** @brief Timing statistics of one benchmark, per item. */
+	struct BenchmarkResult
+	{
+		std::string name;
+		std::string unit;
+		uint64_t iterations = 0;	  ///< Iterations per sample, found by calibration.
+		std::vector<double> samples; ///< Nanoseconds per item of every sample.
+
+		double minNs = 0.0;
+		double medianNs = 0.0;
+		double meanNs = 0.0;
+		double stddevNs = 0.0;
+
+		double ItemsPerSecond() const { return medianNs > 0.0 ? 1e9 / medianNs : 0.0; }
+	};
+
+	/** @brief Parameters shared by every benchmark of a run. */
+	struct BenchmarkSettings
+	{
+		int samples = 15;			 ///< Timed samples per benchmark.
+		double warmupMs = 100.0;	 ///< Untimed running before calibration settles.
+		double sampleMs = 20.0;		 ///< Target duration of one sample.
+	};
+
+	/**
+	 * @class BenchmarkRunner
+	 * @brief Runs registered benchmarks with warm-up, calibration and repeated samples.
+	 *
+	 * Each benchmark first runs untimed for 'warmupMs' while the iteration
+	 * count doubles, which warms caches, branch predictors and the thread
+	 * pool. The count is then scaled so one sample takes about 'sampleMs',
+	 * and 'samples' samples are timed. The median is the reported figure, as
+	 * it ignores the occasional sample disturbed by the operating system.
+	 */
+	class BenchmarkRunner
+	{
+	public:
+
+		explicit BenchmarkRunner(const BenchmarkSettings& settings = BenchmarkSettings()) : settings(settings) {}
+
+		void Add(Benchmark benchmark) { benchmarks.push_back(std::move(benchmark)); }
+
+		/**
+		 * @brief Runs every benchmark whose name contains 'filter' and prints a line for each to 'log'.
+		 * @return Results in registration order.
+		 */
+		std::vector<BenchmarkResult> Run(const std::string& filter, std::ostream& log) const;
+
+		const BenchmarkSettings& Settings() const { return settings; }
+
+	private:
+
+		BenchmarkSettings settings;
+		std::vector<Benchmark> benchmarks;
+
+		BenchmarkResult Run(const Benchmark& benchmark) const;
+	};
+
+	/**
+	 * @brief Writes results as a JSON baseline.
+	 * @param context Extra top-level string fields describing the machine and build.
+	 */
+	void WriteBaseline(std::ostream& out, const std::vector<BenchmarkResult>& results, const std::vector<std::pair<std::string, std::string>>& context);
+
+	/** @brief Reads the median nanoseconds per item of each benchmark from a baseline written by WriteBaseline(). */
+	std::map<std::string, double> ReadBaseline(std::istream& in);
+}
\ No newline at end of file
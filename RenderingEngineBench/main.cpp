@@ -0,0 +1,567 @@
+#include "pch.h"
+
+#include <ctime>
+
+#include <src/BVH.h>
+#include <src/BulkRandom.h>
+#include <src/Camera.h>
+#include <src/GridAccelerator.h>
+#include <src/Lambertian.h>
+#include <src/Random.h>
+#include <src/Sampler.h>
+#include <src/Sampling.h>
+#include <src/Sphere.h>
+#include <src/ThreadPool.h>
+#include <src/cpu/CpuRenderer.h>
+
+#include "BenchmarkRunner.h"
+
+namespace RenderingEngineBench
+{
+	using namespace Engine;
+
+	/** @brief Command line of a benchmark run. */
+	struct Options
+	{
+		std::string filter;				 ///< Only run benchmarks whose name contains this.
+		BenchmarkSettings settings;
+		unsigned threads = 0;			 ///< Threads of the full-frame and build benchmarks; zero uses every core.
+		std::string output;				 ///< Write the results as a JSON baseline here.
+		std::string baseline;			 ///< Compare against a baseline written by an earlier run.
+		double threshold = 0.10;		 ///< Relative slowdown of the median reported as a regression.
+		bool failOnRegression = false;
+	};
+
+	/// Number of pre-generated rays each ray benchmark cycles through; a power of two.
+	constexpr size_t RayCount = 4096;
+
+	/** @brief Rays from the origin towards random points of a box, generated from a fixed seed. */
+	std::vector<Ray> MakeRays(const Vector3& boxMin, const Vector3& boxMax, uint64_t seed)
+	{
+		Random random(seed, 1);
+
+		std::vector<Ray> rays;
+		rays.reserve(RayCount);
+		for (size_t i = 0; i < RayCount; i++)
+		{
+			const Vector3 target = boxMin + random.RandomVector3() * (boxMax - boxMin);
+			rays.emplace_back(Vector3(), Vector3::Normalize(target));
+		}
+
+		return rays;
+	}
+
+	/** @brief 'count' spheres of radius 0.3 scattered through the box the rays aim at. */
+	HittableList MakeSpheres(int count, const Vector3& boxMin, const Vector3& boxMax, uint64_t seed)
+	{
+		Random random(seed, 2);
+
+		HittableList list;
+		for (int i = 0; i < count; i++)
+		{
+			list.Add(std::make_shared<Sphere>(boxMin + random.RandomVector3() * (boxMax - boxMin), Real(0.3)));
+		}
+
+		return list;
+	}
+
+	/** @brief Closest-hit benchmark of a Hittable against the pre-generated rays. */
+	Benchmark HitBenchmark(const std::string& name, std::shared_ptr<const Hittable> object, std::shared_ptr<const std::vector<Ray>> rays)
+	{
+		return { name, "ray", [object, rays](uint64_t iterations)
+			{
+				const Interval ray_t(Real(0.001), std::numeric_limits<Real>::infinity());
+
+				BenchmarkWork work;
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					HitRecord record;
+					if (object->Hit((*rays)[i & (RayCount - 1)], ray_t, record))
+					{
+						work.checksum += record.t;
+					}
+				}
+
+				work.items = iterations;
+				return work;
+			} };
+	}
+
+	/** @brief Full-frame benchmark: renders a diffuse sphere scene from a cleared buffer per iteration. */
+	Benchmark RenderBenchmark(const std::string& name, bool wavefront, unsigned threads)
+	{
+		struct Frame
+		{
+			MaterialTable materials;
+			std::unique_ptr<BVH> world;
+			std::unique_ptr<Camera> camera;
+			std::unique_ptr<CpuRenderer> renderer;
+		};
+
+		auto frame = std::make_shared<Frame>();
+
+		Random random(7, 3);
+		HittableList list;
+
+		const uint32_t ground = frame->materials.Add(std::make_shared<Lambertian>(Vector3(0.5, 0.5, 0.5)));
+		list.Add(std::make_shared<Sphere>(Vector3(0.0, -1000.5, -1.0), 1000.0, ground));
+
+		for (int i = 0; i < 256; i++)
+		{
+			const uint32_t material = frame->materials.Add(std::make_shared<Lambertian>(random.RandomVector3()));
+			const Vector3 center(Real(random.RandomDouble(-6.0, 6.0)), Real(-0.3), Real(random.RandomDouble(-14.0, -2.0)));
+			list.Add(std::make_shared<Sphere>(center, Real(0.2), material));
+		}
+
+		frame->world = std::make_unique<BVH>(list);
+		frame->camera = std::make_unique<Camera>(320, 1.5);
+
+		CpuRenderSettings settings;
+		settings.samplesPerPixel = 2;
+		settings.threadCount = threads;
+		settings.wavefront = wavefront;
+		settings.sunDirection = Vector3(1.0, 2.0, 0.5);
+		settings.sunRadiance = Vector3(2.0, 2.0, 2.0);
+
+		frame->renderer = std::make_unique<CpuRenderer>(frame->camera->ImageWidth(), frame->camera->ImageHeight(), settings);
+
+		return { name, "ray", [frame](uint64_t iterations)
+			{
+				BenchmarkWork work;
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					frame->renderer->Clear();
+					frame->renderer->Render(*frame->camera, *frame->world, &frame->materials);
+
+					work.items += frame->renderer->Stats().rays;
+					work.checksum += frame->renderer->AccumulationBuffer()[0];
+				}
+
+				return work;
+			} };
+	}
+
+	void AddBenchmarks(BenchmarkRunner& runner, unsigned threads)
+	{
+		const Vector3 boxMin(-5.0, -5.0, -15.0);
+		const Vector3 boxMax(5.0, 5.0, -5.0);
+		const auto rays = std::make_shared<const std::vector<Ray>>(MakeRays(boxMin, boxMax, 1));
+
+		// A unit sphere filling about a third of the ray targets, so hits and misses mix.
+		const auto sphereRays = std::make_shared<const std::vector<Ray>>(MakeRays(Vector3(-2.0, -2.0, -6.0), Vector3(2.0, 2.0, -4.0), 2));
+		runner.Add(HitBenchmark("Sphere::Hit", std::make_shared<Sphere>(Vector3(0.0, 0.0, -5.0), 1.0), sphereRays));
+
+		for (const int count : { 1, 16, 256, 4096 })
+		{
+			const auto list = std::make_shared<HittableList>(MakeSpheres(count, boxMin, boxMax, 3));
+			runner.Add(HitBenchmark("HittableList::Hit/" + std::to_string(count), list, rays));
+		}
+
+		for (const int count : { 256, 4096, 65536 })
+		{
+			const auto bvh = std::make_shared<BVH>(MakeSpheres(count, boxMin, boxMax, 3));
+			runner.Add(HitBenchmark("BVH::Hit/" + std::to_string(count), bvh, rays));
+		}
+
+		for (const int count : { 4096, 65536 })
+		{
+			BVHBuildOptions options;
+			options.layout = BVHLayout::Wide8;
+
+			const auto bvh = std::make_shared<BVH>(MakeSpheres(count, boxMin, boxMax, 3), options);
+			runner.Add(HitBenchmark("BVH::Hit/wide/" + std::to_string(count), bvh, rays));
+		}
+
+		for (const int count : { 4096, 65536 })
+		{
+			const auto grid = std::make_shared<GridAccelerator>(MakeSpheres(count, boxMin, boxMax, 3));
+			runner.Add(HitBenchmark("GridAccelerator::Hit/" + std::to_string(count), grid, rays));
+		}
+
+		// Builds run on one pool shared by every build benchmark, sized like the render benchmarks.
+		const auto buildPool = std::make_shared<ThreadPool>(threads);
+		const auto buildBounds = std::make_shared<std::vector<AABB>>();
+		for (const auto& object : MakeSpheres(65536, boxMin, boxMax, 3).objects)
+		{
+			buildBounds->push_back(object->BoundingBox());
+		}
+
+		for (const BVHBuildMode mode : { BVHBuildMode::Quality, BVHBuildMode::Fast })
+		{
+			const std::string name = std::string("BVHTree::Build/") + (mode == BVHBuildMode::Fast ? "fast" : "quality") + "/65536";
+
+			runner.Add({ name, "primitive", [buildPool, buildBounds, mode](uint64_t iterations)
+				{
+					BVHBuildOptions options;
+					options.mode = mode;
+					options.pool = buildPool.get();
+
+					BenchmarkWork work;
+					for (uint64_t i = 0; i < iterations; i++)
+					{
+						BVHTree tree;
+						tree.Build(*buildBounds, options);
+						work.checksum += tree.BuildStats().sahCost;
+						work.items += buildBounds->size();
+					}
+
+					return work;
+				} });
+		}
+
+		// A per-frame rebuild of the same particles, reusing the grid's memory.
+		GridBuildOptions gridOptions;
+		gridOptions.pool = buildPool.get();
+
+		const auto gridObjects = std::make_shared<HittableList>(MakeSpheres(65536, boxMin, boxMax, 3));
+		const auto grid = std::make_shared<GridAccelerator>(*gridObjects, gridOptions);
+
+		runner.Add({ "GridAccelerator::Update/65536", "primitive", [buildPool, gridObjects, grid](uint64_t iterations)
+			{
+				BenchmarkWork work;
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					grid->Update(*gridObjects);
+					work.checksum += double(grid->BuildStats().referenceCount);
+					work.items += gridObjects->objects.size();
+				}
+
+				return work;
+			} });
+
+		runner.Add({ "Camera::GetJitteredRay", "ray", [](uint64_t iterations)
+			{
+				static const Camera camera(SCREEN_WIDTH, ASPECT_RATIO);
+				Random random(4, 4);
+
+				BenchmarkWork work;
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					const int pixel = int(i % uint64_t(camera.ImageWidth() * camera.ImageHeight()));
+					const Ray ray = camera.GetJitteredRay(pixel % camera.ImageWidth(), pixel / camera.ImageWidth(), random);
+					work.checksum += ray.direction.x;
+				}
+
+				work.items = iterations;
+				return work;
+			} });
+
+		runner.Add({ "Random::RandomUnitVector3", "vector", [](uint64_t iterations)
+			{
+				Random random(5, 5);
+
+				BenchmarkWork work;
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					work.checksum += random.RandomUnitVector3().x;
+				}
+
+				work.items = iterations;
+				return work;
+			} });
+
+		for (const auto& [name, type] : { std::pair("independent", SamplerType::Independent), std::pair("sobol", SamplerType::Sobol),
+			std::pair("halton", SamplerType::Halton), std::pair("r2", SamplerType::R2) })
+		{
+			runner.Add({ std::string("Sampler::Get2D/") + name, "sample", [type](uint64_t iterations)
+				{
+					// Eight dimensions per pixel sample, about one path's worth.
+					BenchmarkWork work;
+					for (uint64_t i = 0; i < iterations; i += 8)
+					{
+						Sampler sampler(type, uint32_t(i >> 3) & 63, 0, uint32_t(i >> 9));
+						for (int dimension = 0; dimension < 8; dimension++)
+						{
+							work.checksum += sampler.Get2D().x;
+						}
+					}
+
+					work.items = (iterations + 7) & ~uint64_t(7);
+					return work;
+				} });
+		}
+
+		runner.Add({ "Random::RandomDouble", "number", [](uint64_t iterations)
+			{
+				Random random(5, 5);
+
+				BenchmarkWork work;
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					work.checksum += random.RandomDouble();
+				}
+
+				work.items = iterations;
+				return work;
+			} });
+
+		runner.Add({ "BulkRandom::Fill/double", "number", [](uint64_t iterations)
+			{
+				constexpr size_t batch = 4096;
+				static std::vector<double> out(batch);
+				BulkRandom random(5, 5);
+
+				BenchmarkWork work;
+				for (uint64_t done = 0; done < iterations; done += batch)
+				{
+					random.Fill(out.data(), batch);
+					work.checksum += out[done & (batch - 1)];
+					work.items += batch;
+				}
+
+				return work;
+			} });
+
+		runner.Add({ "BulkRandom::Fill/float", "number", [](uint64_t iterations)
+			{
+				constexpr size_t batch = 4096;
+				static std::vector<float> out(batch);
+				BulkRandom random(5, 5);
+
+				BenchmarkWork work;
+				for (uint64_t done = 0; done < iterations; done += batch)
+				{
+					random.Fill(out.data(), batch);
+					work.checksum += out[done & (batch - 1)];
+					work.items += batch;
+				}
+
+				return work;
+			} });
+
+		runner.Add({ "BulkRandom::FillUnitVector3", "vector", [](uint64_t iterations)
+			{
+				constexpr size_t batch = 1024;
+				static std::vector<Real> x(batch), y(batch), z(batch);
+				BulkRandom random(5, 5);
+
+				BenchmarkWork work;
+				for (uint64_t done = 0; done < iterations; done += batch)
+				{
+					random.FillUnitVector3(x.data(), y.data(), z.data(), batch);
+					work.checksum += z[done & (batch - 1)];
+					work.items += batch;
+				}
+
+				return work;
+			} });
+
+		runner.Add({ "SampleCosineHemisphere", "vector", [](uint64_t iterations)
+			{
+				BenchmarkWork work;
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					const Vector2 u(double(i & 1023) / 1024.0, double((i * 7) & 1023) / 1024.0);
+					work.checksum += SampleCosineHemisphere(u).z;
+				}
+
+				work.items = iterations;
+				return work;
+			} });
+
+		runner.Add({ "SampleCosineHemisphere/batch", "vector", [](uint64_t iterations)
+			{
+				// Directions for 1024 samples per call, written as structure-of-arrays.
+				constexpr size_t batch = 1024;
+				static std::vector<Real> u0(batch), u1(batch), x(batch), y(batch), z(batch);
+
+				Random random(6, 6);
+				for (size_t i = 0; i < batch; i++)
+				{
+					u0[i] = Real(random.RandomDouble());
+					u1[i] = Real(random.RandomDouble());
+				}
+
+				BenchmarkWork work;
+				for (uint64_t done = 0; done < iterations; done += batch)
+				{
+					SampleCosineHemisphere(u0.data(), u1.data(), x.data(), y.data(), z.data(), batch);
+					work.checksum += z[done & (batch - 1)];
+					work.items += batch;
+				}
+
+				return work;
+			} });
+
+		runner.Add(RenderBenchmark("CpuRenderer::Render", false, threads));
+		runner.Add(RenderBenchmark("CpuRenderer::Render/wavefront", true, threads));
+	}
+
+	void PrintUsage()
+	{
+		std::cerr <<
+			"Usage: RenderingEngineBench [options]\n"
+			"  --filter <text>         Only run benchmarks whose name contains the text\n"
+			"  --samples <n>           Timed samples per benchmark (default: 15)\n"
+			"  --warmup-ms <ms>        Untimed warm-up per benchmark (default: 100)\n"
+			"  --sample-ms <ms>        Target duration of one sample (default: 20)\n"
+			"  --threads <n>           Threads of the full-frame and build benchmarks, 0 for all cores (default: 0)\n"
+			"  --output <file>         Save the results as a JSON baseline\n"
+			"  --baseline <file>       Compare the medians against an earlier baseline\n"
+			"  --threshold <fraction>  Slowdown reported as a regression (default: 0.10)\n"
+			"  --fail-on-regression    Exit with an error if any benchmark regressed\n";
+	}
+
+	std::optional<Options> ParseOptions(int argc, char** argv)
+	{
+		Options options;
+
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string argument = argv[i];
+
+			const auto value = [&]() -> std::string
+				{
+					if (i + 1 >= argc)
+					{
+						throw std::runtime_error("Missing value for " + argument + "!");
+					}
+
+					return argv[++i];
+				};
+
+			const auto number = [&]() -> double
+				{
+					const std::string text = value();
+
+					char* end = nullptr;
+					const double result = std::strtod(text.c_str(), &end);
+					if (text.empty() || *end != '\0' || result < 0.0)
+					{
+						throw std::runtime_error("Invalid value '" + text + "' for " + argument + "!");
+					}
+
+					return result;
+				};
+
+			if (argument == "--help" || argument == "-h")
+			{
+				PrintUsage();
+				return std::nullopt;
+			}
+			else if (argument == "--filter") options.filter = value();
+			else if (argument == "--samples") options.settings.samples = std::max(1, int(number()));
+			else if (argument == "--warmup-ms") options.settings.warmupMs = number();
+			else if (argument == "--sample-ms") options.settings.sampleMs = number();
+			else if (argument == "--threads") options.threads = unsigned(number());
+			else if (argument == "--output") options.output = value();
+			else if (argument == "--baseline") options.baseline = value();
+			else if (argument == "--threshold") options.threshold = number();
+			else if (argument == "--fail-on-regression") options.failOnRegression = true;
+			else
+			{
+				throw std::runtime_error("Unknown option " + argument + " (see --help)!");
+			}
+		}
+
+		return options;
+	}
+
+	/** @brief Describes the build and machine, stored with the baseline so results are only compared like for like. */
+	std::vector<std::pair<std::string, std::string>> RunContext()
+	{
+		char date[32];
+		const std::time_t now = std::time(nullptr);
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+#if defined(__clang__)
+		const std::string compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+		const std::string compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+		const std::string compiler = "msvc " + std::to_string(_MSC_VER);
+#else
+		const std::string compiler = "unknown";
+#endif
+
+#if defined(__AVX2__)
+		const std::string simd = "avx2";
+#else
+		const std::string simd = "none";
+#endif
+
+		return {
+			{ "date", date },
+			{ "compiler", compiler },
+			{ "precision", sizeof(Real) == sizeof(float) ? "float" : "double" },
+			{ "simd", simd },
+			{ "hardwareThreads", std::to_string(std::thread::hardware_concurrency()) },
+		};
+	}
+
+	int Run(int argc, char** argv)
+	{
+		const std::optional<Options> parsed = ParseOptions(argc, argv);
+		if (!parsed)
+		{
+			return EXIT_SUCCESS;
+		}
+
+		const Options& options = *parsed;
+
+		BenchmarkRunner runner(options.settings);
+		AddBenchmarks(runner, options.threads);
+
+		const std::vector<BenchmarkResult> results = runner.Run(options.filter, std::cout);
+
+		if (!options.output.empty())
+		{
+			std::ofstream file(options.output);
+			WriteBaseline(file, results, RunContext());
+			if (!file)
+			{
+				throw std::runtime_error("Failed to write baseline '" + options.output + "'!");
+			}
+		}
+
+		if (options.baseline.empty())
+		{
+			return EXIT_SUCCESS;
+		}
+
+		std::ifstream file(options.baseline);
+		if (!file)
+		{
+			throw std::runtime_error("Failed to read baseline '" + options.baseline + "'!");
+		}
+
+		const std::map<std::string, double> baseline = ReadBaseline(file);
+
+		int regressions = 0;
+		std::cout << "\nCompared with " << options.baseline << ":\n";
+
+		for (const BenchmarkResult& result : results)
+		{
+			const auto previous = baseline.find(result.name);
+			if (previous == baseline.end() || previous->second <= 0.0)
+			{
+				continue;
+			}
+
+			const double change = result.medianNs / previous->second - 1.0;
+			const bool regressed = change > options.threshold;
+			regressions += regressed;
+
+			char line[256];
+			std::snprintf(line, sizeof(line), "%-32s %+7.1f%%%s", result.name.c_str(), 100.0 * change, regressed ? "  REGRESSION" : "");
+			std::cout << line << "\n";
+		}
+
+		std::cout << regressions << " regression(s) above " << 100.0 * options.threshold << "%" << std::endl;
+
+		return (options.failOnRegression && regressions > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		return RenderingEngineBench::Run(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "pch.h"
+
+#include "ImageOutput.h"
+
+namespace RenderingEngineCLI
+{
+	namespace
+	{
+		uint8_t ToSrgb8(float linear)
+		{
+			const float v = std::clamp(linear, 0.0f, 1.0f);
+			const float encoded = v <= 0.0031308f ? 12.92f * v : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+
+			return uint8_t(encoded * 255.0f + 0.5f);
+		}
+
+		void WritePpm(std::ofstream& file, const std::vector<float>& rgb, int width, int height)
+		{
+			file << "P6\n" << width << " " << height << "\n255\n";
+
+			std::vector<uint8_t> bytes(rgb.size());
+			for (size_t i = 0; i < rgb.size(); i++)
+			{
+				bytes[i] = ToSrgb8(rgb[i]);
+			}
+
+			file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+		}
+
+		void WritePfm(std::ofstream& file, const std::vector<float>& rgb, int width, int height)
+		{
+			// A negative scale marks little-endian data; rows are stored bottom to top.
+			file << "PF\n" << width << " " << height << "\n-1.0\n";
+
+			const size_t rowFloats = size_t(width) * 3;
+			for (int y = height - 1; y >= 0; y--)
+			{
+				file.write(reinterpret_cast<const char*>(&rgb[size_t(y) * rowFloats]), std::streamsize(rowFloats * sizeof(float)));
+			}
+		}
+	}
+
+	void WriteImage(const std::string& path, const std::vector<float>& rgb, int width, int height)
+	{
+		if (rgb.size() != size_t(width) * height * 3)
+		{
+			throw std::runtime_error("Image buffer does not match the image size!");
+		}
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+		{
+			throw std::runtime_error("Failed to open output image '" + path + "'!");
+		}
+
+		const bool pfm = path.size() >= 4 && path.compare(path.size() - 4, 4, ".pfm") == 0;
+		if (pfm)
+		{
+			WritePfm(file, rgb, width, height);
+		}
+		else
+		{
+			WritePpm(file, rgb, width, height);
+		}
+
+		if (!file)
+		{
+			throw std::runtime_error("Failed to write output image '" + path + "'!");
+		}
+	}
+}
\ No newline at end of file
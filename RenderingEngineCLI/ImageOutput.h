@@ -0,0 +1,17 @@
+#pragma once
+
+#include "pch.h"
+
+namespace RenderingEngineCLI
+{
+	/**
+	 * @brief Writes an RGB float image, choosing the format by the file extension.
+	 *
+	 * ".pfm" keeps the linear radiance as 32-bit floats; anything else is
+	 * written as a binary 8-bit PPM with the sRGB transfer curve applied.
+	 *
+	 * @param rgb Interleaved linear RGB floats in row-major order, top row first.
+	 * @throws std::runtime_error if the file cannot be written.
+	 */
+	void WriteImage(const std::string& path, const std::vector<float>& rgb, int width, int height);
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "pch.h"
+
+#include "Scenes.h"
+
+#include <src/Lambertian.h>
+#include <src/SceneCache.h>
+#include <src/Sphere.h>
+
+#if defined(ENGINE_WITH_GLTF)
+#include <src/AssetLoader.h>
+#endif
+
+namespace RenderingEngineCLI
+{
+	using namespace Engine;
+
+	SceneDescription BuildSpheresScene(int count, uint64_t seed)
+	{
+		SceneDescription scene;
+		scene.name = "builtin:spheres";
+
+		std::mt19937_64 generator(seed);
+		std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+		const uint32_t ground = scene.materials.Add(std::make_shared<Lambertian>(Vector3(0.5, 0.5, 0.5)));
+		scene.objects.Add(std::make_shared<Sphere>(Vector3(0.0, -1000.5, -1.0), 1000.0, ground));
+
+		// Scatter the spheres on a grid in front of the camera, jittered within each cell.
+		const int side = std::max(1, int(std::ceil(std::sqrt(double(count)))));
+		const double cell = 12.0 / side;
+		const double radius = 0.35 * cell;
+
+		for (int i = 0; i < count; i++)
+		{
+			const double x = -6.0 + (i % side + 0.15 + 0.7 * unit(generator)) * cell;
+			const double z = -2.0 - (i / side + 0.15 + 0.7 * unit(generator)) * cell;
+
+			const Vector3 albedo(Real(unit(generator)), Real(unit(generator)), Real(unit(generator)));
+			const uint32_t material = scene.materials.Add(std::make_shared<Lambertian>(albedo * albedo));
+
+			scene.objects.Add(std::make_shared<Sphere>(Vector3(Real(x), Real(radius - 0.5), Real(z)), Real(radius), material));
+		}
+
+		return scene;
+	}
+
+	SceneDescription BuildParticlesScene(int count, uint64_t seed)
+	{
+		SceneDescription scene;
+		scene.name = "builtin:particles";
+
+		std::mt19937_64 generator(seed);
+		std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+		// A few shades of water, so a million particles do not need a million materials.
+		constexpr int Shades = 8;
+		for (int i = 0; i < Shades; i++)
+		{
+			const double shade = double(i) / (Shades - 1);
+			scene.materials.Add(std::make_shared<Lambertian>(Vector3(Real(0.1 + 0.2 * shade), Real(0.3 + 0.3 * shade), Real(0.6 + 0.3 * shade))));
+		}
+
+		// Fill a box in front of the camera; the radius keeps the particles a
+		// fraction of their mean spacing apart whatever their number.
+		const Vector3 low(-4.0, -3.0, -13.0);
+		const Vector3 size(8.0, 6.0, 8.0);
+		const double spacing = std::cbrt(size.x * size.y * size.z / std::max(count, 1));
+		const Real radius = Real(0.3 * spacing);
+
+		for (int i = 0; i < count; i++)
+		{
+			const Vector3 position(Real(low.x + unit(generator) * size.x), Real(low.y + unit(generator) * size.y), Real(low.z + unit(generator) * size.z));
+			scene.objects.Add(std::make_shared<Sphere>(position, radius, uint32_t(generator() % Shades)));
+		}
+
+		return scene;
+	}
+
+	SceneDescription LoadGltfScene(const std::string& filePath, const std::string& cacheDirectory)
+	{
+		SceneDescription scene;
+		scene.name = filePath;
+
+		std::filesystem::path cachePath;
+		uint64_t contentHash = 0;
+
+		if (!cacheDirectory.empty())
+		{
+			contentHash = SceneCache::HashFile(filePath);
+			cachePath = std::filesystem::path(cacheDirectory) / SceneCache::FileName(contentHash);
+			scene.cache = SceneCache::Load(cachePath, contentHash, scene.objects, scene.materials) ? SceneCacheResult::Hit : SceneCacheResult::Miss;
+		}
+
+		if (scene.cache != SceneCacheResult::Hit)
+		{
+#if defined(ENGINE_WITH_GLTF)
+			scene.objects = AssetLoader::LoadTriangleMeshes(filePath);
+			scene.materials = AssetLoader::LoadMaterials(filePath);
+
+			if (scene.objects.objects.empty())
+			{
+				throw std::runtime_error("glTF file contains no triangle meshes!");
+			}
+
+			// Without glTF materials every mesh is grey.
+			if (scene.materials.Size() == 0)
+			{
+				scene.materials.Add(std::make_shared<Lambertian>(Vector3(0.5, 0.5, 0.5)));
+			}
+
+			// The scene is loaded already, so an unwritable cache only costs the next run a rebuild.
+			if (!cachePath.empty())
+			{
+				try
+				{
+					std::filesystem::create_directories(cacheDirectory);
+					SceneCache::Write(cachePath, contentHash, scene.objects, scene.materials);
+				}
+				catch (const std::exception& e)
+				{
+					std::cerr << "Warning: could not write scene cache: " << e.what() << std::endl;
+				}
+			}
+#else
+			throw std::runtime_error("glTF scenes need a build with fastgltf (ENGINE_WITH_GLTF)!");
+#endif
+		}
+
+		// Move the bounding sphere of the scene in front of the camera, far
+		// enough to fit its 90 degree vertical field of view with some margin.
+		const AABB bounds = scene.objects.BoundingBox();
+		const Vector3 center = Real(0.5) * (bounds.Min() + bounds.Max());
+		const Real radius = Real(0.5) * (bounds.Max() - bounds.Min()).Length();
+
+		scene.offset = Vector3(-center.x, -center.y, -center.z - Real(1.6) * std::max(radius, Real(1e-3)));
+
+		return scene;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "pch.h"
+
+#include <src/HittableList.h>
+#include <src/MaterialTable.h>
+
+namespace RenderingEngineCLI
+{
+	/** @brief Whether a scene came from a SceneCache file. */
+	enum class SceneCacheResult
+	{
+		Off,  ///< No cache directory, or a built-in scene.
+		Hit,  ///< Meshes, BVHs and materials were mapped from the cache.
+		Miss  ///< The scene was loaded from its source and written to the cache.
+	};
+
+	/** @brief Objects and materials of a scene, before its acceleration structure is built. */
+	struct SceneDescription
+	{
+		std::string name;
+		Engine::HittableList objects;
+		Engine::MaterialTable materials;
+		SceneCacheResult cache = SceneCacheResult::Off;
+
+		// Directional light, as in CpuRenderSettings.
+		Engine::Vector3 sunDirection = Engine::Vector3(1.0, 2.0, 0.5);
+		Engine::Vector3 sunRadiance = Engine::Vector3(2.0, 2.0, 2.0);
+
+		/// Translation applied to the whole scene so that it sits in front of the
+		/// camera, which is fixed at the origin looking down -Z. Zero for built-in scenes.
+		Engine::Vector3 offset;
+	};
+
+	/**
+	 * @brief Built-in scene: 'count' small diffuse spheres with random albedos on a large ground sphere.
+	 * @param seed Seed of the sphere layout and colours, so every run builds the same scene.
+	 */
+	SceneDescription BuildSpheresScene(int count, uint64_t seed);
+
+	/**
+	 * @brief Built-in scene: 'count' equal-radius spheres spread evenly through a box, like one frame of a particle fluid.
+	 *
+	 * There is no ground, so every primitive is about the same size and the
+	 * scene suits a GridAccelerator.
+	 *
+	 * @param seed Seed of the particle positions and colours.
+	 */
+	SceneDescription BuildParticlesScene(int count, uint64_t seed);
+
+	/**
+	 * @brief Loads the triangle meshes and materials of a glTF file and frames them for the camera.
+	 *
+	 * With a cache directory the meshes and their BVHs are mapped from a
+	 * SceneCache file named after the hash of the glTF file's contents,
+	 * which is written on the first load; failing to write it is only a
+	 * warning. A cached scene renders even without glTF support.
+	 *
+	 * @param cacheDirectory Directory of SceneCache files, or empty to always load the file.
+	 * @throws std::runtime_error if the file cannot be loaded or glTF support was not built.
+	 */
+	SceneDescription LoadGltfScene(const std::string& filePath, const std::string& cacheDirectory = std::string());
+}
\ No newline at end of file
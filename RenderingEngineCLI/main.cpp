@@ -0,0 +1,382 @@
+#include "pch.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <src/BVH.h>
+#include <src/Camera.h>
+#include <src/GridAccelerator.h>
+#include <src/Instance.h>
+#include <src/ThreadPool.h>
+#include <src/cpu/CpuRenderer.h>
+
+#include "ImageOutput.h"
+#include "Scenes.h"
+
+namespace RenderingEngineCLI
+{
+	using namespace Engine;
+
+	/** @brief Acceleration structure traced by the renderer. */
+	enum class AcceleratorType
+	{
+		Auto, ///< A grid if GridAccelerator::SuitedTo() the scene, a BVH otherwise.
+		Bvh,
+		Grid
+	};
+
+	/** @brief Command line of a batch render. */
+	struct Options
+	{
+		std::string scene = "builtin";	 ///< "builtin", "particles" or the path of a .glb file.
+		std::string cacheDirectory;		 ///< Where built glTF meshes are cached; empty disables the cache.
+		int spheres = 500;				 ///< Sphere count of the built-in scenes.
+		int width = SCREEN_WIDTH;
+		int height = SCREEN_HEIGHT;
+		int samplesPerPixel = 16;
+		unsigned threads = 0;			 ///< Zero uses every hardware thread.
+		int maxDepth = 8;
+		uint64_t seed = 0;
+		SamplerType sampler = SamplerType::Sobol;
+		BVHBuildMode bvhMode = BVHBuildMode::Quality;
+		BVHLayout bvhLayout = BVHLayout::Wide8;
+		AcceleratorType accelerator = AcceleratorType::Auto;
+		bool wavefront = false;
+		bool denoise = false;
+		std::string output = "render.ppm";
+		std::string report;				 ///< Also write the JSON report to this file.
+	};
+
+	void PrintUsage()
+	{
+		std::cerr <<
+			"Usage: RenderingEngineCLI [options]\n"
+			"  --scene <name|file.glb>     Scene to render: builtin, particles or a glTF file (default: builtin)\n"
+			"  --cache-dir <dir>           Cache built glTF meshes and BVHs here, keyed by file contents\n"
+			"  --spheres <n>               Spheres in the built-in scenes (default: 500)\n"
+			"  --width <px> --height <px>  Image size (default: " << SCREEN_WIDTH << "x" << SCREEN_HEIGHT << ")\n"
+			"  --spp <n>                   Samples per pixel (default: 16)\n"
+			"  --threads <n>               Worker threads, 0 for all cores (default: 0)\n"
+			"  --max-depth <n>             Longest path in segments (default: 8)\n"
+			"  --seed <n>                  Seed of the sample streams and built-in scene (default: 0)\n"
+			"  --sampler <name>            independent, sobol, halton or r2 (default: sobol)\n"
+			"  --bvh <mode>                BVH build: quality or fast (default: quality)\n"
+			"  --bvh-layout <layout>       BVH traversed by single rays: binary or wide (default: wide)\n"
+			"  --accel <type>              Acceleration structure: auto, bvh or grid (default: auto)\n"
+			"  --wavefront                 Trace in wavefront batches\n"
+			"  --denoise                   Run the a-trous denoiser on the result\n"
+			"  --output <file>             Image to write, .ppm (sRGB) or .pfm (linear) (default: render.ppm)\n"
+			"  --report <file>             Also write the JSON timing report to a file\n"
+			"The JSON timing report is printed to stdout.\n";
+	}
+
+	/** @brief Parses the command line; returns nothing if only help was requested. */
+	std::optional<Options> ParseOptions(int argc, char** argv)
+	{
+		Options options;
+
+		for (int i = 1; i < argc; i++)
+		{
+			const std::string argument = argv[i];
+
+			const auto value = [&]() -> std::string
+				{
+					if (i + 1 >= argc)
+					{
+						throw std::runtime_error("Missing value for " + argument + "!");
+					}
+
+					return argv[++i];
+				};
+
+			const auto integer = [&](int min) -> int
+				{
+					const std::string text = value();
+
+					size_t end = 0;
+					int result = 0;
+					try
+					{
+						result = std::stoi(text, &end);
+					}
+					catch (const std::exception&)
+					{
+						end = 0;
+					}
+
+					if (end != text.size() || result < min)
+					{
+						throw std::runtime_error("Invalid value '" + text + "' for " + argument + "!");
+					}
+
+					return result;
+				};
+
+			if (argument == "--help" || argument == "-h")
+			{
+				PrintUsage();
+				return std::nullopt;
+			}
+			else if (argument == "--scene") options.scene = value();
+			else if (argument == "--cache-dir") options.cacheDirectory = value();
+			else if (argument == "--spheres") options.spheres = integer(0);
+			else if (argument == "--width") options.width = integer(1);
+			else if (argument == "--height") options.height = integer(1);
+			else if (argument == "--spp") options.samplesPerPixel = integer(1);
+			else if (argument == "--threads") options.threads = unsigned(integer(0));
+			else if (argument == "--max-depth") options.maxDepth = integer(1);
+			else if (argument == "--seed") options.seed = uint64_t(integer(0));
+			else if (argument == "--sampler")
+			{
+				const std::string name = value();
+				if (name == "independent") options.sampler = SamplerType::Independent;
+				else if (name == "sobol") options.sampler = SamplerType::Sobol;
+				else if (name == "halton") options.sampler = SamplerType::Halton;
+				else if (name == "r2") options.sampler = SamplerType::R2;
+				else throw std::runtime_error("Unknown sampler '" + name + "'!");
+			}
+			else if (argument == "--bvh")
+			{
+				const std::string name = value();
+				if (name == "quality") options.bvhMode = BVHBuildMode::Quality;
+				else if (name == "fast") options.bvhMode = BVHBuildMode::Fast;
+				else throw std::runtime_error("Unknown BVH build mode '" + name + "'!");
+			}
+			else if (argument == "--bvh-layout")
+			{
+				const std::string name = value();
+				if (name == "binary") options.bvhLayout = BVHLayout::Binary;
+				else if (name == "wide") options.bvhLayout = BVHLayout::Wide8;
+				else throw std::runtime_error("Unknown BVH layout '" + name + "'!");
+			}
+			else if (argument == "--accel")
+			{
+				const std::string name = value();
+				if (name == "auto") options.accelerator = AcceleratorType::Auto;
+				else if (name == "bvh") options.accelerator = AcceleratorType::Bvh;
+				else if (name == "grid") options.accelerator = AcceleratorType::Grid;
+				else throw std::runtime_error("Unknown acceleration structure '" + name + "'!");
+			}
+			else if (argument == "--wavefront") options.wavefront = true;
+			else if (argument == "--denoise") options.denoise = true;
+			else if (argument == "--output") options.output = value();
+			else if (argument == "--report") options.report = value();
+			else
+			{
+				throw std::runtime_error("Unknown option " + argument + " (see --help)!");
+			}
+		}
+
+		return options;
+	}
+
+	/** @brief Quotes a string for JSON. */
+	std::string JsonString(const std::string& text)
+	{
+		std::string quoted = "\"";
+		for (const char c : text)
+		{
+			if (c == '"' || c == '\\')
+			{
+				quoted += '\\';
+				quoted += c;
+			}
+			else if (uint8_t(c) < 0x20)
+			{
+				char escape[8];
+				std::snprintf(escape, sizeof(escape), "\\u%04x", unsigned(c));
+				quoted += escape;
+			}
+			else
+			{
+				quoted += c;
+			}
+		}
+
+		return quoted + "\"";
+	}
+
+	double MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	int Run(int argc, char** argv)
+	{
+		const std::optional<Options> parsed = ParseOptions(argc, argv);
+		if (!parsed)
+		{
+			return EXIT_SUCCESS;
+		}
+
+		const Options& options = *parsed;
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		// Scene build: create or load the primitives and materials.
+		auto phase = std::chrono::high_resolution_clock::now();
+		SceneDescription scene = (options.scene == "builtin") ? BuildSpheresScene(options.spheres, options.seed) :
+			(options.scene == "particles") ? BuildParticlesScene(options.spheres, options.seed) : LoadGltfScene(options.scene, options.cacheDirectory);
+		const double sceneBuildMs = MillisecondsSince(phase);
+
+		if (scene.objects.objects.empty())
+		{
+			throw std::runtime_error("Scene is empty!");
+		}
+
+		// Acceleration structure build on its own pool, which sleeps once the build
+		// is done; a framed scene is placed in front of the camera as one instance.
+		phase = std::chrono::high_resolution_clock::now();
+		ThreadPool buildPool(options.threads);
+
+		const bool useGrid = options.accelerator == AcceleratorType::Grid ||
+			(options.accelerator == AcceleratorType::Auto && GridAccelerator::SuitedTo(scene.objects));
+
+		std::shared_ptr<BVH> bvh;
+		std::shared_ptr<GridAccelerator> grid;
+		std::shared_ptr<const Hittable> world;
+
+		if (useGrid)
+		{
+			GridBuildOptions gridOptions;
+			gridOptions.pool = &buildPool;
+
+			grid = std::make_shared<GridAccelerator>(scene.objects, gridOptions);
+			world = grid;
+		}
+		else
+		{
+			BVHBuildOptions bvhOptions;
+			bvhOptions.mode = options.bvhMode;
+			bvhOptions.layout = options.bvhLayout;
+			bvhOptions.pool = &buildPool;
+
+			bvh = std::make_shared<BVH>(scene.objects, bvhOptions);
+			world = bvh;
+		}
+
+		if (scene.offset.Length2() > 0)
+		{
+			const glm::dmat4 placement = glm::translate(glm::dmat4(1.0), glm::dvec3(scene.offset.x, scene.offset.y, scene.offset.z));
+			world = std::make_shared<Instance>(world, placement);
+		}
+		const double accelBuildMs = MillisecondsSince(phase);
+
+		// The camera derives its height from the aspect ratio; the half pixel
+		// keeps the truncation from losing a row to rounding.
+		const Camera camera(options.width, double(options.width) / (options.height + 0.5));
+
+		CpuRenderSettings settings;
+		settings.samplesPerPixel = options.samplesPerPixel;
+		settings.threadCount = options.threads;
+		settings.seed = options.seed;
+		settings.sampler = options.sampler;
+		settings.maxDepth = options.maxDepth;
+		settings.wavefront = options.wavefront;
+		settings.sunDirection = scene.sunDirection;
+		settings.sunRadiance = scene.sunRadiance;
+
+		CpuRenderer renderer(camera.ImageWidth(), camera.ImageHeight(), settings);
+
+		std::cerr << "Rendering " << scene.name << " at " << renderer.Width() << "x" << renderer.Height() << ", "
+			<< options.samplesPerPixel << " spp on " << renderer.ThreadCount() << " threads" << std::endl;
+
+		renderer.Render(camera, *world, &scene.materials);
+		const CpuRenderStats& stats = renderer.Stats();
+
+		double denoiseMs = 0.0;
+		std::vector<float> image;
+		if (options.denoise)
+		{
+			phase = std::chrono::high_resolution_clock::now();
+			image = renderer.Denoise();
+			denoiseMs = MillisecondsSince(phase);
+		}
+		else
+		{
+			image = renderer.Resolve();
+		}
+
+		phase = std::chrono::high_resolution_clock::now();
+		WriteImage(options.output, image, renderer.Width(), renderer.Height());
+		const double writeMs = MillisecondsSince(phase);
+
+		// Fields of the acceleration structure that was built.
+		std::ostringstream accelerator;
+		accelerator << std::fixed << std::setprecision(3);
+
+		if (grid)
+		{
+			const GridBuildStats& gridStats = grid->BuildStats();
+
+			accelerator
+				<< "  \"accelerator\": \"grid\",\n"
+				<< "  \"gridBuildMs\": " << accelBuildMs << ",\n"
+				<< "  \"gridResolution\": [" << gridStats.resolution[0] << ", " << gridStats.resolution[1] << ", " << gridStats.resolution[2] << "],\n"
+				<< "  \"gridReferencesPerPrimitive\": " << gridStats.ReferencesPerPrimitive() << ",\n";
+		}
+		else
+		{
+			const BVHBuildPhaseTimes& bvhPhases = bvh->BuildStats().phases;
+
+			accelerator
+				<< "  \"accelerator\": \"bvh\",\n"
+				<< "  \"bvhMode\": \"" << (options.bvhMode == BVHBuildMode::Fast ? "fast" : "quality") << "\",\n"
+				<< "  \"bvhLayout\": \"" << (options.bvhLayout == BVHLayout::Wide8 ? "wide" : "binary") << "\",\n"
+				<< "  \"bvhBuildMs\": " << accelBuildMs << ",\n"
+				<< "  \"bvhPhasesMs\": { \"centroids\": " << bvhPhases.centroidsMs << ", \"morton\": " << bvhPhases.mortonMs
+				<< ", \"sort\": " << bvhPhases.sortMs << ", \"topLevel\": " << bvhPhases.topLevelMs
+				<< ", \"subtrees\": " << bvhPhases.subtreesMs << ", \"flatten\": " << bvhPhases.flattenMs << " },\n"
+				<< "  \"bvhSahCost\": " << bvh->BuildStats().sahCost << ",\n";
+		}
+
+		std::ostringstream report;
+		report << std::fixed << std::setprecision(3)
+			<< "{\n"
+			<< "  \"scene\": " << JsonString(scene.name) << ",\n"
+			<< "  \"primitives\": " << scene.objects.objects.size() << ",\n"
+			<< "  \"width\": " << renderer.Width() << ",\n"
+			<< "  \"height\": " << renderer.Height() << ",\n"
+			<< "  \"spp\": " << options.samplesPerPixel << ",\n"
+			<< "  \"threads\": " << renderer.ThreadCount() << ",\n"
+			<< "  \"wavefront\": " << (options.wavefront ? "true" : "false") << ",\n"
+			<< "  \"sceneCache\": \"" << (scene.cache == SceneCacheResult::Hit ? "hit" : scene.cache == SceneCacheResult::Miss ? "miss" : "off") << "\",\n"
+			<< "  \"sceneBuildMs\": " << sceneBuildMs << ",\n"
+			<< accelerator.str()
+			<< "  \"renderMs\": " << stats.renderTimeMs << ",\n"
+			<< "  \"denoiseMs\": " << denoiseMs << ",\n"
+			<< "  \"writeMs\": " << writeMs << ",\n"
+			<< "  \"totalMs\": " << MillisecondsSince(start) << ",\n"
+			<< "  \"rays\": " << stats.rays << ",\n"
+			<< "  \"paths\": " << stats.paths << ",\n"
+			<< "  \"raysPerSecond\": " << stats.RaysPerSecond() << ",\n"
+			<< "  \"meanPathLength\": " << stats.MeanPathLength() << ",\n"
+			<< "  \"output\": " << JsonString(options.output) << "\n"
+			<< "}\n";
+
+		std::cout << report.str();
+
+		if (!options.report.empty())
+		{
+			std::ofstream file(options.report);
+			file << report.str();
+			if (!file)
+			{
+				throw std::runtime_error("Failed to write report '" + options.report + "'!");
+			}
+		}
+
+		return EXIT_SUCCESS;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		return RenderingEngineCLI::Run(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
\ No newline at end of file
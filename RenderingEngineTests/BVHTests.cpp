@@ -0,0 +1,259 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <src/BVH.h>
+#include <src/Instance.h>
+#include <src/Sphere.h>
+#include <src/ThreadPool.h>
+
+#include "TestUtilities.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(BVHTests)
+	{
+	public:
+
+		TEST_METHOD(BoundingBox_EnclosesAllObjects)
+		{
+			HittableList list = MakeSpheres(100, 1234);
+			BVH bvh(list);
+
+			const AABB box = bvh.BoundingBox();
+			for (const auto& object : list.objects)
+			{
+				const AABB objectBox = object->BoundingBox();
+
+				Assert::IsTrue(box.x.min <= objectBox.x.min && objectBox.x.max <= box.x.max);
+				Assert::IsTrue(box.y.min <= objectBox.y.min && objectBox.y.max <= box.y.max);
+				Assert::IsTrue(box.z.min <= objectBox.z.min && objectBox.z.max <= box.z.max);
+			}
+		}
+
+		TEST_METHOD(Hit_MatchesLinearScan)
+		{
+			HittableList list = MakeSpheres(2000, 1234);
+			BVH bvh(list);
+
+			std::mt19937 generator(99);
+			std::uniform_real_distribution<double> offset(-0.5, 0.5);
+
+			for (int i = 0; i < 1000; i++)
+			{
+				Ray ray(Vector3(0.0, 0.0, 0.0), Vector3::Normalize(Vector3(offset(generator), offset(generator), -1.0)));
+
+				HitRecord expected, actual;
+				const bool expectedHit = list.Hit(ray, Interval(0.001, 1e30), expected);
+				const bool actualHit = bvh.Hit(ray, Interval(0.001, 1e30), actual);
+
+				Assert::AreEqual(expectedHit, actualHit);
+				if (expectedHit)
+				{
+					Assert::AreEqual(expected.t, actual.t);
+				}
+			}
+		}
+
+		TEST_METHOD(BuildStats_AreConsistent)
+		{
+			BVH bvh(MakeSpheres(1000, 1234));
+
+			const BVHBuildStats& stats = bvh.BuildStats();
+
+			Assert::AreEqual(size_t(1000), stats.primitiveCount);
+			Assert::AreEqual(stats.nodeCount, 2 * stats.leafCount - 1);
+			Assert::IsTrue(stats.maxDepth < BVHTree::MaxDepth);
+		}
+
+		/** @brief Checks that every primitive is in exactly one leaf and every box encloses its contents. */
+		static void CheckTreeIsValid(const BVHTree& tree, const std::vector<AABB>& bounds)
+		{
+			std::vector<int> seen(bounds.size(), 0);
+
+			for (size_t i = 0; i < tree.nodes.size(); i++)
+			{
+				const BVHNode& node = tree.nodes[i];
+				std::vector<AABB> contents;
+
+				if (node.IsLeaf())
+				{
+					for (uint32_t k = node.leftFirst; k < node.leftFirst + node.count; k++)
+					{
+						seen[tree.primitiveIndices[k]]++;
+						contents.push_back(bounds[tree.primitiveIndices[k]]);
+					}
+				}
+				else
+				{
+					Assert::IsTrue(node.leftFirst > i && node.leftFirst + 1 < tree.nodes.size());
+					contents.push_back(tree.nodes[node.leftFirst].bounds);
+					contents.push_back(tree.nodes[node.leftFirst + 1].bounds);
+				}
+
+				for (const AABB& box : contents)
+				{
+					Assert::IsTrue(node.bounds.x.min <= box.x.min && box.x.max <= node.bounds.x.max);
+					Assert::IsTrue(node.bounds.y.min <= box.y.min && box.y.max <= node.bounds.y.max);
+					Assert::IsTrue(node.bounds.z.min <= box.z.min && box.z.max <= node.bounds.z.max);
+				}
+			}
+
+			for (const int count : seen)
+			{
+				Assert::AreEqual(1, count);
+			}
+		}
+
+		TEST_METHOD(ParallelBuild_MatchesSerialBuild)
+		{
+			// Enough primitives that the top levels are split before the subtree tasks.
+			std::vector<AABB> bounds;
+			for (const auto& object : MakeSpheres(30000, 1234).objects)
+			{
+				bounds.push_back(object->BoundingBox());
+			}
+
+			ThreadPool pool(4);
+			BVHBuildOptions options;
+
+			BVHTree serial;
+			serial.Build(bounds, options);
+
+			options.pool = &pool;
+			BVHTree parallel;
+			parallel.Build(bounds, options);
+
+			CheckTreeIsValid(parallel, bounds);
+			Assert::IsTrue(parallel.BuildStats().subtreeCount > 1);
+			Assert::IsTrue(parallel.primitiveIndices == serial.primitiveIndices);
+			Assert::AreEqual(serial.nodes.size(), parallel.nodes.size());
+
+			for (size_t i = 0; i < serial.nodes.size(); i++)
+			{
+				Assert::AreEqual(serial.nodes[i].leftFirst, parallel.nodes[i].leftFirst);
+				Assert::AreEqual(serial.nodes[i].count, parallel.nodes[i].count);
+				Assert::AreEqual(double(serial.nodes[i].bounds.x.min), double(parallel.nodes[i].bounds.x.min));
+				Assert::AreEqual(double(serial.nodes[i].bounds.z.max), double(parallel.nodes[i].bounds.z.max));
+			}
+		}
+
+		TEST_METHOD(FastBuild_IsValidAndCloseToQuality)
+		{
+			const HittableList list = MakeSpheres(30000, 1234);
+
+			std::vector<AABB> bounds;
+			for (const auto& object : list.objects)
+			{
+				bounds.push_back(object->BoundingBox());
+			}
+
+			ThreadPool pool(4);
+			BVHBuildOptions options;
+			options.pool = &pool;
+			options.mode = BVHBuildMode::Fast;
+
+			BVHTree fast;
+			fast.Build(bounds, options);
+			CheckTreeIsValid(fast, bounds);
+
+			const BVHBuildStats& stats = fast.BuildStats();
+			Assert::AreEqual(stats.nodeCount, 2 * stats.leafCount - 1);
+			Assert::IsTrue(stats.phases.sortMs > 0.0 && stats.phases.subtreesMs > 0.0);
+			Assert::IsTrue(stats.buildTimeMs >= stats.phases.sortMs + stats.phases.subtreesMs);
+
+			options.mode = BVHBuildMode::Quality;
+			BVHTree quality;
+			quality.Build(bounds, options);
+			Assert::IsTrue(stats.sahCost < 1.2 * quality.BuildStats().sahCost);
+
+			options.mode = BVHBuildMode::Fast;
+			CheckMatchesLinearScan(list, BVH(list, options));
+		}
+	
+		/** @brief Unit spheres instanced at random positions, offset by 'shift' times a per-instance direction. */
+		static void PlaceInstances(const std::vector<std::shared_ptr<Instance>>& instances, double shift)
+		{
+			std::mt19937 generator(99);
+			std::uniform_real_distribution<double> position(-20.0, 20.0);
+
+			for (const auto& instance : instances)
+			{
+				const glm::dvec3 start(position(generator), position(generator), position(generator) - 40.0);
+				const glm::dvec3 direction(position(generator), position(generator), position(generator));
+
+				instance->SetTransform(glm::translate(glm::dmat4(1.0), start + shift * direction));
+			}
+		}
+
+		TEST_METHOD(Update_RefitsMovedInstances)
+		{
+			auto sphere = std::make_shared<Sphere>(Vector3(0.0, 0.0, 0.0), 1.0);
+
+			HittableList list;
+			std::vector<std::shared_ptr<Instance>> instances;
+			for (int i = 0; i < 500; i++)
+			{
+				instances.push_back(std::make_shared<Instance>(sphere, glm::dmat4(1.0)));
+				list.Add(instances.back());
+			}
+
+			PlaceInstances(instances, 0.0);
+			BVH bvh(list);
+			const size_t nodeCount = bvh.Tree().nodes.size();
+
+			BVHBuildOptions wideOptions;
+			wideOptions.layout = BVHLayout::Wide8;
+			BVH wide(list, wideOptions);
+
+			// A small motion keeps the topology and only refits the boxes.
+			PlaceInstances(instances, 0.02);
+			Assert::IsFalse(bvh.Update(list));
+			Assert::AreEqual(nodeCount, bvh.Tree().nodes.size());
+			CheckMatchesLinearScan(list, bvh);
+
+			// The wide layout is collapsed again from the refitted tree.
+			Assert::IsFalse(wide.Update(list));
+			CheckMatchesLinearScan(list, wide);
+
+			// Every node must still enclose its children.
+			for (const BVHNode& node : bvh.Tree().nodes)
+			{
+				if (!node.IsLeaf())
+				{
+					const AABB merged(node.bounds, AABB(bvh.Tree().nodes[node.leftFirst].bounds, bvh.Tree().nodes[node.leftFirst + 1].bounds));
+					Assert::AreEqual(double(node.bounds.SurfaceArea()), double(merged.SurfaceArea()), 1e-9);
+				}
+			}
+		}
+
+		TEST_METHOD(Update_RebuildsDegradedTree)
+		{
+			auto sphere = std::make_shared<Sphere>(Vector3(0.0, 0.0, 0.0), 1.0);
+
+			HittableList list;
+			std::vector<std::shared_ptr<Instance>> instances;
+			for (int i = 0; i < 500; i++)
+			{
+				instances.push_back(std::make_shared<Instance>(sphere, glm::dmat4(1.0)));
+				list.Add(instances.back());
+			}
+
+			PlaceInstances(instances, 0.0);
+			BVH bvh(list);
+
+			// Moving every instance far along its own direction scrambles the
+			// clusters; refitting would leave heavily overlapping boxes.
+			PlaceInstances(instances, 1.0);
+			Assert::IsTrue(bvh.Update(list));
+			Assert::AreEqual(bvh.BuildStats().sahCost, bvh.Tree().SAHCost(), 1e-9);
+			CheckMatchesLinearScan(list, bvh);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/BulkRandom.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(BulkRandomTests)
+	{
+	public:
+
+		TEST_METHOD(SameSeed_ProducesSameSequence)
+		{
+			BulkRandom a(42, 7);
+			BulkRandom b(42, 7);
+			BulkRandom c(42, 8);
+
+			std::vector<double> x(1000), y(1000), z(1000);
+			a.Fill(x.data(), x.size());
+			b.Fill(y.data(), y.size());
+			c.Fill(z.data(), z.size());
+
+			int equal = 0;
+			for (size_t i = 0; i < x.size(); i++)
+			{
+				Assert::AreEqual(x[i], y[i]);
+				equal += x[i] == z[i];
+			}
+
+			Assert::IsTrue(equal < 5);
+		}
+
+		TEST_METHOD(PartialBlocks_MatchFullBlocks)
+		{
+			// A short fill runs only the scalar tail and a full block runs the
+			// SIMD body in AVX2 builds; both must produce the same values.
+			BulkRandom a(1, 2);
+			BulkRandom b(1, 2);
+
+			double full[4], part[3];
+			float fullFloats[8], partFloats[7];
+
+			a.Fill(full, 4);
+			b.Fill(part, 3);
+			a.Fill(fullFloats, 8);
+			b.Fill(partFloats, 7);
+
+			for (int i = 0; i < 3; i++)
+			{
+				Assert::AreEqual(full[i], part[i]);
+			}
+
+			for (int i = 0; i < 7; i++)
+			{
+				Assert::AreEqual(fullFloats[i], partFloats[i]);
+			}
+		}
+
+		TEST_METHOD(Fill_IsUniformInUnitRange)
+		{
+			constexpr size_t count = 1 << 16;
+
+			BulkRandom random(3);
+			std::vector<double> doubles(count);
+			std::vector<float> floats(count);
+			random.Fill(doubles.data(), count);
+			random.Fill(floats.data(), count);
+
+			int doubleBins[16] = {}, floatBins[16] = {};
+			for (size_t i = 0; i < count; i++)
+			{
+				Assert::IsTrue(doubles[i] >= 0.0 && doubles[i] < 1.0);
+				Assert::IsTrue(floats[i] >= 0.0f && floats[i] < 1.0f);
+				doubleBins[int(doubles[i] * 16)]++;
+				floatBins[int(floats[i] * 16)]++;
+			}
+
+			// Each bin expects 4096 with a standard deviation of about 62.
+			for (int bin = 0; bin < 16; bin++)
+			{
+				Assert::IsTrue(std::abs(doubleBins[bin] - 4096) < 300);
+				Assert::IsTrue(std::abs(floatBins[bin] - 4096) < 300);
+			}
+		}
+
+		TEST_METHOD(FillVectors_AreInRangeAndUnitLength)
+		{
+			constexpr size_t count = 1001;
+
+			BulkRandom random(4);
+			std::vector<Real> x(count), y(count), z(count);
+
+			random.FillVector3(x.data(), y.data(), z.data(), count, -2, 3);
+			for (size_t i = 0; i < count; i++)
+			{
+				Assert::IsTrue(x[i] >= -2 && x[i] <= 3 && y[i] >= -2 && y[i] <= 3 && z[i] >= -2 && z[i] <= 3);
+			}
+
+			double meanZ = 0.0;
+			random.FillUnitVector3(x.data(), y.data(), z.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				Assert::IsTrue(std::abs(std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) - 1) < 1e-5);
+				meanZ += z[i];
+			}
+
+			Assert::IsTrue(std::abs(meanZ / count) < 0.1);
+		}
+	};
+}
\ No newline at end of file
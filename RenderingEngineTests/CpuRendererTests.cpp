@@ -0,0 +1,342 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/BVH.h>
+#include <src/Lambertian.h>
+#include <src/Sphere.h>
+#include <src/cpu/CpuRenderer.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(CpuRendererTests)
+	{
+	public:
+
+		HittableList MakeScene()
+		{
+			HittableList world;
+			world.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -1.0), 0.5));
+			world.Add(std::make_shared<Sphere>(Vector3(0.0, -100.5, -1.0), 100.0));
+
+			return world;
+		}
+
+		std::vector<float> Render(const Hittable& world, unsigned threads, int tileSize)
+		{
+			Camera camera(64, 1.5);
+
+			CpuRenderSettings settings;
+			settings.samplesPerPixel = 4;
+			settings.threadCount = threads;
+			settings.tileSize = tileSize;
+
+			CpuRenderer renderer(camera.ImageWidth(), camera.ImageHeight(), settings);
+			renderer.Render(camera, world);
+
+			return renderer.Resolve();
+		}
+
+		TEST_METHOD(Render_IsIndependentOfThreadCountAndTileSize)
+		{
+			BVH world(MakeScene());
+
+			const std::vector<float> reference = Render(world, 1, 64);
+			const std::vector<float> parallel = Render(world, 4, 8);
+
+			Assert::IsTrue(reference == parallel);
+		}
+
+		TEST_METHOD(Render_ReportsRaysAndTiles)
+		{
+			BVH world(MakeScene());
+			Camera camera(64, 1.5);
+
+			CpuRenderSettings settings;
+			settings.samplesPerPixel = 2;
+			settings.tileSize = 16;
+
+			CpuRenderer renderer(camera.ImageWidth(), camera.ImageHeight(), settings);
+			renderer.Render(camera, world);
+
+			const CpuRenderStats& stats = renderer.Stats();
+
+			Assert::AreEqual(uint64_t(64) * camera.ImageHeight() * 2, stats.rays);
+			Assert::AreEqual(size_t(4 * 3), stats.tiles.size());
+		}
+
+		TEST_METHOD(Render_Adaptive_StopsConvergedPixelsEarly)
+		{
+			BVH world(MakeScene());
+			Camera camera(64, 1.5);
+
+			CpuRenderSettings settings;
+			settings.samplesPerPixel = 64;
+			settings.adaptiveThreshold = 0.02;
+			settings.adaptiveMinSamples = 8;
+
+			CpuRenderer renderer(camera.ImageWidth(), camera.ImageHeight(), settings);
+			renderer.Render(camera, world);
+
+			const CpuRenderStats& stats = renderer.Stats();
+			const uint64_t budget = uint64_t(64) * camera.ImageWidth() * camera.ImageHeight();
+
+			Assert::IsTrue(stats.rays <= budget);
+			Assert::IsTrue(stats.convergedPixels > 0);
+
+			// The smooth sky converges at the minimum; the sphere silhouette keeps sampling.
+			const uint32_t sky = renderer.PixelSampleCount(0, 0);
+			uint32_t maxSamples = 0;
+			for (int y = 0; y < camera.ImageHeight(); y++)
+			{
+				for (int x = 0; x < camera.ImageWidth(); x++)
+				{
+					maxSamples = std::max(maxSamples, renderer.PixelSampleCount(x, y));
+				}
+			}
+
+			Assert::AreEqual(uint32_t(8), sky);
+			Assert::IsTrue(maxSamples > sky);
+
+			const std::vector<float> heatmap = renderer.SampleCountHeatmap();
+			Assert::AreEqual(size_t(camera.ImageWidth()) * camera.ImageHeight(), heatmap.size());
+			Assert::AreEqual(1.0f, *std::max_element(heatmap.begin(), heatmap.end()));
+		}
+
+		TEST_METHOD(Render_Adaptive_MatchesUniformImage)
+		{
+			BVH world(MakeScene());
+			Camera camera(64, 1.5);
+
+			CpuRenderSettings settings;
+			settings.samplesPerPixel = 32;
+
+			CpuRenderer uniform(camera.ImageWidth(), camera.ImageHeight(), settings);
+			uniform.Render(camera, world);
+
+			settings.adaptiveThreshold = 0.02;
+			settings.adaptiveMinSamples = 8;
+
+			CpuRenderer adaptive(camera.ImageWidth(), camera.ImageHeight(), settings);
+			adaptive.Render(camera, world);
+
+			const std::vector<float> expected = uniform.Resolve();
+			const std::vector<float> actual = adaptive.Resolve();
+
+			double totalError = 0.0;
+			for (size_t i = 0; i < expected.size(); i++)
+			{
+				totalError += std::abs(expected[i] - actual[i]);
+			}
+
+			Assert::IsTrue(totalError / expected.size() < 0.01);
+		}
+	
+		/** @brief Renders three spheres (two Lambertian, one without a material) lit by a sun. */
+		std::unique_ptr<CpuRenderer> RenderMaterialScene(CpuRenderSettings settings, int samples = 3, int maxDepth = 5, int imageWidth = 48)
+		{
+			MaterialTable materials;
+			const uint32_t red = materials.Add(std::make_shared<Lambertian>(Vector3(0.8, 0.3, 0.3)));
+			const uint32_t grey = materials.Add(std::make_shared<Lambertian>(Vector3(0.5, 0.5, 0.5)));
+
+			HittableList list;
+			list.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -1.0), 0.5, red));
+			list.Add(std::make_shared<Sphere>(Vector3(1.0, 0.0, -1.0), 0.5, 7)); // No material: normal shading.
+			list.Add(std::make_shared<Sphere>(Vector3(0.0, -100.5, -1.0), 100.0, grey));
+			BVH world(list);
+
+			Camera camera(imageWidth, 1.5);
+
+			settings.samplesPerPixel = samples;
+			settings.threadCount = 4;
+			settings.maxDepth = maxDepth;
+			settings.sunDirection = Vector3(1.0, 2.0, 0.5);
+			settings.sunRadiance = Vector3(2.0, 2.0, 2.0);
+
+			auto renderer = std::make_unique<CpuRenderer>(camera.ImageWidth(), camera.ImageHeight(), settings);
+			renderer->Render(camera, world, &materials);
+
+			return renderer;
+		}
+
+		TEST_METHOD(Render_Wavefront_MatchesSinglePaths)
+		{
+			const auto single = RenderMaterialScene(CpuRenderSettings());
+
+			// Small batches so the image spans several of them.
+			CpuRenderSettings settings;
+			settings.wavefront = true;
+			settings.wavefrontSize = 500;
+
+			const auto wavefront = RenderMaterialScene(settings);
+
+			// Paths bounce and cast shadow rays, so more than one ray per sample is traced.
+			Assert::AreEqual(single->Stats().rays, wavefront->Stats().rays);
+			Assert::IsTrue(single->Stats().rays > uint64_t(single->Width()) * single->Height() * 3);
+
+			const std::vector<float> expected = single->Resolve();
+			const std::vector<float> actual = wavefront->Resolve();
+
+			for (size_t i = 0; i < expected.size(); i++)
+			{
+				Assert::AreEqual(expected[i], actual[i], 1e-5f);
+			}
+		}
+
+		TEST_METHOD(Render_Wavefront_ReorderingKeepsImageAndSortsKeys)
+		{
+			CpuRenderSettings settings;
+			settings.wavefront = true;
+
+			const auto unordered = RenderMaterialScene(settings);
+
+			settings.reorderRays = true;
+			const auto reordered = RenderMaterialScene(settings);
+
+			// Path state is per slot, so the trace order does not change any sample.
+			Assert::IsTrue(unordered->Resolve() == reordered->Resolve());
+
+			const CpuRenderStats& stats = reordered->Stats();
+			Assert::IsTrue(stats.reorderedRays > 0);
+			Assert::IsTrue(stats.keySimilarityAfter > stats.keySimilarityBefore + 5.0);
+			Assert::AreEqual(uint64_t(0), unordered->Stats().reorderedRays);
+		}
+	
+		static double MeanLuminance(const std::vector<float>& image)
+		{
+			double sum = 0.0;
+			for (size_t i = 0; i < image.size(); i += 3)
+			{
+				sum += 0.2126 * image[i] + 0.7152 * image[i + 1] + 0.0722 * image[i + 2];
+			}
+
+			return sum / (image.size() / 3);
+		}
+
+		TEST_METHOD(Render_RussianRoulette_ShortensPathsWithoutBias)
+		{
+			CpuRenderSettings settings;
+			settings.russianRouletteDepth = 0;
+
+			const auto full = RenderMaterialScene(settings, 64, 32);
+
+			settings.russianRouletteDepth = 1;
+			const auto roulette = RenderMaterialScene(settings, 64, 32);
+
+			Assert::IsTrue(roulette->Stats().MeanPathLength() < full->Stats().MeanPathLength());
+			Assert::IsTrue(roulette->Stats().rays < full->Stats().rays);
+
+			// Survivors are reweighted, so the expected image is unchanged.
+			const double expected = MeanLuminance(full->Resolve());
+			Assert::AreEqual(expected, MeanLuminance(roulette->Resolve()), 0.02 * expected);
+		}
+
+		TEST_METHOD(Benchmark_ReportsPathStatistics)
+		{
+			MaterialTable materials;
+			const uint32_t grey = materials.Add(std::make_shared<Lambertian>(Vector3(0.5, 0.5, 0.5)));
+
+			HittableList list;
+			list.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -1.0), 0.5, grey));
+			list.Add(std::make_shared<Sphere>(Vector3(0.0, -100.5, -1.0), 100.0, grey));
+			BVH world(list);
+
+			Camera camera(32, 1.5);
+
+			CpuRenderSettings settings;
+			settings.samplesPerPixel = 2;
+
+			CpuRenderer renderer(camera.ImageWidth(), camera.ImageHeight(), settings);
+			const CpuRenderStats stats = renderer.Benchmark(camera, world, &materials, 3);
+
+			Assert::AreEqual(uint64_t(32) * camera.ImageHeight() * 2 * 3, stats.paths);
+			Assert::IsTrue(stats.MeanPathLength() > 1.0);
+			Assert::AreEqual(stats.pathSegments, stats.rays);
+			Assert::IsTrue(stats.RaysPerSecond() > 0.0);
+			Assert::IsFalse(stats.Summary().empty());
+		}
+
+		TEST_METHOD(Render_AccumulatesFirstHitAovs)
+		{
+			const auto single = RenderMaterialScene(CpuRenderSettings());
+
+			CpuRenderSettings settings;
+			settings.wavefront = true;
+			const auto wavefront = RenderMaterialScene(settings);
+
+			Assert::IsTrue(single->ResolveAlbedo() == wavefront->ResolveAlbedo());
+			Assert::IsTrue(single->ResolveNormal() == wavefront->ResolveNormal());
+			Assert::IsTrue(single->ResolveDepth() == wavefront->ResolveDepth());
+
+			const std::vector<float> albedo = single->ResolveAlbedo();
+			const std::vector<float> normal = single->ResolveNormal();
+			const std::vector<float> depth = single->ResolveDepth();
+
+			// The image centre sees the front of the red sphere half a unit away.
+			const size_t centre = size_t(single->Height() / 2) * single->Width() + single->Width() / 2;
+			Assert::AreEqual(0.8f, albedo[centre * 3], 1e-5f);
+			Assert::AreEqual(0.3f, albedo[centre * 3 + 1], 1e-5f);
+			Assert::AreEqual(1.0f, normal[centre * 3 + 2], 0.01f);
+			Assert::AreEqual(0.5f, depth[centre], 0.01f);
+
+			// The top left corner sees only sky.
+			Assert::AreEqual(0.0f, depth[0]);
+			Assert::AreEqual(0.0f, normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			Assert::IsTrue(albedo[2] > 0.0f);
+		}
+
+		TEST_METHOD(Render_Sobol_LowersErrorAtEqualSamples)
+		{
+			// A sun with soft shadows, so the light samples matter too.
+			CpuRenderSettings settings;
+			settings.sunAngle = 0.1;
+
+			const std::vector<float> expected = RenderMaterialScene(settings, 1024, 5, 32)->Resolve();
+
+			const auto error = [&](SamplerType type)
+				{
+					settings.sampler = type;
+					const std::vector<float> image = RenderMaterialScene(settings, 16, 5, 32)->Resolve();
+
+					double sum = 0.0;
+					for (size_t i = 0; i < expected.size(); i++)
+					{
+						sum += double(image[i] - expected[i]) * (image[i] - expected[i]);
+					}
+
+					return sum;
+				};
+
+			const double independent = error(SamplerType::Independent);
+			const double sobol = error(SamplerType::Sobol);
+
+			Assert::IsTrue(sobol < 0.8 * independent);
+		}
+
+		TEST_METHOD(Denoise_EightSamplesApproachReference)
+		{
+			const auto reference = RenderMaterialScene(CpuRenderSettings(), 256, 5, 96);
+			const auto noisy = RenderMaterialScene(CpuRenderSettings(), 8, 5, 96);
+
+			const std::vector<float> expected = reference->Resolve();
+			const std::vector<float> raw = noisy->Resolve();
+			const std::vector<float> denoised = noisy->Denoise();
+
+			double rawError = 0.0, denoisedError = 0.0;
+			for (size_t i = 0; i < expected.size(); i++)
+			{
+				rawError += double(raw[i] - expected[i]) * (raw[i] - expected[i]);
+				denoisedError += double(denoised[i] - expected[i]) * (denoised[i] - expected[i]);
+			}
+
+			Assert::IsTrue(denoisedError < 0.4 * rawError);
+
+			// The post stage leaves the accumulation buffer alone.
+			Assert::IsTrue(noisy->Resolve() == raw);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/cpu/Denoiser.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(DenoiserTests)
+	{
+	public:
+
+		static constexpr int Width = 67;
+		static constexpr int Height = 41;
+		static constexpr int Edge = 30; ///< First column of the right-hand surface.
+
+		/** @brief Two surfaces side by side whose colours differ less than the noise on them. */
+		struct TwoSurfaces
+		{
+			std::vector<float> clean, noisy, albedo, normal, depth, variance;
+
+			TwoSurfaces()
+			{
+				std::mt19937 generator(5);
+				std::uniform_real_distribution<float> noise(-0.3f, 0.3f);
+
+				for (int y = 0; y < Height; y++)
+				{
+					for (int x = 0; x < Width; x++)
+					{
+						const bool right = x >= Edge;
+						const float value = right ? 0.6f : 0.4f;
+
+						for (int c = 0; c < 3; c++)
+						{
+							clean.push_back(value);
+							noisy.push_back(value + noise(generator));
+							albedo.push_back(right ? 0.8f : 0.3f);
+						}
+
+						normal.push_back(right ? 1.0f : 0.0f);
+						normal.push_back(0.0f);
+						normal.push_back(right ? 0.0f : 1.0f);
+						depth.push_back(right ? 4.0f : 2.0f);
+
+						// Variance of the uniform noise.
+						variance.push_back(0.6f * 0.6f / 12.0f);
+					}
+				}
+			}
+		};
+
+		static double MeanSquaredError(const std::vector<float>& a, const std::vector<float>& b)
+		{
+			double sum = 0.0;
+			for (size_t i = 0; i < a.size(); i++)
+			{
+				sum += double(a[i] - b[i]) * (a[i] - b[i]);
+			}
+
+			return sum / a.size();
+		}
+
+		TEST_METHOD(Denoise_RemovesNoiseAndKeepsGuideEdges)
+		{
+			const TwoSurfaces image;
+
+			ThreadPool pool(4);
+			Denoiser denoiser(pool);
+			const std::vector<float> denoised = denoiser.Denoise(image.noisy, image.albedo, image.normal, image.depth, image.variance, Width, Height);
+
+			Assert::IsTrue(MeanSquaredError(denoised, image.clean) < 0.05 * MeanSquaredError(image.noisy, image.clean));
+
+			// The guides keep the surfaces apart: pixels on either side of the edge
+			// are averaged only with their own surface.
+			for (int y = 0; y < Height; y++)
+			{
+				for (const int x : { Edge - 1, Edge })
+				{
+					const size_t i = (size_t(y) * Width + x) * 3;
+					Assert::AreEqual(image.clean[i], denoised[i], 0.05f);
+				}
+			}
+		}
+
+		TEST_METHOD(Denoise_ZeroIterationsReturnsInput)
+		{
+			const TwoSurfaces image;
+
+			DenoiserSettings settings;
+			settings.iterations = 0;
+
+			ThreadPool pool(2);
+			Denoiser denoiser(pool, settings);
+
+			Assert::IsTrue(denoiser.Denoise(image.noisy, image.albedo, image.normal, image.depth, image.variance, Width, Height) == image.noisy);
+
+			Assert::ExpectException<std::runtime_error>([&]()
+				{
+					denoiser.Denoise(image.noisy, image.albedo, image.normal, image.depth, image.variance, Width, Height + 1);
+				});
+		}
+	};
+}
\ No newline at end of file
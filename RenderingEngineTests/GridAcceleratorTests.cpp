@@ -0,0 +1,129 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/GridAccelerator.h>
+#include <src/Sphere.h>
+#include <src/ThreadPool.h>
+
+#include "TestUtilities.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(GridAcceleratorTests)
+	{
+	public:
+
+		TEST_METHOD(Hit_MatchesLinearScan)
+		{
+			const HittableList list = MakeSpheres(3000, 4321, 0.1, 0.3);
+			const GridAccelerator grid(list);
+
+			const GridBuildStats& stats = grid.BuildStats();
+			Assert::AreEqual(size_t(3000), stats.primitiveCount);
+			Assert::AreEqual(stats.cellCount, size_t(stats.resolution[0]) * stats.resolution[1] * stats.resolution[2]);
+			Assert::IsTrue(stats.ReferencesPerPrimitive() >= 1.0);
+
+			CheckMatchesLinearScan(list, grid);
+		}
+
+		TEST_METHOD(Build_BoundsReferencesAsPrimitivesGrow)
+		{
+			// From particles far apart to particles overlapping dozens of neighbours.
+			for (const double radius : { 0.1, 0.5, 1.0, 2.0 })
+			{
+				const HittableList list = MakeSpheres(3000, 8, radius, radius);
+				const GridAccelerator grid(list);
+
+				Assert::IsTrue(grid.BuildStats().ReferencesPerPrimitive() < 32.0);
+				CheckMatchesLinearScan(list, grid);
+			}
+
+			HittableList coincident;
+			for (int i = 0; i < 2000; i++)
+			{
+				coincident.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -30.0), 1.0));
+			}
+
+			const GridAccelerator grid(coincident);
+			Assert::IsTrue(grid.BuildStats().ReferencesPerPrimitive() <= 8.0);
+			CheckMatchesLinearScan(coincident, grid);
+		}
+
+		TEST_METHOD(Update_FollowsMovedPrimitives)
+		{
+			HittableList list = MakeSpheres(2000, 1, 0.1, 0.3);
+			GridAccelerator grid(list);
+
+			// Every sphere moves, and the scene grows along x.
+			const HittableList moved = MakeSpheres(2000, 2, 0.1, 0.3);
+			AABB bounds;
+
+			for (size_t i = 0; i < list.objects.size(); i++)
+			{
+				const auto& sphere = static_cast<const Sphere&>(*moved.objects[i]);
+				list.objects[i] = std::make_shared<Sphere>(sphere.center * Vector3(1.5, 1.0, 1.0), sphere.radius);
+				bounds.Grow(list.objects[i]->BoundingBox());
+			}
+
+			grid.Update(list);
+			Assert::AreEqual(double(bounds.x.max), double(grid.BoundingBox().x.max), 1e-3);
+			CheckMatchesLinearScan(list, grid);
+
+			list.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -5.0), 1.0));
+			Assert::ExpectException<std::invalid_argument>([&]() { grid.Update(list); });
+		}
+
+		TEST_METHOD(ParallelBuild_MatchesSerialBuild)
+		{
+			// Enough primitives and cells that every pass is split into several tasks.
+			const HittableList list = MakeSpheres(60000, 7, 0.05, 0.15);
+
+			ThreadPool pool(4);
+			GridBuildOptions options;
+			options.pool = &pool;
+
+			const GridAccelerator serial(list);
+			const GridAccelerator parallel(list, options);
+
+			Assert::AreEqual(serial.BuildStats().referenceCount, parallel.BuildStats().referenceCount);
+
+			std::mt19937 generator(5);
+			std::uniform_real_distribution<double> offset(-0.5, 0.5);
+			int hits = 0;
+
+			for (int i = 0; i < 2000; i++)
+			{
+				const Ray ray(Vector3(0.0, 0.0, 0.0), Vector3(offset(generator), offset(generator), -1.0));
+
+				HitRecord expected, actual;
+				const bool expectedHit = serial.Hit(ray, Interval(0.001, 1e30), expected);
+				Assert::AreEqual(expectedHit, parallel.Hit(ray, Interval(0.001, 1e30), actual));
+
+				if (expectedHit)
+				{
+					hits++;
+					Assert::AreEqual(double(expected.t), double(actual.t));
+				}
+			}
+
+			Assert::IsTrue(hits > 0);
+		}
+
+		TEST_METHOD(SuitedTo_PrefersSimilarlySizedPrimitives)
+		{
+			HittableList particles = MakeSpheres(1000, 3, 0.2, 0.25);
+			Assert::IsTrue(GridAccelerator::SuitedTo(particles));
+			Assert::IsFalse(GridAccelerator::SuitedTo(MakeSpheres(1000, 3, 0.05, 2.0)));
+			Assert::IsFalse(GridAccelerator::SuitedTo(HittableList()));
+
+			// A single huge ground sphere would span every cell.
+			particles.Add(std::make_shared<Sphere>(Vector3(0.0, -1000.0, 0.0), 1000.0));
+			Assert::IsFalse(GridAccelerator::SuitedTo(particles));
+		}
+	};
+}
\ No newline at end of file
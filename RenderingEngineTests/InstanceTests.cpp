@@ -0,0 +1,91 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <src/BVH.h>
+#include <src/Instance.h>
+#include <src/Sphere.h>
+#include <src/TriangleMesh.h>
+
+#include "TestUtilities.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(InstanceTests)
+	{
+	public:
+
+		TEST_METHOD(Hit_MatchesTransformedSphere)
+		{
+			// A unit sphere scaled by 2 and moved to (1, 0, -6) is a radius 2 sphere there.
+			auto unitSphere = std::make_shared<Sphere>(Vector3(0.0, 0.0, 0.0), 1.0, 3);
+			const glm::dmat4 objectToWorld = glm::scale(glm::translate(glm::dmat4(1.0), glm::dvec3(1.0, 0.0, -6.0)), glm::dvec3(2.0));
+
+			Instance instance(unitSphere, objectToWorld);
+			Sphere reference(Vector3(1.0, 0.0, -6.0), 2.0, 3);
+
+			const AABB box = instance.BoundingBox();
+			Assert::AreEqual(-1.0, double(box.x.min), RealTolerance(1.0));
+			Assert::AreEqual(-4.0, double(box.z.max), RealTolerance(4.0));
+
+			const Ray rays[] = {
+				Ray(Vector3(0.0, 0.0, 0.0), Vector3(0.1, 0.05, -1.0)),
+				Ray(Vector3(1.0, 0.0, -6.0), Vector3(0.0, 1.0, 0.3)),
+				Ray(Vector3(0.0, 0.0, 0.0), Vector3(1.0, 0.0, 0.0))
+			};
+
+			for (const Ray& ray : rays)
+			{
+				HitRecord expected, actual;
+				const bool expectedHit = reference.Hit(ray, Interval(0.001, 1e30), expected);
+
+				Assert::AreEqual(expectedHit, instance.Hit(ray, Interval(0.001, 1e30), actual));
+				if (expectedHit)
+				{
+					Assert::AreEqual(double(expected.t), double(actual.t), RealTolerance(expected.t));
+					Assert::AreEqual(double(expected.N.x), double(actual.N.x), RealTolerance(1.0));
+					Assert::AreEqual(double(expected.N.y), double(actual.N.y), RealTolerance(1.0));
+					Assert::AreEqual(double(expected.N.z), double(actual.N.z), RealTolerance(1.0));
+					Assert::AreEqual(expected.frontFace, actual.frontFace);
+					Assert::AreEqual(uint32_t(3), actual.materialId);
+				}
+			}
+		}
+
+		TEST_METHOD(TopLevelBVH_MatchesLinearScan)
+		{
+			// One shared tetrahedron placed many times with random rotations and scales.
+			const std::vector<Vector3> positions = { Vector3(0.0, 0.0, 0.0), Vector3(1.0, 0.0, 0.0), Vector3(0.0, 1.0, 0.0), Vector3(0.0, 0.0, 1.0) };
+			const std::vector<uint32_t> indices = { 0, 2, 1, 0, 1, 3, 0, 3, 2, 1, 2, 3 };
+			auto blas = std::make_shared<TriangleMesh>(positions, indices);
+
+			std::mt19937 generator(7);
+			std::uniform_real_distribution<double> position(-10.0, 10.0);
+			std::uniform_real_distribution<double> angle(0.0, 6.28318);
+			std::uniform_real_distribution<double> scale(0.2, 1.5);
+
+			HittableList instances;
+			for (int i = 0; i < 1000; i++)
+			{
+				glm::dmat4 m = glm::translate(glm::dmat4(1.0), glm::dvec3(position(generator), position(generator), position(generator) - 30.0));
+				m = glm::rotate(m, angle(generator), glm::normalize(glm::dvec3(position(generator), position(generator), 1.0)));
+				m = glm::scale(m, glm::dvec3(scale(generator)));
+
+				instances.Add(std::make_shared<Instance>(blas, m));
+			}
+
+			// Every instance references the same geometry.
+			Assert::AreEqual(long(1001), long(blas.use_count()));
+
+			BVH tlas(instances);
+
+			Assert::IsTrue(CheckMatchesLinearScan(instances, tlas) > 0);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <src/BVH.h>
+#include <src/Instance.h>
+#include <src/Sphere.h>
+#include <src/SphereBatch.h>
+#include <src/TriangleMesh.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(OcclusionTests)
+	{
+	public:
+
+		/** @brief Spheres, sphere batches, a triangle mesh and mesh instances scattered in front of the origin. */
+		HittableList MakeScene()
+		{
+			std::mt19937 generator(11);
+			std::uniform_real_distribution<double> position(-6.0, 6.0);
+			std::uniform_real_distribution<double> radius(0.1, 0.6);
+
+			HittableList spheres;
+			for (int i = 0; i < 300; i++)
+			{
+				spheres.Add(std::make_shared<Sphere>(Vector3(position(generator), position(generator), position(generator) - 12.0), radius(generator)));
+			}
+
+			HittableList world = SphereBatch::Pack(spheres);
+			for (int i = 0; i < 50; i++)
+			{
+				world.Add(std::make_shared<Sphere>(Vector3(position(generator), position(generator), position(generator) - 12.0), radius(generator)));
+			}
+
+			const std::vector<Vector3> positions = { Vector3(0.0, 0.0, 0.0), Vector3(1.0, 0.0, 0.0), Vector3(0.0, 1.0, 0.0), Vector3(0.0, 0.0, 1.0) };
+			const std::vector<uint32_t> indices = { 0, 2, 1, 0, 1, 3, 0, 3, 2, 1, 2, 3 };
+			auto mesh = std::make_shared<TriangleMesh>(positions, indices);
+
+			for (int i = 0; i < 50; i++)
+			{
+				const glm::dvec3 offset(position(generator), position(generator), position(generator) - 12.0);
+				world.Add(std::make_shared<Instance>(mesh, glm::translate(glm::dmat4(1.0), offset)));
+			}
+
+			world.Add(std::make_shared<TriangleMesh>(std::vector<Vector3>{ Vector3(-3.0, -3.0, -20.0), Vector3(3.0, -3.0, -20.0), Vector3(0.0, 3.0, -20.0) },
+				std::vector<uint32_t>{ 0, 1, 2 }));
+
+			return world;
+		}
+
+		TEST_METHOD(Occluded_MatchesHit)
+		{
+			HittableList list = MakeScene();
+			BVH bvh(list);
+
+			std::mt19937 generator(3);
+			std::uniform_real_distribution<double> offset(-0.6, 0.6);
+			std::uniform_real_distribution<double> length(2.0, 30.0);
+
+			int occluded = 0;
+			for (int i = 0; i < 2000; i++)
+			{
+				const Ray ray(Vector3(0.0, 0.0, 0.0), Vector3(offset(generator), offset(generator), -1.0));
+				const Interval ray_t(Real(0.001), Real(length(generator)));
+
+				// Every object on its own, then both aggregates.
+				for (const auto& object : list.objects)
+				{
+					HitRecord record;
+					Assert::AreEqual(object->Hit(ray, ray_t, record), object->Occluded(ray, ray_t));
+				}
+
+				HitRecord record;
+				const bool expected = list.Hit(ray, ray_t, record);
+
+				Assert::AreEqual(expected, list.Occluded(ray, ray_t));
+				Assert::AreEqual(expected, bvh.Occluded(ray, ray_t));
+
+				occluded += expected;
+			}
+
+			Assert::IsTrue(occluded > 100 && occluded < 1900);
+		}
+
+		TEST_METHOD(Occluded_VisitsFewerNodesThanHit)
+		{
+			BVH bvh(MakeScene());
+			bvh.SetCollectStats(true);
+
+			std::mt19937 generator(4);
+			std::uniform_real_distribution<double> offset(-0.6, 0.6);
+
+			std::vector<Ray> rays;
+			for (int i = 0; i < 2000; i++)
+			{
+				rays.push_back(Ray(Vector3(0.0, 0.0, 0.0), Vector3(offset(generator), offset(generator), -1.0)));
+			}
+
+			const Interval ray_t(Real(0.001), Real(1e30));
+
+			for (const Ray& ray : rays)
+			{
+				HitRecord record;
+				bvh.Hit(ray, ray_t, record);
+			}
+
+			const BVHTraversalStats closest = bvh.TraversalStats();
+			bvh.ResetTraversalStats();
+
+			for (const Ray& ray : rays)
+			{
+				bvh.Occluded(ray, ray_t);
+			}
+
+			const BVHTraversalStats any = bvh.TraversalStats();
+
+			Assert::AreEqual(closest.rays, any.rays);
+			Assert::IsTrue(any.nodesVisited < closest.nodesVisited);
+			Assert::IsTrue(any.primitiveTests < closest.primitiveTests);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/Camera.h>
+#include <src/Sphere.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(PrecisionTests)
+	{
+	public:
+
+		/** @brief Normal-shaded image of a fixed sphere scene traced entirely in scalar type 'T'. */
+		template<typename T>
+		std::vector<double> RenderNormals(int width, int samples)
+		{
+			const Vector3T<T> centers[] = { Vector3T<T>(0.0, 0.0, -1.0), Vector3T<T>(0.0, -100.5, -1.0), Vector3T<T>(-1.0, 0.0, -1.5), Vector3T<T>(1.0, 0.2, -2.0) };
+			const T radii[] = { T(0.5), T(100), T(0.4), T(0.7) };
+
+			CameraT<T> camera(width, 1.5);
+			std::vector<double> image;
+
+			for (int y = 0; y < camera.ImageHeight(); y++)
+			{
+				for (int x = 0; x < camera.ImageWidth(); x++)
+				{
+					Vector3d color;
+					for (int s = 0; s < samples; s++)
+					{
+						Random random = Random::ForSample(x, y, s);
+						const RayT<T> ray = camera.GetJitteredRay(x, y, random);
+
+						IntervalT<T> ray_t(T(0.001), std::numeric_limits<T>::infinity());
+						int closest = -1;
+
+						for (int i = 0; i < 4; i++)
+						{
+							T root;
+							if (IntersectSphere(centers[i], radii[i], ray, ray_t, root))
+							{
+								ray_t.max = root;
+								closest = i;
+							}
+						}
+
+						if (closest >= 0)
+						{
+							const Vector3T<T> N = (ray.At(ray_t.max) - centers[closest]) / radii[closest];
+							color += Vector3d(0.5 * (N.x + 1.0), 0.5 * (N.y + 1.0), 0.5 * (N.z + 1.0));
+						}
+						else
+						{
+							color += Vector3d(1.0, 1.0, 1.0);
+						}
+					}
+
+					image.push_back(color.x / samples);
+					image.push_back(color.y / samples);
+					image.push_back(color.z / samples);
+				}
+			}
+
+			return image;
+		}
+
+		TEST_METHOD(FloatImage_MatchesDoubleImage)
+		{
+			const std::vector<double> reference = RenderNormals<double>(96, 4);
+			const std::vector<double> preview = RenderNormals<float>(96, 4);
+
+			Assert::AreEqual(reference.size(), preview.size());
+
+			double totalError = 0.0;
+			for (size_t i = 0; i < reference.size(); i++)
+			{
+				totalError += std::abs(reference[i] - preview[i]);
+			}
+
+			// Float only moves silhouettes by a fraction of a sample, so the
+			// mean error stays far below one 8-bit quantization step.
+			Assert::IsTrue(totalError / reference.size() < 1e-4);
+		}
+
+		TEST_METHOD(FloatTypes_AreHalfTheSize)
+		{
+			Assert::AreEqual(sizeof(Vector3d) / 2, sizeof(Vector3f));
+			Assert::AreEqual(sizeof(Rayd) / 2, sizeof(Rayf));
+			Assert::AreEqual(sizeof(Intervald) / 2, sizeof(Intervalf));
+		}
+	};
+}
\ No newline at end of file
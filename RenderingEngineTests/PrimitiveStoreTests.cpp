@@ -0,0 +1,107 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/BVH.h>
+#include <src/MaterialTable.h>
+#include <src/PrimitiveStore.h>
+#include <src/Sphere.h>
+#include <src/SphereBatch.h>
+
+#include "TestUtilities.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(PrimitiveStoreTests)
+	{
+	public:
+
+		/** @brief Hittable of a type the store does not know, to exercise the virtual fallback. */
+		class WrappedSphere : public Hittable
+		{
+		public:
+
+			WrappedSphere(const Vector3& center, double radius, uint32_t materialId) : sphere(center, radius, materialId) {}
+
+			bool Hit(const Ray& ray, Interval ray_t, HitRecord& record) const override { return sphere.Hit(ray, ray_t, record); }
+			AABB BoundingBox() const override { return sphere.BoundingBox(); }
+
+		private:
+
+			Sphere sphere;
+		};
+
+		TEST_METHOD(Add_SortsByType)
+		{
+			PrimitiveStore store;
+
+			const uint32_t sphere = store.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -1.0), 0.5));
+			const uint32_t batch = store.Add(std::make_shared<SphereBatch>());
+			const uint32_t other = store.Add(std::make_shared<WrappedSphere>(Vector3(0.0, 0.0, -2.0), 0.5, 0));
+			const uint32_t secondSphere = store.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -3.0), 0.5));
+
+			Assert::IsTrue(PrimitiveStore::Type(sphere) == PrimitiveType::Sphere);
+			Assert::IsTrue(PrimitiveStore::Type(batch) == PrimitiveType::SphereBatch);
+			Assert::IsTrue(PrimitiveStore::Type(other) == PrimitiveType::Other);
+			Assert::AreEqual(uint32_t(1), PrimitiveStore::Index(secondSphere));
+			Assert::AreEqual(size_t(4), store.Size());
+		}
+
+		TEST_METHOD(Hit_ReportsMaterialId)
+		{
+			MaterialTable materials;
+			const uint32_t red = materials.Add(std::make_shared<Material>());
+			const uint32_t green = materials.Add(std::make_shared<Material>());
+
+			HittableList list;
+			list.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -1.0), 0.5, red));
+			list.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, 1.0), 0.5, green));
+
+			BVH bvh(list);
+
+			HitRecord record;
+			Assert::IsTrue(bvh.Hit(Ray(Vector3(), Vector3(0.0, 0.0, -1.0)), Interval(0.001, 1e30), record));
+			Assert::AreEqual(red, record.materialId);
+
+			Assert::IsTrue(bvh.Hit(Ray(Vector3(), Vector3(0.0, 0.0, 1.0)), Interval(0.001, 1e30), record));
+			Assert::AreEqual(green, record.materialId);
+			Assert::IsNotNull(materials.Get(record.materialId));
+			Assert::IsNull(materials.Get(2));
+		}
+
+		TEST_METHOD(BVH_MixedTypes_MatchesLinearScan)
+		{
+			HittableList spheres;
+			HittableList others;
+			uint32_t materialId = 0;
+			for (const auto& object : MakeSpheres(1000, 1234).objects)
+			{
+				const auto& sphere = static_cast<const Sphere&>(*object);
+				if (materialId % 3 == 0)
+				{
+					others.Add(std::make_shared<WrappedSphere>(sphere.center, sphere.radius, materialId));
+				}
+				else
+				{
+					spheres.Add(std::make_shared<Sphere>(sphere.center, sphere.radius, materialId));
+				}
+
+				materialId++;
+			}
+
+			HittableList list = SphereBatch::Pack(spheres);
+			for (const auto& object : others.objects)
+			{
+				list.Add(object);
+			}
+
+			BVH bvh(list);
+
+			CheckMatchesLinearScan(list, bvh);
+		}
+	};
+}
\ No newline at end of file
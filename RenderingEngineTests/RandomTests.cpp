@@ -0,0 +1,79 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/Random.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(RandomTests)
+	{
+	public:
+
+		TEST_METHOD(SameSeed_ProducesSameSequence)
+		{
+			Random a(42, 7);
+			Random b(42, 7);
+
+			for (int i = 0; i < 1000; i++)
+			{
+				Assert::AreEqual(a.NextUInt(), b.NextUInt());
+			}
+		}
+
+		TEST_METHOD(DifferentStreams_ProduceDifferentSequences)
+		{
+			Random a(42, 1);
+			Random b(42, 2);
+
+			int equal = 0;
+			for (int i = 0; i < 1000; i++)
+			{
+				equal += (a.NextUInt() == b.NextUInt());
+			}
+
+			Assert::IsTrue(equal < 5);
+		}
+
+		TEST_METHOD(RandomDouble_IsInUnitRange)
+		{
+			Random random;
+
+			double sum = 0.0;
+			for (int i = 0; i < 100000; i++)
+			{
+				const double x = random.RandomDouble();
+				Assert::IsTrue(x >= 0.0 && x < 1.0);
+				sum += x;
+			}
+
+			Assert::IsTrue(std::abs(sum / 100000 - 0.5) < 0.01);
+		}
+
+		TEST_METHOD(ForSample_IsDeterministicPerPixel)
+		{
+			Random a = Random::ForSample(10, 20, 3, 99);
+			Random b = Random::ForSample(10, 20, 3, 99);
+			Random c = Random::ForSample(11, 20, 3, 99);
+
+			const uint32_t first = a.NextUInt();
+
+			Assert::AreEqual(first, b.NextUInt());
+			Assert::AreNotEqual(first, c.NextUInt());
+		}
+
+		TEST_METHOD(RandomUnitVector3_HasUnitLength)
+		{
+			Random random(5, 5);
+
+			for (int i = 0; i < 1000; i++)
+			{
+				Assert::IsTrue(std::abs(random.RandomUnitVector3().Length() - 1) < 8 * std::numeric_limits<Real>::epsilon());
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/BVH.h>
+#include <src/RayPacket.h>
+#include <src/Sphere.h>
+#include <src/SphereBatch.h>
+#include <src/cpu/CpuRenderer.h>
+
+#include "TestUtilities.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(RayPacketTests)
+	{
+	public:
+
+		void AssertMatchesSingleRays(const Hittable& world, const RayPacket& packet)
+		{
+			const Interval ray_t(0.001, 1e30);
+
+			PacketHit result;
+			world.TracePacket(packet, ray_t, result);
+
+			for (int i = 0; i < packet.size; i++)
+			{
+				HitRecord expected;
+				const bool expectedHit = world.Hit(packet.Get(i), ray_t, expected);
+
+				Assert::AreEqual(expectedHit, result.hit[i]);
+				if (expectedHit)
+				{
+					Assert::AreEqual(double(expected.t), double(result.records[i].t), RealTolerance(expected.t));
+					Assert::AreEqual(double(expected.N.x), double(result.records[i].N.x), RealTolerance(1.0));
+				}
+			}
+		}
+
+		TEST_METHOD(TracePacket_MatchesSingleRays_Coherent)
+		{
+			HittableList list = MakeSpheres(2000, 1234);
+			BVH bvh(list);
+			BVH packed(SphereBatch::Pack(list));
+
+			RayPacket packet;
+			for (int y = 0; y < 8; y++)
+			{
+				for (int x = 0; x < 8; x++)
+				{
+					packet.Add(Ray(Vector3(0.0, 0.0, 0.0), Vector3::Normalize(Vector3(0.1 + x * 0.02, 0.1 + y * 0.02, -1.0))));
+				}
+			}
+
+			Assert::IsTrue(packet.SharesOctant());
+
+			AssertMatchesSingleRays(list, packet);
+			AssertMatchesSingleRays(bvh, packet);
+			AssertMatchesSingleRays(packed, packet);
+		}
+
+		TEST_METHOD(TracePacket_MatchesSingleRays_Incoherent)
+		{
+			HittableList list = MakeSpheres(2000, 1234);
+			BVH bvh(list);
+
+			std::mt19937 generator(99);
+			std::uniform_real_distribution<double> offset(-0.5, 0.5);
+
+			RayPacket packet;
+			for (int i = 0; i < RayPacket::MaxSize; i++)
+			{
+				packet.Add(Ray(Vector3(0.0, 0.0, 0.0), Vector3::Normalize(Vector3(offset(generator), offset(generator), -1.0))));
+			}
+
+			Assert::IsFalse(packet.SharesOctant());
+
+			AssertMatchesSingleRays(bvh, packet);
+		}
+
+		TEST_METHOD(Render_PacketsMatchSingleRays)
+		{
+			BVH world(MakeSpheres(500, 1234));
+			Camera camera(64, 1.5);
+
+			CpuRenderSettings settings;
+			settings.samplesPerPixel = 2;
+			settings.tileSize = 16;
+
+			CpuRenderer single(camera.ImageWidth(), camera.ImageHeight(), settings);
+			single.Render(camera, world);
+
+			settings.packetSize = 4;
+			CpuRenderer packets(camera.ImageWidth(), camera.ImageHeight(), settings);
+			packets.Render(camera, world);
+
+			const std::vector<float>& expected = single.AccumulationBuffer();
+			const std::vector<float>& actual = packets.AccumulationBuffer();
+
+			Assert::AreEqual(single.Stats().rays, packets.Stats().rays);
+			for (size_t i = 0; i < expected.size(); i++)
+			{
+				Assert::AreEqual(expected[i], actual[i], 1e-4f);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -43,27 +43,27 @@ namespace RenderingEngineTests
 
 		void AssertVectorNear(const Vector3& a, const Vector3& b)
 		{
-			Assert::IsTrue(std::abs(a.x - b.x) < std::numeric_limits<double>::epsilon());
-			Assert::IsTrue(std::abs(a.y - b.y) < std::numeric_limits<double>::epsilon());
-			Assert::IsTrue(std::abs(a.z - b.z) < std::numeric_limits<double>::epsilon());
+			Assert::IsTrue(std::abs(a.x - b.x) < std::numeric_limits<Real>::epsilon());
+			Assert::IsTrue(std::abs(a.y - b.y) < std::numeric_limits<Real>::epsilon());
+			Assert::IsTrue(std::abs(a.z - b.z) < std::numeric_limits<Real>::epsilon());
 		}
 
 		TEST_METHOD(DefaultConstructor_ShouldInitToZero)
 		{
 			Vector3 v;
 
-			Assert::AreEqual(0.0, v.x);
-			Assert::AreEqual(0.0, v.y);
-			Assert::AreEqual(0.0, v.z);
+			Assert::AreEqual(Real(0.0), v.x);
+			Assert::AreEqual(Real(0.0), v.y);
+			Assert::AreEqual(Real(0.0), v.z);
 		}
 
 		TEST_METHOD(ParameterConstructor_ShouldInitCorrectly)
 		{
 			Vector3 v(1.0, 2.0, 3.0);
 
-			Assert::AreEqual(1.0, v.x);
-			Assert::AreEqual(2.0, v.y);
-			Assert::AreEqual(3.0, v.z);
+			Assert::AreEqual(Real(1.0), v.x);
+			Assert::AreEqual(Real(2.0), v.y);
+			Assert::AreEqual(Real(3.0), v.z);
 		}
 
 		TEST_METHOD(CopyConstructor_CopiesValues)
@@ -94,18 +94,18 @@ namespace RenderingEngineTests
 		{
 			Vector3 v(1.1, 2.2, 3.3);
 
-			Assert::AreEqual(1.1, v[0]);
-			Assert::AreEqual(2.2, v[1]);
-			Assert::AreEqual(3.3, v[2]);
+			Assert::AreEqual(Real(1.1), v[0]);
+			Assert::AreEqual(Real(2.2), v[1]);
+			Assert::AreEqual(Real(3.3), v[2]);
 		}
 
 		TEST_METHOD(SubscriptOperator_WriteAccess)
 		{
 			Vector3 v;
 
-			v[0] = 4.4;
+			v[0] = Real(4.4);
 
-			Assert::AreEqual(4.4, v[0]);
+			Assert::AreEqual(Real(4.4), v[0]);
 		}
 
 		TEST_METHOD(OperatorPlusEquals_AddsValues)
@@ -122,14 +122,14 @@ namespace RenderingEngineTests
 		{
 			Vector3 v(3.0, 4.0, 0.0);
 			
-			Assert::AreEqual(25.0, v.Length2());
+			Assert::AreEqual(Real(25.0), v.Length2());
 		}
 
 		TEST_METHOD(Length_Correct)
 		{
 			Vector3 v(3.0, 4.0, 0.0);
 		
-			Assert::AreEqual(5.0, v.Length());
+			Assert::AreEqual(Real(5.0), v.Length());
 		}
 
 		TEST_METHOD(Normalize_MakesLengthOnes)
@@ -137,9 +137,9 @@ namespace RenderingEngineTests
 			Vector3 v(3.0, 0.0, 4.0);
 
 			v.Normalize();
-			double length = v.Length();
+			const Real length = v.Length();
 
-			Assert::IsTrue(std::abs(length - 1.0) < std::numeric_limits<double>::epsilon());
+			Assert::IsTrue(std::abs(length - 1.0) < std::numeric_limits<Real>::epsilon());
 		}
 	};
 }
\ No newline at end of file
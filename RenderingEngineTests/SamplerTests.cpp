@@ -0,0 +1,129 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/Sampler.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(SamplerTests)
+	{
+	public:
+
+		TEST_METHOD(Sobol_PowerOfTwoPrefixIsA02Net)
+		{
+			// Every elementary interval of area 1/16 holds exactly one of the
+			// first 16 points, whatever the pixel, dimension or scramble.
+			for (uint32_t pixel = 0; pixel < 8; pixel++)
+			{
+				for (uint32_t dimension = 0; dimension < 8; dimension++)
+				{
+					Vector2 points[16];
+					for (uint32_t i = 0; i < 16; i++)
+					{
+						Sampler sampler(SamplerType::Sobol, pixel, 3, i, 11);
+						sampler.SetDimension(dimension);
+						points[i] = sampler.Get2D();
+					}
+
+					for (int columns = 1; columns <= 16; columns *= 2)
+					{
+						const int rows = 16 / columns;
+
+						int cells[16] = {};
+						for (const Vector2& p : points)
+						{
+							cells[int(p.x * columns) * rows + int(p.y * rows)]++;
+						}
+
+						for (const int count : cells)
+						{
+							Assert::AreEqual(1, count);
+						}
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(Samples_AreInUnitRangeAndDeterministic)
+		{
+			for (const SamplerType type : { SamplerType::Independent, SamplerType::Sobol, SamplerType::Halton, SamplerType::R2 })
+			{
+				for (uint32_t i = 0; i < 256; i++)
+				{
+					Sampler a(type, 5, 9, i, 3);
+					Sampler b(type, 5, 9, i, 3);
+
+					for (int dimension = 0; dimension < 40; dimension++)
+					{
+						const Vector2 p = a.Get2D();
+						const Vector2 q = b.Get2D();
+						const double r = a.Get1D();
+
+						Assert::IsTrue(p.x >= 0.0 && p.x < 1.0 && p.y >= 0.0 && p.y < 1.0 && r >= 0.0 && r < 1.0);
+						Assert::AreEqual(p.x, q.x);
+						Assert::AreEqual(p.y, q.y);
+						Assert::AreEqual(r, b.Get1D());
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(LowDiscrepancy_IntegratesWithLowerError)
+		{
+			// Mean squared error of 64-sample estimates of a smooth integral over many pixels.
+			const auto error = [](SamplerType type, uint32_t dimension)
+				{
+					const double exact = (2.0 / PI) / 3.0;
+
+					double sum = 0.0;
+					for (uint32_t pixel = 0; pixel < 64; pixel++)
+					{
+						double estimate = 0.0;
+						for (uint32_t i = 0; i < 64; i++)
+						{
+							Sampler sampler(type, pixel, 0, i);
+							sampler.SetDimension(dimension);
+							const Vector2 u = sampler.Get2D();
+							estimate += std::sin(PI * u.x) * u.y * u.y;
+						}
+
+						estimate /= 64;
+						sum += (estimate - exact) * (estimate - exact);
+					}
+
+					return sum / 64;
+				};
+
+			for (const uint32_t dimension : { 0u, 5u, 17u })
+			{
+				const double independent = error(SamplerType::Independent, dimension);
+
+				Assert::IsTrue(error(SamplerType::Sobol, dimension) < 0.05 * independent);
+				Assert::IsTrue(error(SamplerType::R2, dimension) < 0.25 * independent);
+
+				// The large bases of higher Halton dimensions stratify 64 samples only coarsely.
+				Assert::IsTrue(error(SamplerType::Halton, dimension) < (dimension == 0 ? 0.25 : 1.0) * independent);
+			}
+		}
+
+		TEST_METHOD(Dimensions_AreDecorrelated)
+		{
+			// Two dimensions of the same sample must not move together.
+			double xy = 0.0;
+			for (uint32_t i = 0; i < 1024; i++)
+			{
+				Sampler sampler(SamplerType::Sobol, 1, 2, i);
+				const double a = sampler.Get1D() - 0.5;
+				const double b = sampler.Get1D() - 0.5;
+				xy += a * b;
+			}
+
+			Assert::IsTrue(std::abs(xy / 1024) < 0.01);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/Random.h>
+#include <src/Sampling.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(SamplingTests)
+	{
+	public:
+
+		TEST_METHOD(SinCosQuarterPi_MatchesStandardLibrary)
+		{
+			for (int i = -1000; i <= 1000; i++)
+			{
+				const double x = (PI / 4) * i / 1000.0;
+
+				double sine, cosine;
+				SinCosQuarterPi(x, sine, cosine);
+
+				Assert::IsTrue(std::abs(sine - std::sin(x)) < 1e-15);
+				Assert::IsTrue(std::abs(cosine - std::cos(x)) < 1e-15);
+			}
+		}
+
+		TEST_METHOD(ConcentricDisk_IsInsideAndPreservesArea)
+		{
+			// Stratified samples: a quarter of them must land inside radius 1/2.
+			constexpr int N = 256;
+
+			int inner = 0;
+			for (int i = 0; i < N; i++)
+			{
+				for (int j = 0; j < N; j++)
+				{
+					const Vector2 d = SampleConcentricDisk(Vector2((i + 0.5) / N, (j + 0.5) / N));
+					const double r2 = d.x * d.x + d.y * d.y;
+
+					Assert::IsTrue(r2 <= 1.0 + 1e-12);
+					inner += r2 < 0.25;
+				}
+			}
+
+			Assert::IsTrue(std::abs(double(inner) / (N * N) - 0.25) < 0.005);
+
+			// The centre of the square is the centre of the disk.
+			const Vector2 centre = SampleConcentricDisk(Vector2(0.5, 0.5));
+			Assert::AreEqual(0.0, centre.x);
+			Assert::AreEqual(0.0, centre.y);
+		}
+
+		TEST_METHOD(CosineHemisphere_HasCosineDistribution)
+		{
+			// For a cosine-weighted direction E[cos] = 2/3 and E[cos^2] = 1/2.
+			constexpr int N = 256;
+
+			double sum = 0.0, sum2 = 0.0;
+			for (int i = 0; i < N; i++)
+			{
+				for (int j = 0; j < N; j++)
+				{
+					const Vector3 v = SampleCosineHemisphere(Vector2((i + 0.5) / N, (j + 0.5) / N));
+
+					Assert::IsTrue(std::abs(v.Length() - 1) < 1e-6);
+					Assert::IsTrue(v.z >= 0);
+					sum += v.z;
+					sum2 += v.z * v.z;
+				}
+			}
+
+			Assert::IsTrue(std::abs(sum / (N * N) - 2.0 / 3.0) < 1e-3);
+			Assert::IsTrue(std::abs(sum2 / (N * N) - 0.5) < 1e-3);
+		}
+
+		TEST_METHOD(UniformSphereAndCone_AreUniform)
+		{
+			constexpr int N = 256;
+			const double cosThetaMax = std::cos(0.3);
+
+			double sphere = 0.0, sphere2 = 0.0, cone = 0.0;
+			for (int i = 0; i < N; i++)
+			{
+				for (int j = 0; j < N; j++)
+				{
+					const Vector2 u((i + 0.5) / N, (j + 0.5) / N);
+					const Vector3 v = SampleUniformSphere(u);
+					const Vector3 w = SampleUniformCone(u, cosThetaMax);
+
+					Assert::IsTrue(std::abs(v.Length() - 1) < 1e-6);
+					Assert::IsTrue(std::abs(w.Length() - 1) < 1e-6);
+					Assert::IsTrue(w.z >= cosThetaMax - 1e-6);
+					sphere += v.z;
+					sphere2 += v.z * v.z;
+					cone += w.z;
+				}
+			}
+
+			// Uniform z in [-1, 1] and in [cosThetaMax, 1].
+			Assert::IsTrue(std::abs(sphere / (N * N)) < 1e-3);
+			Assert::IsTrue(std::abs(sphere2 / (N * N) - 1.0 / 3.0) < 1e-3);
+			Assert::IsTrue(std::abs(cone / (N * N) - 0.5 * (1 + cosThetaMax)) < 1e-4);
+		}
+
+		TEST_METHOD(Batched_MatchesScalar)
+		{
+			// An odd count exercises both the SIMD body and the scalar tail.
+			constexpr size_t count = 37;
+
+			Random random(3, 3);
+			std::vector<Real> u0(count), u1(count), x(count), y(count), z(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				u0[i] = Real(random.RandomDouble());
+				u1[i] = Real(random.RandomDouble());
+			}
+			u0[5] = u1[5] = Real(0.5);
+
+			const Real tolerance = sizeof(Real) == sizeof(float) ? Real(1e-5) : Real(1e-12);
+
+			SampleCosineHemisphere(u0.data(), u1.data(), x.data(), y.data(), z.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				const Vector3 v = SampleCosineHemisphere(Vector2(u0[i], u1[i]));
+				Assert::IsTrue(std::abs(x[i] - v.x) < tolerance && std::abs(y[i] - v.y) < tolerance && std::abs(z[i] - v.z) < tolerance);
+			}
+
+			SampleUniformSphere(u0.data(), u1.data(), x.data(), y.data(), z.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				const Vector3 v = SampleUniformSphere(Vector2(u0[i], u1[i]));
+				Assert::IsTrue(std::abs(x[i] - v.x) < tolerance && std::abs(y[i] - v.y) < tolerance && std::abs(z[i] - v.z) < tolerance);
+			}
+		}
+
+		TEST_METHOD(OrthonormalBasis_IsOrthonormalForEveryNormal)
+		{
+			Random random(8, 8);
+
+			for (int i = 0; i < 1000; i++)
+			{
+				const Vector3 n = (i == 0) ? Vector3(0.0, 0.0, -1.0) : random.RandomUnitVector3();
+
+				Vector3 t, b;
+				OrthonormalBasis(n, t, b);
+
+				Assert::IsTrue(std::abs(t.Length() - 1) < 1e-5 && std::abs(b.Length() - 1) < 1e-5);
+				Assert::IsTrue(std::abs(Vector3::Dot(t, n)) < 1e-5 && std::abs(Vector3::Dot(b, n)) < 1e-5 && std::abs(Vector3::Dot(t, b)) < 1e-5);
+			}
+		}
+
+		TEST_METHOD(RandomCosineDirection_StaysAboveTheNormal)
+		{
+			Random random(9, 9);
+			const Vector3 n = Vector3::Normalize(Vector3(1.0, -2.0, 0.5));
+
+			double sum = 0.0;
+			for (int i = 0; i < 10000; i++)
+			{
+				const Vector3 v = random.RandomCosineDirection(n);
+				Assert::IsTrue(Vector3::Dot(v, n) >= -1e-6);
+				Assert::IsTrue(Vector3::Dot(random.RandomOnUnitHemisphere(n), n) >= 0);
+				sum += Vector3::Dot(v, n);
+			}
+
+			Assert::IsTrue(std::abs(sum / 10000 - 2.0 / 3.0) < 0.01);
+		}
+	};
+}
\ No newline at end of file
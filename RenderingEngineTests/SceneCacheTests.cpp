@@ -0,0 +1,206 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/Lambertian.h>
+#include <src/SceneCache.h>
+#include <src/Sphere.h>
+#include <src/TriangleMesh.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(SceneCacheTests)
+	{
+	public:
+
+		/** @brief Cache file or directory in the temporary directory, removed when the test ends. */
+		struct TemporaryFile
+		{
+			std::filesystem::path path;
+
+			explicit TemporaryFile(const std::string& name) : path(std::filesystem::temp_directory_path() / name) {}
+			~TemporaryFile() { std::filesystem::remove_all(path); }
+		};
+
+		/** @brief 'count' random triangles within a box in front of the origin. */
+		static std::shared_ptr<TriangleMesh> MakeMesh(int count, uint32_t materialId, uint32_t seed)
+		{
+			std::mt19937 generator(seed);
+			std::uniform_real_distribution<double> position(-5.0, 5.0);
+
+			std::vector<Vector3> positions;
+			std::vector<uint32_t> indices;
+			for (int i = 0; i < count * 3; i++)
+			{
+				positions.push_back(Vector3(position(generator), position(generator), position(generator) - 20.0));
+				indices.push_back(uint32_t(i));
+			}
+
+			return std::make_shared<TriangleMesh>(positions, indices, materialId);
+		}
+
+		TEST_METHOD(Load_TracesLikeTheBuiltMeshes)
+		{
+			HittableList built;
+			built.Add(MakeMesh(500, 0, 1));
+			built.Add(MakeMesh(300, 1, 2));
+
+			MaterialTable builtMaterials;
+			builtMaterials.Add(std::make_shared<Lambertian>(Vector3(0.1, 0.2, 0.3)));
+			builtMaterials.Add(std::make_shared<Lambertian>(Vector3(0.4, 0.5, 0.6)));
+
+			const TemporaryFile file(SceneCache::FileName(42));
+			Assert::IsTrue(SceneCache::Write(file.path, 42, built, builtMaterials));
+
+			HittableList loaded;
+			MaterialTable loadedMaterials;
+			Assert::IsTrue(SceneCache::Load(file.path, 42, loaded, loadedMaterials));
+
+			Assert::AreEqual(size_t(2), loaded.objects.size());
+			Assert::AreEqual(size_t(2), loadedMaterials.Size());
+			Assert::AreEqual(0.5, double(static_cast<const Lambertian*>(loadedMaterials.Get(1))->Albedo().y), 1e-6);
+
+			// The loaded meshes view the mapped file, not the arrays they were written from.
+			const auto& mesh = static_cast<const TriangleMesh&>(*loaded.objects[0]);
+			const auto& source = static_cast<const TriangleMesh&>(*built.objects[0]);
+			Assert::AreNotEqual(static_cast<const void*>(source.Arrays().nodes.data()), static_cast<const void*>(mesh.Arrays().nodes.data()));
+			Assert::AreEqual(source.TriangleCount(), mesh.TriangleCount());
+
+			std::mt19937 generator(3);
+			std::uniform_real_distribution<double> offset(-0.3, 0.3);
+
+			for (int i = 0; i < 1000; i++)
+			{
+				const Ray ray(Vector3(0.0, 0.0, 0.0), Vector3(offset(generator), offset(generator), -1.0));
+
+				HitRecord expected, actual;
+				const bool expectedHit = built.Hit(ray, Interval(0.001, 1e30), expected);
+
+				Assert::AreEqual(expectedHit, loaded.Hit(ray, Interval(0.001, 1e30), actual));
+				Assert::AreEqual(expectedHit, loaded.Occluded(ray, Interval(0.001, 1e30)));
+
+				if (expectedHit)
+				{
+					Assert::AreEqual(double(expected.t), double(actual.t));
+					Assert::AreEqual(expected.materialId, actual.materialId);
+				}
+			}
+		}
+
+		TEST_METHOD(Load_MissesStaleAndMalformedFiles)
+		{
+			HittableList objects;
+			objects.Add(MakeMesh(100, 0, 4));
+
+			MaterialTable materials;
+			materials.Add(std::make_shared<Lambertian>(Vector3(0.5, 0.5, 0.5)));
+
+			const TemporaryFile file(SceneCache::FileName(7));
+			HittableList loaded;
+			MaterialTable loadedMaterials;
+
+			Assert::IsFalse(SceneCache::Load(file.path, 7, loaded, loadedMaterials));
+
+			Assert::IsTrue(SceneCache::Write(file.path, 7, objects, materials));
+			Assert::IsFalse(SceneCache::Load(file.path, 8, loaded, loadedMaterials));
+
+			// A truncated file must be rejected without reading past its end.
+			std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 100);
+			Assert::IsFalse(SceneCache::Load(file.path, 7, loaded, loadedMaterials));
+
+			Assert::IsTrue(loaded.objects.empty());
+			Assert::AreEqual(size_t(0), loadedMaterials.Size());
+		}
+
+		TEST_METHOD(Write_RefusesOtherPrimitives)
+		{
+			HittableList objects;
+			objects.Add(MakeMesh(10, 0, 5));
+			objects.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -5.0), 1.0));
+
+			const TemporaryFile file(SceneCache::FileName(9));
+			Assert::IsFalse(SceneCache::Write(file.path, 9, objects, MaterialTable()));
+			Assert::IsFalse(std::filesystem::exists(file.path));
+		}
+
+		TEST_METHOD(Write_ConcurrentWritersOfOneFileAllSucceed)
+		{
+			HittableList objects;
+			objects.Add(MakeMesh(50000, 0, 6));
+
+			MaterialTable materials;
+			materials.Add(std::make_shared<Lambertian>(Vector3(0.5, 0.5, 0.5)));
+
+			const TemporaryFile directory("scene_cache_concurrent");
+			std::filesystem::create_directories(directory.path);
+			const std::filesystem::path path = directory.path / SceneCache::FileName(11);
+
+			// Like render jobs that all missed on the same asset in a shared cache directory.
+			std::vector<std::future<bool>> writers;
+			for (int i = 0; i < 4; i++)
+			{
+				writers.push_back(std::async(std::launch::async, [&]()
+					{
+						bool written = true;
+						for (int k = 0; k < 3; k++)
+						{
+							written = SceneCache::Write(path, 11, objects, materials) && written;
+						}
+
+						return written;
+					}));
+			}
+
+			for (auto& writer : writers)
+			{
+				Assert::IsTrue(writer.get());
+			}
+
+			HittableList loaded;
+			MaterialTable loadedMaterials;
+			Assert::IsTrue(SceneCache::Load(path, 11, loaded, loadedMaterials));
+
+			// Only the cache file is left; no writer's temporary file survives.
+			const auto entries = std::distance(std::filesystem::directory_iterator(directory.path), std::filesystem::directory_iterator());
+			Assert::AreEqual(ptrdiff_t(1), ptrdiff_t(entries));
+		}
+
+		TEST_METHOD(Write_RemovesItsTemporaryFileOnFailure)
+		{
+			HittableList objects;
+			objects.Add(MakeMesh(10, 0, 7));
+
+			MaterialTable materials;
+			materials.Add(std::make_shared<Lambertian>(Vector3(0.5, 0.5, 0.5)));
+
+			// A non-empty directory where the cache file should go makes the final rename fail.
+			const TemporaryFile directory("scene_cache_failure");
+			const std::filesystem::path path = directory.path / SceneCache::FileName(12);
+			std::filesystem::create_directories(path);
+			std::ofstream(path / "blocker") << "x";
+
+			Assert::ExpectException<std::filesystem::filesystem_error>([&]() { SceneCache::Write(path, 12, objects, materials); });
+
+			const auto entries = std::distance(std::filesystem::directory_iterator(directory.path), std::filesystem::directory_iterator());
+			Assert::AreEqual(ptrdiff_t(1), ptrdiff_t(entries));
+		}
+
+		TEST_METHOD(HashFile_DependsOnContents)
+		{
+			const TemporaryFile a("scene_cache_hash_a.bin");
+			const TemporaryFile b("scene_cache_hash_b.bin");
+
+			std::string contents(1000, 'x');
+			std::ofstream(a.path, std::ios::binary) << contents;
+			contents[517] = 'y';
+			std::ofstream(b.path, std::ios::binary) << contents;
+
+			Assert::AreEqual(SceneCache::HashFile(a.path), SceneCache::HashFile(a.path));
+			Assert::AreNotEqual(SceneCache::HashFile(a.path), SceneCache::HashFile(b.path));
+		}
+	};
+}
\ No newline at end of file
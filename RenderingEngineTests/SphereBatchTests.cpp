@@ -0,0 +1,74 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/BVH.h>
+#include <src/Sphere.h>
+#include <src/SphereBatch.h>
+
+#include "TestUtilities.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(SphereBatchTests)
+	{
+	public:
+
+		TEST_METHOD(Hit_MatchesNearestSphere)
+		{
+			SphereBatch batch;
+			HittableList list;
+
+			const Vector3 centers[] = { Vector3(0.0, 0.0, -5.0), Vector3(0.0, 0.0, -3.0), Vector3(2.0, 0.0, -3.0) };
+			for (const Vector3& center : centers)
+			{
+				batch.Add(center, 0.5);
+				list.Add(std::make_shared<Sphere>(center, 0.5));
+			}
+
+			Ray ray(Vector3(0.0, 0.0, 0.0), Vector3(0.0, 0.0, -1.0));
+
+			HitRecord expected, actual;
+			Assert::IsTrue(list.Hit(ray, Interval(0.001, 1e30), expected));
+			Assert::IsTrue(batch.Hit(ray, Interval(0.001, 1e30), actual));
+
+			Assert::AreEqual(2.5, double(actual.t), RealTolerance(2.5));
+			Assert::AreEqual(double(expected.t), double(actual.t), RealTolerance(expected.t));
+			Assert::IsTrue(actual.frontFace);
+		}
+
+		TEST_METHOD(Hit_RespectsInterval)
+		{
+			SphereBatch batch;
+			batch.Add(Vector3(0.0, 0.0, -3.0), 0.5);
+
+			Ray ray(Vector3(0.0, 0.0, 0.0), Vector3(0.0, 0.0, -1.0));
+			HitRecord record;
+
+			// The near root is excluded, so the far root is returned instead.
+			Assert::IsTrue(batch.Hit(ray, Interval(2.6, 1e30), record));
+			Assert::AreEqual(3.5, double(record.t), RealTolerance(3.5));
+			Assert::IsFalse(record.frontFace);
+
+			Assert::IsFalse(batch.Hit(ray, Interval(0.001, 2.0), record));
+		}
+
+		TEST_METHOD(Pack_BVH_MatchesLinearScan)
+		{
+			const HittableList list = MakeSpheres(1001, 7);
+
+			HittableList packed = SphereBatch::Pack(list);
+			Assert::IsTrue(packed.objects.size() <= list.objects.size() / 2);
+
+			BVH bvh(packed);
+
+			// The batch orders the quadratic's operations differently, and near-grazing hits
+			// amplify rounding through the cancellation in the discriminant.
+			CheckMatchesLinearScan(list, bvh, Vector3(), 16384.0);
+		}
+	};
+}
\ No newline at end of file
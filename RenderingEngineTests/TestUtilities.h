@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CppUnitTest.h"
+
+#include <src/HittableList.h>
+#include <src/Precision.h>
+#include <src/Sphere.h>
+
+#include <random>
+
+namespace RenderingEngineTests
+{
+	/**
+	 * @brief Tolerance for two Reals of magnitude about 'scale' computed along different paths.
+	 *
+	 * Measured in units of Real's epsilon, so a comparison is as strict in
+	 * a double build as its arithmetic allows and still holds in a float build.
+	 */
+	inline double RealTolerance(double scale, double ulps = 64.0)
+	{
+		return ulps * std::numeric_limits<Engine::Real>::epsilon() * std::max(std::abs(scale), 1.0);
+	}
+
+	/** @brief 'count' spheres of radii in [minRadius, maxRadius] spread through a 20 unit box centred 30 units down -z from 'offset'. */
+	inline Engine::HittableList MakeSpheres(int count, uint32_t seed, double minRadius = 0.05, double maxRadius = 0.5, const Engine::Vector3& offset = Engine::Vector3())
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<double> position(-10.0, 10.0);
+		std::uniform_real_distribution<double> radius(minRadius, maxRadius);
+
+		Engine::HittableList list;
+		for (int i = 0; i < count; i++)
+		{
+			list.Add(std::make_shared<Engine::Sphere>(offset + Engine::Vector3(position(generator), position(generator), position(generator) - 30.0), radius(generator)));
+		}
+
+		return list;
+	}
+
+	/**
+	 * @brief Traces rays from around 'origin' down -z through 'accelerated' and through 'list' itself, and returns how many hit.
+	 *
+	 * Hits, occlusion, distances to within 'ulps' and material ids must all agree. Every
+	 * fourth ray runs along the z axis, parallel to the x and y slabs and cell walls, and
+	 * every eighth starts 30 units in, inside the scenes MakeSpheres builds.
+	 */
+	inline int CheckMatchesLinearScan(const Engine::HittableList& list, const Engine::Hittable& accelerated, const Engine::Vector3& origin = Engine::Vector3(), double ulps = 64.0)
+	{
+		using namespace Engine;
+		using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+		std::mt19937 generator(17);
+		std::uniform_real_distribution<double> offset(-0.5, 0.5);
+		int hits = 0;
+
+		for (int i = 0; i < 2000; i++)
+		{
+			Vector3 direction(offset(generator), offset(generator), -1.0);
+			if (i % 4 == 0)
+			{
+				direction = Vector3(0.0, 0.0, -1.0);
+			}
+
+			const double depth = i % 8 == 1 ? -30.0 : 0.0;
+			const Ray ray(origin + Vector3(offset(generator) * 20, offset(generator) * 20, depth), direction);
+
+			HitRecord expected, actual;
+			const bool expectedHit = list.Hit(ray, Interval(0.001, 1e30), expected);
+
+			Assert::AreEqual(expectedHit, accelerated.Hit(ray, Interval(0.001, 1e30), actual));
+			Assert::AreEqual(expectedHit, accelerated.Occluded(ray, Interval(0.001, 1e30)));
+
+			if (expectedHit)
+			{
+				hits++;
+				Assert::AreEqual(double(expected.t), double(actual.t), RealTolerance(expected.t, ulps));
+				Assert::AreEqual(expected.materialId, actual.materialId);
+			}
+		}
+
+		return hits;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/BVH.h>
+#include <src/TriangleMesh.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(TriangleMeshTests)
+	{
+	public:
+
+		/** @brief Square in the z = -1 plane spanning [-1, 1]^2, split into n x n quads of two triangles. */
+		TriangleMesh MakeGrid(int n)
+		{
+			std::vector<Vector3> positions;
+			std::vector<uint32_t> indices;
+
+			for (int y = 0; y <= n; y++)
+			{
+				for (int x = 0; x <= n; x++)
+				{
+					positions.push_back(Vector3(-1.0 + 2.0 * x / n, -1.0 + 2.0 * y / n, -1.0));
+				}
+			}
+
+			for (int y = 0; y < n; y++)
+			{
+				for (int x = 0; x < n; x++)
+				{
+					const uint32_t i = uint32_t(y * (n + 1) + x);
+					indices.insert(indices.end(), { i, i + 1, i + n + 2 });
+					indices.insert(indices.end(), { i, i + n + 2, i + n + 1 });
+				}
+			}
+
+			return TriangleMesh(positions, indices, 7);
+		}
+
+		TEST_METHOD(Hit_ReportsDistanceNormalAndMaterial)
+		{
+			TriangleMesh mesh = MakeGrid(4);
+
+			HitRecord record;
+			Assert::IsTrue(mesh.Hit(Ray(Vector3(0.3, 0.2, 0.0), Vector3(0.0, 0.0, -1.0)), Interval(0.001, 1e30), record));
+
+			Assert::AreEqual(1.0, double(record.t), 1e-9);
+			Assert::AreEqual(1.0, double(record.N.z), 1e-9);
+			Assert::IsTrue(record.frontFace);
+			Assert::AreEqual(uint32_t(7), record.materialId);
+
+			Assert::IsFalse(mesh.Hit(Ray(Vector3(1.5, 0.0, 0.0), Vector3(0.0, 0.0, -1.0)), Interval(0.001, 1e30), record));
+			Assert::IsFalse(mesh.Hit(Ray(Vector3(0.0, 0.0, 0.0), Vector3(0.0, 0.0, -1.0)), Interval(0.001, 0.5), record));
+		}
+
+		TEST_METHOD(Hit_IsWatertightAlongSharedEdges)
+		{
+			TriangleMesh mesh = MakeGrid(8);
+
+			// Aim at every vertex, edge midpoint and diagonal of the grid from an
+			// oblique origin; no ray may slip between neighbouring triangles.
+			const Vector3 origin(0.123, -0.456, 2.0);
+			int misses = 0;
+
+			for (int y = 1; y < 16; y++)
+			{
+				for (int x = 1; x < 16; x++)
+				{
+					const Vector3 target(-1.0 + 2.0 * x / 16, -1.0 + 2.0 * y / 16, -1.0);
+
+					HitRecord record;
+					misses += !mesh.Hit(Ray(origin, target - origin), Interval(0.001, 1e30), record);
+				}
+			}
+
+			Assert::AreEqual(0, misses);
+		}
+
+		TEST_METHOD(Hit_MatchesBruteForce)
+		{
+			std::mt19937 generator(42);
+			std::uniform_real_distribution<double> position(-5.0, 5.0);
+			std::uniform_real_distribution<double> offset(-0.5, 0.5);
+
+			std::vector<Vector3> positions;
+			std::vector<uint32_t> indices;
+			for (uint32_t i = 0; i < 500; i++)
+			{
+				const Vector3 center(position(generator), position(generator), position(generator) - 15.0);
+				for (int k = 0; k < 3; k++)
+				{
+					positions.push_back(center + Vector3(offset(generator), offset(generator), offset(generator)));
+					indices.push_back(i * 3 + k);
+				}
+			}
+
+			TriangleMesh mesh(positions, indices);
+			Assert::AreEqual(size_t(500), mesh.TriangleCount());
+
+			for (int r = 0; r < 500; r++)
+			{
+				const Ray ray(Vector3(0.0, 0.0, 0.0), Vector3::Normalize(Vector3(offset(generator), offset(generator), -1.0)));
+
+				// Reference: every triangle as its own single-triangle mesh.
+				bool expectedHit = false;
+				Real expectedT = Real(1e30);
+				for (uint32_t i = 0; i < 500; i++)
+				{
+					TriangleMesh single({ positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2] }, { 0, 1, 2 });
+
+					HitRecord record;
+					if (single.Hit(ray, Interval(Real(0.001), expectedT), record))
+					{
+						expectedHit = true;
+						expectedT = record.t;
+					}
+				}
+
+				HitRecord record;
+				const bool actualHit = mesh.Hit(ray, Interval(Real(0.001), Real(1e30)), record);
+
+				Assert::AreEqual(expectedHit, actualHit);
+				if (expectedHit)
+				{
+					Assert::AreEqual(double(expectedT), double(record.t), 1e-9);
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "pch.h"
+
+#include "CppUnitTest.h"
+
+#include <src/BVH.h>
+#include <src/Sphere.h>
+#include <src/WideBVHTree.h>
+
+#include "TestUtilities.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderingEngineTests
+{
+	using namespace Engine;
+
+	TEST_CLASS(WideBVHTreeTests)
+	{
+	public:
+
+		/** @brief Checks the subtree of 'index' and returns the union of its primitive boxes. */
+		static AABB CheckNode(const WideBVHTree& wide, uint32_t index, const std::vector<AABB>& bounds, std::vector<int>& seen)
+		{
+			const WideBVHNode& node = wide.nodes[index];
+
+			AABB total;
+			uint32_t primitive = node.primitiveBase;
+
+			for (int i = 0; i < WideBVHTree::Width; i++)
+			{
+				if (!((node.childMask >> i) & 1))
+				{
+					continue;
+				}
+
+				AABB contents;
+				if (node.meta[i] & 0x80)
+				{
+					contents = CheckNode(wide, node.childBase + (node.meta[i] & 0x7f), bounds, seen);
+				}
+				else
+				{
+					for (uint32_t k = primitive; k < primitive + node.meta[i]; k++)
+					{
+						seen[wide.primitiveIndices[k]]++;
+						contents.Grow(bounds[wide.primitiveIndices[k]]);
+					}
+
+					primitive += node.meta[i];
+				}
+
+				// The decoded single-precision box must enclose everything below the child.
+				for (int axis = 0; axis < 3; axis++)
+				{
+					const float scale = std::ldexp(1.0f, node.exponent[axis]);
+					const float lower = node.origin[axis] + node.lower[axis][i] * scale;
+					const float upper = node.origin[axis] + node.upper[axis][i] * scale;
+
+					Assert::IsTrue(lower <= contents.Axis(axis).min && contents.Axis(axis).max <= upper);
+				}
+
+				total.Grow(contents);
+			}
+
+			return total;
+		}
+
+		TEST_METHOD(Build_EnclosesEveryPrimitiveInLessMemory)
+		{
+			std::vector<AABB> bounds;
+			for (const auto& object : MakeSpheres(5000, 4321).objects)
+			{
+				bounds.push_back(object->BoundingBox());
+			}
+
+			BVHTree tree;
+			tree.Build(bounds);
+
+			WideBVHTree wide;
+			wide.Build(tree);
+
+			std::vector<int> seen(bounds.size(), 0);
+			CheckNode(wide, 0, bounds, seen);
+
+			for (const int count : seen)
+			{
+				Assert::AreEqual(1, count);
+			}
+
+			// Binary nodes take 56 bytes in double and 32 in single precision, seven per wide node.
+			const size_t shrink = sizeof(Real) == sizeof(double) ? 4 : 2;
+			Assert::IsTrue(wide.NodeBytes() * shrink < tree.nodes.size() * sizeof(BVHNode));
+		}
+
+		TEST_METHOD(Hit_MatchesLinearScan)
+		{
+			BVHBuildOptions options;
+			options.layout = BVHLayout::Wide8;
+
+			const HittableList list = MakeSpheres(3000, 4321);
+			const BVH bvh(list, options);
+			Assert::IsFalse(bvh.WideTree().Empty());
+			CheckMatchesLinearScan(list, bvh);
+
+			// Far from the world origin, rounding the ray origin to float is an
+			// absolute error that small boxes must still be widened by.
+			const Vector3 farAway(1e6, 1e6, 1e6);
+			const HittableList farList = MakeSpheres(20000, 4321, 0.01, 0.05, farAway);
+			CheckMatchesLinearScan(farList, BVH(farList, options), farAway);
+		}
+
+		TEST_METHOD(Build_RejectsOversizedLeaves)
+		{
+			// Coinciding boxes cannot be split by the SAH, so leaves stay as large as allowed.
+			const std::vector<AABB> bounds(300, AABB(Vector3(0.0, 0.0, 0.0), Vector3(1.0, 1.0, 1.0)));
+
+			BVHBuildOptions options;
+			options.maxLeafSize = 200;
+
+			BVHTree tree;
+			tree.Build(bounds, options);
+
+			WideBVHTree wide;
+			Assert::ExpectException<std::invalid_argument>([&]() { wide.Build(tree); });
+
+			// A BVH limits its leaves to what the wide layout holds instead.
+			HittableList list;
+			for (int i = 0; i < 300; i++)
+			{
+				list.Add(std::make_shared<Sphere>(Vector3(0.0, 0.0, -5.0), 1.0));
+			}
+
+			options.layout = BVHLayout::Wide8;
+			const BVH bvh(list, options);
+
+			HitRecord record;
+			Assert::IsTrue(bvh.Hit(Ray(Vector3(0.0, 0.0, 0.0), Vector3(0.0, 0.0, -1.0)), Interval(0.001, 1e30), record));
+			Assert::AreEqual(4.0, double(record.t), 1e-9);
+		}
+	};
+}
\ No newline at end of file
@@ -2,6 +2,12 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <chrono>
 #include <cstdlib>
 #include <cmath>